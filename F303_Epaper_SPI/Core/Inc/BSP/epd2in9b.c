@@ -25,6 +25,7 @@
  */
 
 #include "epd2in9b.h"
+#include <string.h>
 
 int EPD_Init(epd_handle_t* epd_handle) {
 
@@ -94,12 +95,29 @@ void EPD_SendData(epd_handle_t* epd_handle, uint8_t data) {
 }
 
 /**
- *  @brief: Wait until the busy_pin goes HIGH
+ *  @brief: Wait until the busy_pin goes HIGH.
+ *          Polls every 100 ms in EPD_WAIT_POLL mode, otherwise sleeps
+ *          until the EXTI of the busy_pin, see EpdWaitIdleCallback()
  */
 void EPD_WaitUntilIdle(epd_handle_t* epd_handle) {
-	while(EPD_DigitalRead(epd_handle->epd_pin_busy) == 0) {      //0: busy, 1: idle
-	EPD_DelayMs(100);
+	uint32_t tickstart = HAL_GetTick();
+
+	if (epd_handle->wait_mode == EPD_WAIT_POLL) {
+		while(EPD_DigitalRead(epd_handle->epd_pin_busy) == 0) {      //0: busy, 1: idle
+		EPD_DelayMs(100);
+		}
+	} else {
+		epd_handle->busy = 1;
+		EpdWaitIdleCallback(epd_handle);
 	}
+	epd_handle->wait_ms = HAL_GetTick() - tickstart;
+}
+
+/**
+ *  @brief: 1 until the refresh started by EPD_RefreshAsync() ends
+ */
+uint8_t EPD_IsBusy(epd_handle_t* epd_handle) {
+	return epd_handle->busy;
 }
 
 /**
@@ -108,15 +126,65 @@ void EPD_WaitUntilIdle(epd_handle_t* epd_handle) {
  *          see EPD::Sleep();
  */
 void EPD_Reset(epd_handle_t* epd_handle) {
+	epd_handle->ram_valid = 0;                                     //the display RAM is lost
 	EPD_DigitalWrite(epd_handle->epd_pin_rst, LOW);                //module reset
 	EPD_DelayMs(200);
 	EPD_DigitalWrite(epd_handle->epd_pin_rst, HIGH);
 	EPD_DelayMs(200);
 }
 
-void EPD_DisplayFrame(epd_handle_t* epd_handle, const uint8_t* frame_buffer_black, const uint8_t* frame_buffer_red)
+/**
+ *  @brief: sends a block of data with CS and DC held for the whole block,
+ *          through DMA when the SPI handle has a DMA channel linked.
+ *          Returns once the transfer has started, see EpdSpiWaitCallback()
+ */
+int EPD_SendDataBlock(epd_handle_t* epd_handle, const uint8_t* data, uint16_t size) {
+	EPD_DigitalWrite(epd_handle->epd_pin_dc, HIGH);
+	return EpdSpiTransferBlockCallback(epd_handle, data, size);
+}
+
+/**
+ *  @brief: uploads the planes to the display RAM, one block transfer each.
+ *          A NULL plane is not sent
+ */
+int EPD_UploadFrame(epd_handle_t* epd_handle, const uint8_t* frame_buffer_black, const uint8_t* frame_buffer_red)
+{
+	uint16_t size = epd_handle->width * epd_handle->height / 8;
+	uint32_t tickstart = HAL_GetTick();
+	int ret = 0;
+
+	if (frame_buffer_black != NULL) {
+		epd_handle->ram_valid &= ~(1 << EPD_BLACK);
+		EPD_SendCommand(epd_handle, DATA_START_TRANSMISSION_1);
+		EPD_DelayMs(2);
+		if (EPD_SendDataBlock(epd_handle, frame_buffer_black, size) != 0 || EpdSpiWaitCallback(epd_handle) != 0) {
+			ret = -1;
+		}
+		EPD_DelayMs(2);
+	}
+	if (frame_buffer_red != NULL) {
+		EPD_SendCommand(epd_handle, DATA_START_TRANSMISSION_2);
+		EPD_DelayMs(2);
+		epd_handle->ram_valid &= ~(1 << EPD_RED);
+		if (EPD_SendDataBlock(epd_handle, frame_buffer_red, size) != 0 || EpdSpiWaitCallback(epd_handle) != 0) {
+			ret = -1;
+		}
+		EPD_DelayMs(2);
+	}
+	epd_handle->upload_ms = HAL_GetTick() - tickstart;
+	return ret;
+}
+
+/**
+ *  @brief: uploads the planes one byte per transfer, CS and DC toggled
+ *          for each byte. Kept to compare with EPD_UploadFrame()
+ */
+void EPD_UploadFrameBytes(epd_handle_t* epd_handle, const uint8_t* frame_buffer_black, const uint8_t* frame_buffer_red)
 {
+	uint32_t tickstart = HAL_GetTick();
+
 	if (frame_buffer_black != NULL) {
+		epd_handle->ram_valid &= ~(1 << EPD_BLACK);
 		EPD_SendCommand(epd_handle, DATA_START_TRANSMISSION_1);
 		EPD_DelayMs(2);
 		for (int i = 0; i < epd_handle->width * epd_handle->height / 8; i++) {
@@ -125,6 +193,7 @@ void EPD_DisplayFrame(epd_handle_t* epd_handle, const uint8_t* frame_buffer_blac
 		EPD_DelayMs(2);
 	}
 	if (frame_buffer_red != NULL) {
+		epd_handle->ram_valid &= ~(1 << EPD_RED);
 		EPD_SendCommand(epd_handle, DATA_START_TRANSMISSION_2);
 		EPD_DelayMs(2);
 		for (int i = 0; i < epd_handle->width * epd_handle->height / 8; i++) {
@@ -132,8 +201,325 @@ void EPD_DisplayFrame(epd_handle_t* epd_handle, const uint8_t* frame_buffer_blac
 		}
 		EPD_DelayMs(2);
 	}
+	epd_handle->upload_ms = HAL_GetTick() - tickstart;
+}
+
+/**
+ *  @brief: rows of the display in each band of the change masks
+ */
+static int EPD_BandRows(epd_handle_t* epd_handle)
+{
+	return (epd_handle->height + EPD_BANDS - 1) / EPD_BANDS;
+}
+
+/**
+ *  @brief: hashes the row bands of a plane, then the plane from the band
+ *          hashes. Returns the bands that differ from the display, none
+ *          if the whole plane matches
+ */
+static uint32_t EPD_HashPlane(epd_handle_t* epd_handle, int color, const uint8_t* plane, uint32_t* band_hash, uint32_t* frame_hash)
+{
+	int stride = epd_handle->width / 8;
+	int band_rows = EPD_BandRows(epd_handle);
+	uint32_t changed = 0;
+	int band = 0;
+
+	for (int y = 0; y < epd_handle->height; y += band_rows, band++) {
+		int rows = (epd_handle->height - y < band_rows) ? epd_handle->height - y : band_rows;
+		band_hash[band] = EpdHashCallback(&plane[y * stride], rows * stride);
+		if (band_hash[band] != epd_handle->band_hash[color][band]) {
+			changed |= 1UL << band;
+		}
+	}
+	for (; band < EPD_BANDS; band++) {
+		band_hash[band] = 0;
+	}
+	*frame_hash = EpdHashCallback((const uint8_t*)band_hash, sizeof(uint32_t) * EPD_BANDS);
+
+	// the band hashes are unknown after EPD_RestoreHashes(), a matching plane gives them back
+	if (*frame_hash == epd_handle->frame_hash[color]) {
+		memcpy(epd_handle->band_hash[color], band_hash, sizeof(epd_handle->band_hash[color]));
+		changed = 0;
+	}
+	return changed;
+}
+
+/**
+ *  @brief: records the hashes of a plane now shown by the display
+ */
+static void EPD_StoreHashes(epd_handle_t* epd_handle, int color, const uint32_t* band_hash, uint32_t frame_hash)
+{
+	memcpy(epd_handle->band_hash[color], band_hash, sizeof(epd_handle->band_hash[color]));
+	epd_handle->frame_hash[color] = frame_hash;
+	if (epd_handle->bkp_register >= 0) {
+		EpdBackupWriteCallback(epd_handle->bkp_register + color, frame_hash);
+	}
+}
+
+/**
+ *  @brief: drops the hashes of the bands crossed by rows y to y + h - 1
+ */
+static void EPD_ForgetBands(epd_handle_t* epd_handle, int color, int y, int h)
+{
+	int band_rows = EPD_BandRows(epd_handle);
+
+	for (int band = y / band_rows; band <= (y + h - 1) / band_rows; band++) {
+		epd_handle->band_hash[color][band] = 0;
+	}
+	epd_handle->frame_hash[color] = 0;
+	epd_handle->ram_valid &= ~(1 << color);
+	if (epd_handle->bkp_register >= 0) {
+		EpdBackupWriteCallback(epd_handle->bkp_register + color, 0);
+	}
+}
+
+/**
+ *  @brief: loads the hashes of the planes shown by the display from the
+ *          backup registers, so an identical frame isn't refreshed again
+ *          after standby. Registers bkp_register and bkp_register + 1 are
+ *          kept up to date from now on, -1 disables them
+ */
+void EPD_RestoreHashes(epd_handle_t* epd_handle, int bkp_register)
+{
+	epd_handle->bkp_register = bkp_register;
+	if (bkp_register < 0) {
+		return;
+	}
+	epd_handle->frame_hash[EPD_BLACK] = EpdBackupReadCallback(bkp_register + EPD_BLACK);
+	epd_handle->frame_hash[EPD_RED] = EpdBackupReadCallback(bkp_register + EPD_RED);
+}
+
+/**
+ *  @brief: uploads and refreshes the frame, unless both planes are the
+ *          ones shown by the display. An unchanged plane is not sent
+ *          when the display RAM still holds it. A NULL plane is not sent
+ */
+void EPD_DisplayFrame(epd_handle_t* epd_handle, const uint8_t* frame_buffer_black, const uint8_t* frame_buffer_red)
+{
+	const uint8_t* planes[2] = {frame_buffer_black, frame_buffer_red};
+	const uint8_t* sent[2] = {frame_buffer_black, frame_buffer_red};
+	uint32_t band_hash[2][EPD_BANDS];
+	uint32_t frame_hash[2];
+	uint32_t tickstart = HAL_GetTick();
+	int color;
+
+	for (color = 0; color < 2; color++) {
+		epd_handle->changed[color] = 0;
+		if (planes[color] != NULL) {
+			epd_handle->changed[color] = EPD_HashPlane(epd_handle, color, planes[color], band_hash[color], &frame_hash[color]);
+		}
+	}
+	if (epd_handle->changed[EPD_BLACK] == 0 && epd_handle->changed[EPD_RED] == 0) {
+		epd_handle->skipped_refreshes++;
+		epd_handle->upload_ms = 0;
+		epd_handle->update_ms = HAL_GetTick() - tickstart;
+		return;
+	}
+	for (color = 0; color < 2; color++) {
+		if (sent[color] != NULL && epd_handle->changed[color] == 0 && (epd_handle->ram_valid & (1 << color))) {
+			sent[color] = NULL;
+			epd_handle->skipped_uploads++;
+		}
+	}
+
+	if (EPD_UploadFrame(epd_handle, sent[EPD_BLACK], sent[EPD_RED]) == 0) {
+		EPD_SendCommand(epd_handle, DISPLAY_REFRESH);
+		EPD_WaitUntilIdle(epd_handle);
+		for (color = 0; color < 2; color++) {
+			if (planes[color] != NULL) {
+				EPD_StoreHashes(epd_handle, color, band_hash[color], frame_hash[color]);
+			}
+			if (sent[color] != NULL) {
+				epd_handle->ram_valid |= 1 << color;
+			}
+		}
+	}
+	epd_handle->update_ms = HAL_GetTick() - tickstart;
+}
+
+/**
+ *  @brief: sets the window of the next data transmissions and refresh,
+ *          in absolute coordinates. x should be a multiple of 8 and w too,
+ *          the last 3 bits of the columns are ignored by the controller.
+ *          Takes effect between PARTIAL_IN and PARTIAL_OUT
+ */
+void EPD_SetPartialWindow(epd_handle_t* epd_handle, int x, int y, int w, int h)
+{
+	EPD_SendCommand(epd_handle, PARTIAL_WINDOW);
+	EPD_SendData(epd_handle, x & 0xF8);
+	EPD_SendData(epd_handle, ((x & 0xF8) + w - 1) | 0x07);
+	EPD_SendData(epd_handle, (y >> 8) & 0x01);
+	EPD_SendData(epd_handle, y & 0xFF);
+	EPD_SendData(epd_handle, ((y + h - 1) >> 8) & 0x01);
+	EPD_SendData(epd_handle, (y + h - 1) & 0xFF);
+	EPD_SendData(epd_handle, 0x01);      // gates scan both inside and outside of the window
+}
+
+/**
+ *  @brief: sends the rows of a byte aligned window of a frame buffer
+ */
+static int EPD_SendWindowPlane(epd_handle_t* epd_handle, paint_t* paint, int x, int y, int w, int h)
+{
+	int stride = paint->width / 8;
+	const uint8_t* row = &paint->frame_buffer[y * stride + x / 8];
+
+	if (w / 8 == stride) {
+		// whole rows, the window is contiguous in the frame buffer
+		if (EPD_SendDataBlock(epd_handle, row, stride * h) != 0 || EpdSpiWaitCallback(epd_handle) != 0) {
+			return -1;
+		}
+		return 0;
+	}
+	for (int i = 0; i < h; i++, row += stride) {
+		if (EPD_SendDataBlock(epd_handle, row, w / 8) != 0 || EpdSpiWaitCallback(epd_handle) != 0) {
+			return -1;
+		}
+	}
+	return 0;
+}
+
+/**
+ *  @brief: uploads and refreshes a window given in absolute coordinates,
+ *          see EPD_DisplayWindow()
+ */
+static int EPD_UpdateWindow(epd_handle_t* epd_handle, paint_t* paint_black, paint_t* paint_red, int x, int y, int w, int h)
+{
+	uint32_t tickstart = HAL_GetTick();
+	int x_end = x + w;
+	int y_end = y + h;
+	int ret = 0;
+
+	if (x < 0) {
+		x = 0;
+	}
+	if (y < 0) {
+		y = 0;
+	}
+	if (x_end > epd_handle->width) {
+		x_end = epd_handle->width;
+	}
+	if (y_end > epd_handle->height) {
+		y_end = epd_handle->height;
+	}
+	x &= ~0x07;
+	x_end = (x_end + 7) & ~0x07;
+	if (x >= x_end || y >= y_end) {
+		return -1;
+	}
+	w = x_end - x;
+	h = y_end - y;
+
+	EPD_SendCommand(epd_handle, PARTIAL_IN);
+	EPD_SetPartialWindow(epd_handle, x, y, w, h);
+	if (paint_black != NULL) {
+		EPD_ForgetBands(epd_handle, EPD_BLACK, y, h);
+		EPD_SendCommand(epd_handle, DATA_START_TRANSMISSION_1);
+		EPD_DelayMs(2);
+		ret |= EPD_SendWindowPlane(epd_handle, paint_black, x, y, w, h);
+		EPD_DelayMs(2);
+	}
+	if (paint_red != NULL) {
+		EPD_ForgetBands(epd_handle, EPD_RED, y, h);
+		EPD_SendCommand(epd_handle, DATA_START_TRANSMISSION_2);
+		EPD_DelayMs(2);
+		ret |= EPD_SendWindowPlane(epd_handle, paint_red, x, y, w, h);
+		EPD_DelayMs(2);
+	}
+	epd_handle->upload_ms = HAL_GetTick() - tickstart;
+
 	EPD_SendCommand(epd_handle, DISPLAY_REFRESH);
 	EPD_WaitUntilIdle(epd_handle);
+	EPD_SendCommand(epd_handle, PARTIAL_OUT);
+	epd_handle->update_ms = HAL_GetTick() - tickstart;
+	return ret;
+}
+
+/**
+ *  @brief: uploads and refreshes a window of the frame buffers only.
+ *          The window is given in the coordinates of the paint rotation,
+ *          clipped to the display and widened to whole bytes (8 pixel
+ *          columns). The frame buffers must cover the whole display.
+ *          A NULL plane keeps the display RAM of that color.
+ *          The tri-color panel has no fast waveform, the window is
+ *          refreshed with the LUT from the OTP like a full frame
+ */
+int EPD_DisplayWindow(epd_handle_t* epd_handle, paint_t* paint_black, paint_t* paint_red, int x, int y, int w, int h)
+{
+	paint_t* paint = (paint_black != NULL) ? paint_black : paint_red;
+
+	if (paint == NULL) {
+		return -1;
+	}
+	Paint_GetAbsoluteWindow(paint, &x, &y, &w, &h);
+	return EPD_UpdateWindow(epd_handle, paint_black, paint_red, x, y, w, h);
+}
+
+/**
+ *  @brief: refreshes the rows of the changed bands of the frame buffers
+ *          as one full width window, nothing if no band changed.
+ *          Returns 1 if the display was refreshed, 0 if not, -1 on error
+ */
+int EPD_DisplayChanges(epd_handle_t* epd_handle, paint_t* paint_black, paint_t* paint_red)
+{
+	paint_t* paints[2] = {paint_black, paint_red};
+	paint_t* sent[2] = {paint_black, paint_red};
+	uint32_t band_hash[2][EPD_BANDS];
+	uint32_t frame_hash[2];
+	uint32_t tickstart = HAL_GetTick();
+	int band_rows = EPD_BandRows(epd_handle);
+	uint8_t ram_valid = epd_handle->ram_valid;
+	uint32_t changed;
+	int first, last;
+	int color;
+
+	for (color = 0; color < 2; color++) {
+		epd_handle->changed[color] = 0;
+		if (paints[color] != NULL) {
+			epd_handle->changed[color] = EPD_HashPlane(epd_handle, color, paints[color]->frame_buffer, band_hash[color], &frame_hash[color]);
+		}
+	}
+	changed = epd_handle->changed[EPD_BLACK] | epd_handle->changed[EPD_RED];
+	if (changed == 0) {
+		epd_handle->skipped_refreshes++;
+		epd_handle->upload_ms = 0;
+		epd_handle->update_ms = HAL_GetTick() - tickstart;
+		return 0;
+	}
+	for (first = 0; !(changed & (1UL << first)); first++);
+	for (last = EPD_BANDS - 1; !(changed & (1UL << last)); last--);
+
+	// an unchanged plane is only needed if its display RAM is unknown
+	for (color = 0; color < 2; color++) {
+		if (sent[color] != NULL && epd_handle->changed[color] == 0 && (ram_valid & (1 << color))) {
+			sent[color] = NULL;
+			epd_handle->skipped_uploads++;
+		}
+	}
+
+	if (EPD_UpdateWindow(epd_handle, sent[EPD_BLACK], sent[EPD_RED], 0, first * band_rows,
+			epd_handle->width, (last + 1 - first) * band_rows) != 0) {
+		return -1;
+	}
+	// the window holds every changed band, the planes match the frame buffers again
+	for (color = 0; color < 2; color++) {
+		if (paints[color] != NULL) {
+			EPD_StoreHashes(epd_handle, color, band_hash[color], frame_hash[color]);
+		}
+		epd_handle->ram_valid |= ram_valid & (1 << color);
+	}
+	epd_handle->update_ms = HAL_GetTick() - tickstart;
+	return 1;
+}
+
+/**
+ *  @brief: starts the refresh of the uploaded frame and returns,
+ *          BusyCpltCallback is called from the EXTI of the busy_pin when it ends
+ */
+void EPD_RefreshAsync(epd_handle_t* epd_handle)
+{
+	// armed before the command, BUSY can't rise before it
+	epd_handle->busy = 1;
+	EPD_SendCommand(epd_handle, DISPLAY_REFRESH);
 }
 
 /* After this command is transmitted, the chip would enter the deep-sleep mode to save power. 
@@ -28,6 +28,7 @@
 #define EPD2IN9B_H
 
 #include "BSP/epdif.h"
+#include "BSP/epdpaint.h"
 #include <stdlib.h>
 
 
@@ -70,14 +71,23 @@
 /* Hardware operating functions */
 int  EPD_Init(epd_handle_t* epd_handle);
 void EPD_WaitUntilIdle(epd_handle_t* epd_handle);
+uint8_t EPD_IsBusy(epd_handle_t* epd_handle);
 void EPD_DelayMs(uint16_t delaytime);
 void EPD_Reset(epd_handle_t* epd_handle);
 void EPD_DisplayFrame(epd_handle_t* epd_handle, const uint8_t* frame_buffer_black, const uint8_t* frame_buffer_red);
+void EPD_RefreshAsync(epd_handle_t* epd_handle);
+void EPD_SetPartialWindow(epd_handle_t* epd_handle, int x, int y, int w, int h);
+int  EPD_DisplayWindow(epd_handle_t* epd_handle, paint_t* paint_black, paint_t* paint_red, int x, int y, int w, int h);
+int  EPD_DisplayChanges(epd_handle_t* epd_handle, paint_t* paint_black, paint_t* paint_red);
+void EPD_RestoreHashes(epd_handle_t* epd_handle, int bkp_register);
+int  EPD_UploadFrame(epd_handle_t* epd_handle, const uint8_t* frame_buffer_black, const uint8_t* frame_buffer_red);
+void EPD_UploadFrameBytes(epd_handle_t* epd_handle, const uint8_t* frame_buffer_black, const uint8_t* frame_buffer_red);
 void EPD_Sleep(epd_handle_t* epd_handle);
 void EPD_DigitalWrite(epd_pin_t* epd_pin, uint8_t value);
 int EPD_DigitalRead(epd_pin_t* epd_pin);
 void EPD_SendCommand(epd_handle_t* epd_handle, uint8_t command);
 void EPD_SendData(epd_handle_t* epd_handle, uint8_t data);
+int  EPD_SendDataBlock(epd_handle_t* epd_handle, const uint8_t* data, uint16_t size);
 
 #endif /* EPD2IN9B_H */
 
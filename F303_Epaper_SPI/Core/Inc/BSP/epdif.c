@@ -27,6 +27,7 @@
 
 #include "epdif.h"
 #include <stdlib.h>
+#include <string.h>
 
 /* User: include hardware files */
 #include "main.h"
@@ -64,6 +65,22 @@ int epd_handle_init(epd_handle_t* epd, SPI_HandleTypeDef* hspi, epd_pin_t* epd_p
 	epd->epd_pin_busy = epd_pin_busy;
 	epd->width = width;
 	epd->height = height;
+	epd->tx_busy = 0;
+	epd->tx_error = 0;
+	epd->TxCpltCallback = NULL;
+	epd->upload_ms = 0;
+	epd->wait_mode = EPD_WAIT_SLEEP;
+	epd->busy = 0;
+	epd->BusyCpltCallback = NULL;
+	epd->wait_ms = 0;
+	epd->update_ms = 0;
+	memset(epd->band_hash, 0, sizeof(epd->band_hash));
+	memset(epd->frame_hash, 0, sizeof(epd->frame_hash));
+	memset(epd->changed, 0, sizeof(epd->changed));
+	epd->ram_valid = 0;
+	epd->bkp_register = -1;
+	epd->skipped_uploads = 0;
+	epd->skipped_refreshes = 0;
 	return 0;
 }
 
@@ -100,5 +117,155 @@ void EpdSpiTransferCallback(epd_handle_t* epd_handle, uint8_t data)
 	HAL_GPIO_WritePin(epd_handle->epd_pin_cs->port, epd_handle->epd_pin_cs->pin, GPIO_PIN_SET);
 }
 
+/* User: modify block SPI transfer, CS stays low for the whole block */
+int EpdSpiTransferBlockCallback(epd_handle_t* epd_handle, const uint8_t* data, uint16_t size)
+{
+	if (epd_handle->tx_busy) {
+		return -1;
+	}
+	epd_handle->tx_error = 0;
+	HAL_GPIO_WritePin(epd_handle->epd_pin_cs->port, epd_handle->epd_pin_cs->pin, GPIO_PIN_RESET);
+
+	if (epd_handle->hspi->hdmatx == NULL) {
+		// no DMA linked to the SPI handle, one blocking transfer for the block
+		if (HAL_SPI_Transmit(epd_handle->hspi, (uint8_t*)data, size, EPD_SPI_TIMEOUT) != HAL_OK) {
+			epd_handle->tx_error = 1;
+		}
+		HAL_GPIO_WritePin(epd_handle->epd_pin_cs->port, epd_handle->epd_pin_cs->pin, GPIO_PIN_SET);
+		if (epd_handle->TxCpltCallback != NULL) {
+			epd_handle->TxCpltCallback(epd_handle);
+		}
+		return epd_handle->tx_error ? -1 : 0;
+	}
+
+	epd_handle->tx_busy = 1;
+	if (HAL_SPI_Transmit_DMA(epd_handle->hspi, (uint8_t*)data, size) != HAL_OK) {
+		epd_handle->tx_busy = 0;
+		epd_handle->tx_error = 1;
+		HAL_GPIO_WritePin(epd_handle->epd_pin_cs->port, epd_handle->epd_pin_cs->pin, GPIO_PIN_SET);
+		return -1;
+	}
+	return 0;
+}
+
+/* User: modify wait for the end of a block transfer */
+int EpdSpiWaitCallback(epd_handle_t* epd_handle)
+{
+	uint32_t tickstart = HAL_GetTick();
+
+	while (epd_handle->tx_busy) {
+		if (HAL_GetTick() - tickstart > EPD_SPI_TIMEOUT) {
+			HAL_SPI_Abort(epd_handle->hspi);
+			epd_handle->tx_busy = 0;
+			epd_handle->tx_error = 1;
+			HAL_GPIO_WritePin(epd_handle->epd_pin_cs->port, epd_handle->epd_pin_cs->pin, GPIO_PIN_SET);
+			return -1;
+		}
+		// woken up by the DMA interrupt, or by the SysTick at the latest
+		__WFI();
+	}
+	return epd_handle->tx_error ? -1 : 0;
+}
+
+/* Call it from HAL_SPI_TxCpltCallback(), the HAL has already waited for the last byte to leave */
+void EpdSpiTxCpltCallback(epd_handle_t* epd_handle, SPI_HandleTypeDef* hspi)
+{
+	if (hspi != epd_handle->hspi || !epd_handle->tx_busy) {
+		return;
+	}
+	HAL_GPIO_WritePin(epd_handle->epd_pin_cs->port, epd_handle->epd_pin_cs->pin, GPIO_PIN_SET);
+	epd_handle->tx_busy = 0;
+	if (epd_handle->TxCpltCallback != NULL) {
+		epd_handle->TxCpltCallback(epd_handle);
+	}
+}
+
+/* Call it from HAL_SPI_ErrorCallback() */
+void EpdSpiErrorCallback(epd_handle_t* epd_handle, SPI_HandleTypeDef* hspi)
+{
+	if (hspi != epd_handle->hspi || !epd_handle->tx_busy) {
+		return;
+	}
+	HAL_GPIO_WritePin(epd_handle->epd_pin_cs->port, epd_handle->epd_pin_cs->pin, GPIO_PIN_SET);
+	epd_handle->tx_error = 1;
+	epd_handle->tx_busy = 0;
+	if (epd_handle->TxCpltCallback != NULL) {
+		epd_handle->TxCpltCallback(epd_handle);
+	}
+}
+
+/* User: modify low power wait, returns once BUSY is high. BUSY must be an EXTI source */
+void EpdWaitIdleCallback(epd_handle_t* epd_handle)
+{
+	while (1) {
+		__disable_irq();
+		if (!epd_handle->busy || EpdDigitalReadCallback(epd_handle->epd_pin_busy) == HIGH) {
+			break;
+		}
+		// a pending interrupt still ends the WFI while masked, the edge can't be missed
+		if (epd_handle->wait_mode == EPD_WAIT_STOP) {
+			HAL_PWR_EnterSTOPMode(PWR_LOWPOWERREGULATOR_ON, PWR_STOPENTRY_WFI);
+			__enable_irq();
+			// back on the HSI, restore the PLL
+			SystemClock_Config();
+		} else {
+			HAL_PWR_EnterSLEEPMode(PWR_MAINREGULATOR_ON, PWR_SLEEPENTRY_WFI);
+			__enable_irq();
+		}
+	}
+	epd_handle->busy = 0;
+	__enable_irq();
+}
+
+/* Call it from HAL_GPIO_EXTI_Callback(), BUSY goes high when the display is idle */
+void EpdBusyIrqCallback(epd_handle_t* epd_handle, uint16_t GPIO_Pin)
+{
+	if (GPIO_Pin != epd_handle->epd_pin_busy->pin || !epd_handle->busy) {
+		return;
+	}
+	epd_handle->busy = 0;
+	if (epd_handle->BusyCpltCallback != NULL) {
+		epd_handle->BusyCpltCallback(epd_handle);
+	}
+}
+
+/* User: modify hash function, the CRC unit is reset for each call */
+uint32_t EpdHashCallback(const uint8_t* data, uint32_t size)
+{
+#ifdef CRC
+	uint32_t word;
+	uint32_t i = 0;
+
+	CRC->CR = CRC_CR_RESET;
+	for (; i + 4 <= size; i += 4) {
+		memcpy(&word, &data[i], 4);
+		CRC->DR = word;
+	}
+	for (; i < size; i++) {
+		*(__IO uint8_t*)&CRC->DR = data[i];
+	}
+	return CRC->DR;
+#else
+	// FNV-1a
+	uint32_t hash = 2166136261U;
+
+	for (uint32_t i = 0; i < size; i++) {
+		hash = (hash ^ data[i]) * 16777619U;
+	}
+	return hash;
+#endif
+}
+
+/* User: modify backup register read, the registers must survive standby */
+uint32_t EpdBackupReadCallback(int index)
+{
+	return (&RTC->BKP0R)[index];
+}
 
+/* User: modify backup register write */
+void EpdBackupWriteCallback(int index, uint32_t value)
+{
+	HAL_PWR_EnableBkUpAccess();
+	(&RTC->BKP0R)[index] = value;
+}
 
@@ -35,6 +35,19 @@
 #define LOW             0
 #define HIGH            1
 
+// Block transfers
+#define EPD_SPI_TIMEOUT 1000    // ms, per byte transfer and per block
+
+// BUSY wait modes
+#define EPD_WAIT_POLL   0       // Read the pin every 100 ms
+#define EPD_WAIT_SLEEP  1       // Sleep mode until the BUSY edge, the SysTick keeps counting
+#define EPD_WAIT_STOP   2       // Stop mode until the BUSY edge, the tick stands still meanwhile
+
+// Change detection
+#define EPD_BLACK       0       // Plane indexes
+#define EPD_RED         1
+#define EPD_BANDS       32      // Row bands hashed per plane, one bit each in the change masks
+
 
 /* User: modify pin structure */
 typedef struct {
@@ -51,6 +64,22 @@ typedef struct epd_handle_t {
 	epd_pin_t* epd_pin_busy;
 	int width;
 	int height;
+	volatile uint8_t tx_busy;       // Block transfer running, CS held low
+	volatile uint8_t tx_error;      // Last block transfer aborted by the SPI or DMA
+	void (*TxCpltCallback)(struct epd_handle_t* epd_handle);   // Called (from interrupt context) when a block transfer ends
+	uint32_t upload_ms;             // Duration of the last frame upload, both planes
+	uint8_t wait_mode;              // How EPD_WaitUntilIdle() waits, EPD_WAIT_xxx
+	volatile uint8_t busy;          // Waiting for the rising edge of BUSY
+	void (*BusyCpltCallback)(struct epd_handle_t* epd_handle); // Called (from interrupt context) when BUSY goes high
+	uint32_t wait_ms;               // Duration of the last EPD_WaitUntilIdle()
+	uint32_t update_ms;             // Duration of the last frame or window update, upload and refresh
+	uint32_t band_hash[2][EPD_BANDS];   // Hashes of the row bands shown by the display, 0 unknown
+	uint32_t frame_hash[2];         // Hashes of the planes shown by the display, 0 unknown
+	uint32_t changed[2];            // Bands of each plane that differ in the last compared frame
+	uint8_t ram_valid;              // Planes whose whole display RAM matches frame_hash, one bit each
+	int bkp_register;               // First of the 2 backup registers keeping frame_hash, -1 none
+	uint32_t skipped_uploads;       // Planes not sent because they are unchanged
+	uint32_t skipped_refreshes;     // Updates dropped because no plane changed
 //	uint8_t* frame_buffer_black;
 //	uint8_t* frame_buffer_red;
 } epd_handle_t;
@@ -63,5 +92,14 @@ void EpdDigitalWriteCallback(epd_pin_t* epd_pin, uint8_t value);
 int EpdDigitalReadCallback(epd_pin_t* epd_pin);
 void EpdDelayMsCallback(uint16_t delaytime);
 void EpdSpiTransferCallback(epd_handle_t* epd_handle, uint8_t data);
+int EpdSpiTransferBlockCallback(epd_handle_t* epd_handle, const uint8_t* data, uint16_t size);
+int EpdSpiWaitCallback(epd_handle_t* epd_handle);
+void EpdSpiTxCpltCallback(epd_handle_t* epd_handle, SPI_HandleTypeDef* hspi);
+void EpdSpiErrorCallback(epd_handle_t* epd_handle, SPI_HandleTypeDef* hspi);
+void EpdWaitIdleCallback(epd_handle_t* epd_handle);
+void EpdBusyIrqCallback(epd_handle_t* epd_handle, uint16_t GPIO_Pin);
+uint32_t EpdHashCallback(const uint8_t* data, uint32_t size);
+uint32_t EpdBackupReadCallback(int index);
+void EpdBackupWriteCallback(int index, uint32_t value);
 
 #endif /* EPDIF_H */
@@ -42,16 +42,125 @@ void paint_init(paint_t* paint, int width, int height) {
 }
 
 /**
- *  @brief: clear the image
+ *  @brief: byte value of 8 pixels of a color
  */
-void Paint_Clear(paint_t* paint, int colored) {
-    for (int x = 0; x < paint->width; x++) {
-        for (int y = 0; y < paint->height; y++) {
-            Paint_DrawAbsolutePixel(paint, x, y, colored);
+static uint8_t Paint_ColorByte(int colored) {
+    if (IF_INVERT_COLOR) {
+        return colored ? 0xFF : 0x00;
+    }
+    return colored ? 0x00 : 0xFF;
+}
+
+/**
+ *  @brief: fills whole bytes, 32-bit words once the address is aligned
+ */
+static void Paint_FillBytes(uint8_t* dst, int count, uint8_t value) {
+    uint32_t word = value * 0x01010101UL;
+
+    for (; count > 0 && ((uintptr_t)dst & 3); count--) {
+        *dst++ = value;
+    }
+    for (; count >= 4; count -= 4, dst += 4) {
+        *(uint32_t*)dst = word;
+    }
+    for (; count > 0; count--) {
+        *dst++ = value;
+    }
+}
+
+/**
+ *  @brief: fills the pixels x0 to x1 of the rows y0 to y1, in absolute
+ *          coordinates and clipped. The edge masks are computed once,
+ *          the bytes in between are filled whole
+ */
+static void Paint_FillAbsoluteRect(paint_t* paint, int x0, int y0, int x1, int y1, int colored) {
+    int stride = paint->width / 8;
+    uint8_t value = Paint_ColorByte(colored);
+    uint8_t head, tail;
+    uint8_t* row;
+    int first, last;
+
+    if (x0 < 0) {
+        x0 = 0;
+    }
+    if (y0 < 0) {
+        y0 = 0;
+    }
+    if (x1 >= paint->width) {
+        x1 = paint->width - 1;
+    }
+    if (y1 >= paint->height) {
+        y1 = paint->height - 1;
+    }
+    if (x0 > x1 || y0 > y1) {
+        return;
+    }
+    first = x0 / 8;
+    last = x1 / 8;
+    row = &paint->frame_buffer[y0 * stride];
+
+    if (x0 == 0 && x1 == paint->width - 1) {
+        /* Whole rows follow each other in the frame buffer */
+        Paint_FillBytes(row, (y1 - y0 + 1) * stride, value);
+        return;
+    }
+    head = 0xFF >> (x0 % 8);
+    tail = 0xFF << (7 - x1 % 8);
+    if (first == last) {
+        head &= tail;
+    }
+    for (int y = y0; y <= y1; y++, row += stride) {
+        row[first] = (row[first] & ~head) | (value & head);
+        if (last > first) {
+            Paint_FillBytes(&row[first + 1], last - first - 1, value);
+            row[last] = (row[last] & ~tail) | (value & tail);
         }
     }
 }
 
+/**
+ *  @brief: fills the rectangle x0..x1, y0..y1 given in rotated coordinates.
+ *          The rotation is resolved once for the rectangle, with the same
+ *          mapping and clipping as Paint_DrawPixel()
+ */
+static void Paint_FillRect(paint_t* paint, int x0, int y0, int x1, int y1, int colored) {
+    int rotated = (paint->rotate == ROTATE_90 || paint->rotate == ROTATE_270);
+    int w = rotated ? paint->height : paint->width;
+    int h = rotated ? paint->width : paint->height;
+
+    if (x0 < 0) {
+        x0 = 0;
+    }
+    if (y0 < 0) {
+        y0 = 0;
+    }
+    if (x1 >= w) {
+        x1 = w - 1;
+    }
+    if (y1 >= h) {
+        y1 = h - 1;
+    }
+    if (x0 > x1 || y0 > y1) {
+        return;
+    }
+    if (paint->rotate == ROTATE_0) {
+        Paint_FillAbsoluteRect(paint, x0, y0, x1, y1, colored);
+    } else if (paint->rotate == ROTATE_90) {
+        Paint_FillAbsoluteRect(paint, paint->width - y1, x0, paint->width - y0, x1, colored);
+    } else if (paint->rotate == ROTATE_180) {
+        Paint_FillAbsoluteRect(paint, paint->width - x1, paint->height - y1, paint->width - x0, paint->height - y0, colored);
+    } else if (paint->rotate == ROTATE_270) {
+        Paint_FillAbsoluteRect(paint, y0, paint->height - x1, y1, paint->height - x0, colored);
+    }
+}
+
+/**
+ *  @brief: clear the image
+ */
+void Paint_Clear(paint_t* paint, int colored) {
+    Paint_FillBytes(paint->frame_buffer, paint->width / 8 * paint->height, Paint_ColorByte(colored));
+}
+
 /**
  *  @brief: this draws a pixel by absolute coordinates.
  *          this function won't be affected by the rotate parameter.
@@ -106,6 +215,32 @@ void Paint_SetRotate(paint_t* paint, int rotate){
     paint->rotate = rotate;
 }
 
+/**
+ *  @brief: converts a window given in rotated coordinates to absolute
+ *          coordinates, with the same mapping as Paint_DrawPixel()
+ */
+void Paint_GetAbsoluteWindow(paint_t* paint, int* x, int* y, int* width, int* height) {
+    int x0 = *x;
+    int y0 = *y;
+    int w = *width;
+    int h = *height;
+
+    if (paint->rotate == ROTATE_90) {
+        *x = paint->width - (y0 + h - 1);
+        *y = x0;
+        *width = h;
+        *height = w;
+    } else if (paint->rotate == ROTATE_180) {
+        *x = paint->width - (x0 + w - 1);
+        *y = paint->height - (y0 + h - 1);
+    } else if (paint->rotate == ROTATE_270) {
+        *x = y0;
+        *y = paint->height - (x0 + w - 1);
+        *width = h;
+        *height = w;
+    }
+}
+
 /**
  *  @brief: this draws a pixel by the coordinates
  */
@@ -213,20 +348,14 @@ void Paint_DrawLine(paint_t* paint, int x0, int y0, int x1, int y1, int colored)
 *  @brief: this draws a horizontal line on the frame buffer
 */
 void Paint_DrawHorizontalLine(paint_t* paint, int x, int y, int line_width, int colored) {
-    int i;
-    for (i = x; i < x + line_width; i++) {
-        Paint_DrawPixel(paint, i, y, colored);
-    }
+    Paint_FillRect(paint, x, y, x + line_width - 1, y, colored);
 }
 
 /**
 *  @brief: this draws a vertical line on the frame buffer
 */
 void Paint_DrawVerticalLine(paint_t* paint, int x, int y, int line_height, int colored) {
-    int i;
-    for (i = y; i < y + line_height; i++) {
-        Paint_DrawPixel(paint, x, i, colored);
-    }
+    Paint_FillRect(paint, x, y, x, y + line_height - 1, colored);
 }
 
 /**
@@ -250,15 +379,12 @@ void Paint_DrawRectangle(paint_t* paint, int x0, int y0, int x1, int y1, int col
 */
 void Paint_DrawFilledRectangle(paint_t* paint, int x0, int y0, int x1, int y1, int colored) {
     int min_x, min_y, max_x, max_y;
-    int i;
     min_x = x1 > x0 ? x0 : x1;
     max_x = x1 > x0 ? x1 : x0;
     min_y = y1 > y0 ? y0 : y1;
     max_y = y1 > y0 ? y1 : y0;
     
-    for (i = min_x; i <= max_x; i++) {
-      Paint_DrawVerticalLine(paint, i, min_y, max_y - min_y + 1, colored);
-    }
+    Paint_FillRect(paint, min_x, min_y, max_x, max_y, colored);
 }
 
 /**
@@ -300,10 +426,7 @@ void Paint_DrawFilledCircle(paint_t* paint, int x, int y, int radius, int colore
     int e2;
 
     do {
-        Paint_DrawPixel(paint, x - x_pos, y + y_pos, colored);
-        Paint_DrawPixel(paint, x + x_pos, y + y_pos, colored);
-        Paint_DrawPixel(paint, x + x_pos, y - y_pos, colored);
-        Paint_DrawPixel(paint, x - x_pos, y - y_pos, colored);
+        /* The spans cover the outline pixels too */
         Paint_DrawHorizontalLine(paint, x + x_pos, y + y_pos, 2 * (-x_pos) + 1, colored);
         Paint_DrawHorizontalLine(paint, x + x_pos, y - y_pos, 2 * (-x_pos) + 1, colored);
         e2 = err;
@@ -55,6 +55,7 @@ int  Paint_GetHeight(paint_t* paint);
 void Paint_SetHeight(paint_t* paint, int height);
 int  Paint_GetRotate(paint_t* paint);
 void Paint_SetRotate(paint_t* paint, int rotate);
+void Paint_GetAbsoluteWindow(paint_t* paint, int* x, int* y, int* width, int* height);
 unsigned char* Paint_GetImage(paint_t* paint);
 void Paint_DrawAbsolutePixel(paint_t* paint, int x, int y, int colored);
 void Paint_DrawPixel(paint_t* paint, int x, int y, int colored);
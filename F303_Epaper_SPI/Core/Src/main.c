@@ -40,6 +40,15 @@
 // Display resolution
 #define EPD_WIDTH       128
 #define EPD_HEIGHT      296
+
+// Upload the frame once per byte before the block upload to time both, the frame is sent twice
+#define EPD_UPLOAD_BENCHMARK  0
+
+// Refresh twice at startup to time the polled BUSY wait against the sleeping one
+#define EPD_WAIT_BENCHMARK  0
+
+// Time the frame buffer clear and fill with the cycle counter at startup
+#define PAINT_BENCHMARK     0
 /* USER CODE END PD */
 
 /* Private macro -------------------------------------------------------------*/
@@ -49,16 +58,39 @@
 
 /* Private variables ---------------------------------------------------------*/
  SPI_HandleTypeDef hspi1;
+DMA_HandleTypeDef hdma_spi1_tx;
 
 /* USER CODE BEGIN PV */
+epd_handle_t* epd_handle_1;
+
+/* Frame upload times in ms, per byte transfers against block transfers */
+volatile uint32_t upload_ms_bytes;
+volatile uint32_t upload_ms_block;
+
+/* Refresh waits in ms, BUSY polled every 100 ms against sleeping until its EXTI */
+volatile uint32_t wait_ms_poll;
+volatile uint32_t wait_ms_sleep;
+
+/* Update latencies in ms, full frame against a window */
+volatile uint32_t update_ms_full;
+volatile uint32_t update_ms_window;
+
+/* Updates dropped by the change detection */
+volatile uint32_t refreshes_skipped;
+
+/* Frame buffer clear and 115x86 filled rectangle, in CPU cycles */
+volatile uint32_t paint_clear_cycles;
+volatile uint32_t paint_fill_cycles;
 
 /* USER CODE END PV */
 
 /* Private function prototypes -----------------------------------------------*/
 void SystemClock_Config(void);
 static void MX_GPIO_Init(void);
+static void MX_DMA_Init(void);
 static void MX_SPI1_Init(void);
 /* USER CODE BEGIN PFP */
+static void Frame_Hash_Init(void);
 
 /* USER CODE END PFP */
 
@@ -95,6 +127,7 @@ int main(void)
 
   /* Initialize all configured peripherals */
   MX_GPIO_Init();
+  MX_DMA_Init();
   MX_SPI1_Init();
   /* USER CODE BEGIN 2 */
 
@@ -105,7 +138,11 @@ int main(void)
 	epd_pin_t* epd_pin_busy = epd_pin_new(GPIOA, GPIO_PIN_3);
 
 	/* Epaper display handle struct*/
-	epd_handle_t* epd_handle_1 = epd_handle_new(&hspi1, epd_pin_cs, epd_pin_rst, epd_pin_dc, epd_pin_busy, EPD_WIDTH, EPD_HEIGHT);
+	epd_handle_1 = epd_handle_new(&hspi1, epd_pin_cs, epd_pin_rst, epd_pin_dc, epd_pin_busy, EPD_WIDTH, EPD_HEIGHT);
+
+	/* Hashes of the image left on the display, kept in backup registers 0 and 1 */
+	Frame_Hash_Init();
+	EPD_RestoreHashes(epd_handle_1, 0);
 
 	if (EPD_Init(epd_handle_1) != 0) {
 		return -1;
@@ -114,6 +151,17 @@ int main(void)
 	/* Frame buffer paint struct */
 	paint_t* paint_black = paint_new(EPD_WIDTH, EPD_HEIGHT);
 	paint_t* paint_red = paint_new(EPD_WIDTH, EPD_HEIGHT);
+#if PAINT_BENCHMARK
+	CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+	DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+	uint32_t cycles = DWT->CYCCNT;
+	Paint_Clear(paint_red, UNCOLORED);
+	paint_clear_cycles = DWT->CYCCNT - cycles;
+
+	cycles = DWT->CYCCNT;
+	Paint_DrawFilledRectangle(paint_red, 3, 5, 117, 90, COLORED);
+	paint_fill_cycles = DWT->CYCCNT - cycles;
+#endif
 	Paint_Clear(paint_black, UNCOLORED);
 	Paint_Clear(paint_red, UNCOLORED);
 
@@ -139,8 +187,38 @@ int main(void)
 		paint_black->frame_buffer[i] = pixel_byte;
 	}
 
+#if EPD_UPLOAD_BENCHMARK
+	/* Time the per byte upload, the block upload below overwrites it before the refresh */
+	EPD_UploadFrameBytes(epd_handle_1, paint_black->frame_buffer, IMAGE_RED);
+	upload_ms_bytes = epd_handle_1->upload_ms;
+#endif
+
 	/* Display the image buffer */
+#if EPD_WAIT_BENCHMARK
+	epd_handle_1->wait_mode = EPD_WAIT_POLL;
+#endif
 	EPD_DisplayFrame(epd_handle_1, paint_black->frame_buffer, IMAGE_RED);
+	upload_ms_block = epd_handle_1->upload_ms;
+	update_ms_full = epd_handle_1->update_ms;
+#if EPD_WAIT_BENCHMARK
+	wait_ms_poll = epd_handle_1->wait_ms;
+
+	/* Same refresh, the display RAM still holds the frame */
+	epd_handle_1->wait_mode = EPD_WAIT_SLEEP;
+	EPD_SendCommand(epd_handle_1, DISPLAY_REFRESH);
+	EPD_WaitUntilIdle(epd_handle_1);
+	wait_ms_sleep = epd_handle_1->wait_ms;
+#endif
+
+	/* Change a reading only, the bands holding it are sent and refreshed alone */
+	Paint_DrawFilledRectangle(paint_black, 0, 256, 127, 279, UNCOLORED);
+	Paint_DrawStringAt(paint_black, 22, 260, "21.5 C", &Font20, COLORED);
+	EPD_DisplayChanges(epd_handle_1, paint_black, NULL);
+	update_ms_window = epd_handle_1->update_ms;
+
+	/* Nothing changed since, neither upload nor refresh */
+	EPD_DisplayChanges(epd_handle_1, paint_black, NULL);
+	refreshes_skipped = epd_handle_1->skipped_refreshes;
 
 /* USER CODE END 2 */
 
@@ -235,6 +313,22 @@ static void MX_SPI1_Init(void)
 
 }
 
+/**
+  * Enable DMA controller clock
+  */
+static void MX_DMA_Init(void)
+{
+
+  /* DMA controller clock enable */
+  __HAL_RCC_DMA1_CLK_ENABLE();
+
+  /* DMA interrupt init */
+  /* DMA1_Channel3_IRQn interrupt configuration */
+  HAL_NVIC_SetPriority(DMA1_Channel3_IRQn, 0, 0);
+  HAL_NVIC_EnableIRQ(DMA1_Channel3_IRQn);
+
+}
+
 /**
   * @brief GPIO Initialization Function
   * @param None
@@ -270,13 +364,60 @@ static void MX_GPIO_Init(void)
 
   /*Configure GPIO pin : BUSY_Pin */
   GPIO_InitStruct.Pin = BUSY_Pin;
-  GPIO_InitStruct.Mode = GPIO_MODE_INPUT;
+  GPIO_InitStruct.Mode = GPIO_MODE_IT_RISING;
   GPIO_InitStruct.Pull = GPIO_NOPULL;
   HAL_GPIO_Init(BUSY_GPIO_Port, &GPIO_InitStruct);
 
+  /* EXTI interrupt init*/
+  HAL_NVIC_SetPriority(EXTI3_IRQn, 0, 0);
+  HAL_NVIC_EnableIRQ(EXTI3_IRQn);
+
 }
 
 /* USER CODE BEGIN 4 */
+/**
+  * @brief  Clocks the RTC domain from the LSI, so its backup registers can
+  *         keep the display hashes through standby, and the CRC unit
+  * @retval None
+  */
+static void Frame_Hash_Init(void)
+{
+	RCC_OscInitTypeDef RCC_OscInitStruct = {0};
+	RCC_PeriphCLKInitTypeDef PeriphClkInit = {0};
+
+	RCC_OscInitStruct.OscillatorType = RCC_OSCILLATORTYPE_LSI;
+	RCC_OscInitStruct.LSIState = RCC_LSI_ON;
+	RCC_OscInitStruct.PLL.PLLState = RCC_PLL_NONE;
+	if (HAL_RCC_OscConfig(&RCC_OscInitStruct) != HAL_OK) {
+		Error_Handler();
+	}
+
+	/* Same source as before a standby, the backup domain is not reset */
+	PeriphClkInit.PeriphClockSelection = RCC_PERIPHCLK_RTC;
+	PeriphClkInit.RTCClockSelection = RCC_RTCCLKSOURCE_LSI;
+	if (HAL_RCCEx_PeriphCLKConfig(&PeriphClkInit) != HAL_OK) {
+		Error_Handler();
+	}
+	HAL_PWR_EnableBkUpAccess();
+	__HAL_RCC_RTC_ENABLE();
+
+	__HAL_RCC_CRC_CLK_ENABLE();
+}
+
+void HAL_SPI_TxCpltCallback(SPI_HandleTypeDef *hspi)
+{
+	EpdSpiTxCpltCallback(epd_handle_1, hspi);
+}
+
+void HAL_SPI_ErrorCallback(SPI_HandleTypeDef *hspi)
+{
+	EpdSpiErrorCallback(epd_handle_1, hspi);
+}
+
+void HAL_GPIO_EXTI_Callback(uint16_t GPIO_Pin)
+{
+	EpdBusyIrqCallback(epd_handle_1, GPIO_Pin);
+}
 
 /* USER CODE END 4 */
 
@@ -0,0 +1,126 @@
+/*
+ *  E-paper update benchmark: runs the update sequence of the firmware through
+ *  the driver on the controller model and reports, per step, the bytes sent on
+ *  SPI and the refreshes. After every step the image on the panel is compared
+ *  with the frame buffers.
+ *
+ *  Usage: epd_bench
+ */
+#include <stdio.h>
+#include <string.h>
+#include "epd2in9b.h"
+#include "epd_sim.h"
+
+/* Pins of the firmware, PA4 PA2 PA1 PA3 */
+#define BENCH_PIN_CS		0x10
+#define BENCH_PIN_DC		0x04
+#define BENCH_PIN_RST		0x02
+#define BENCH_PIN_BUSY		0x08
+
+static GPIO_TypeDef bench_port;
+static SPI_HandleTypeDef bench_spi;		/* hdmatx NULL: blocking block transfers */
+static epd_pin_t bench_cs, bench_dc, bench_rst, bench_busy;
+static paint_t bench_black;
+static paint_t bench_red;
+static int bench_failures;
+
+static epd_handle_t* bench_Boot(void)
+{
+	epd_handle_t* epd = epd_handle_new(&bench_spi, &bench_cs, &bench_rst, &bench_dc, &bench_busy,
+			EPD_SIM_WIDTH, EPD_SIM_HEIGHT);
+
+	EPD_RestoreHashes(epd, 0);
+	EPD_Init(epd);
+	return epd;
+}
+
+static void bench_Report(const char* name, epd_handle_t* epd)
+{
+	uint32_t diff = epd_sim_Compare(bench_black.frame_buffer, bench_red.frame_buffer);
+
+	printf("%-24s %8u %8u %6u %6u %6u %6u  %s\n", name, epd_sim_stats.wire_bytes, epd_sim_stats.data_bytes,
+			epd_sim_stats.refreshes, epd_sim_stats.partial, epd->skipped_uploads, epd->skipped_refreshes,
+			(diff == 0 && epd_sim_stats.errors == 0) ? "ok" : "PANEL MISMATCH");
+	if (diff != 0 || epd_sim_stats.errors != 0) {
+		bench_failures++;
+	}
+	epd_sim_ResetStats();
+}
+
+/* The reading redraws rows 256 to 279, its text covers the bands of rows 260 to 279 */
+static void bench_Window(const char* name, unsigned y0, unsigned y1)
+{
+	int ok = (epd_sim_stats.window_y0 == y0 && epd_sim_stats.window_y1 == y1);
+
+	printf("%-24s rows %u to %u  %s\n", name, epd_sim_stats.window_y0, epd_sim_stats.window_y1,
+			ok ? "ok" : "WRONG WINDOW");
+	if (!ok) {
+		bench_failures++;
+	}
+}
+
+int main(void)
+{
+	epd_handle_t* epd;
+
+	epd_pin_init(&bench_cs, &bench_port, BENCH_PIN_CS);
+	epd_pin_init(&bench_dc, &bench_port, BENCH_PIN_DC);
+	epd_pin_init(&bench_rst, &bench_port, BENCH_PIN_RST);
+	epd_pin_init(&bench_busy, &bench_port, BENCH_PIN_BUSY);
+	paint_init(&bench_black, EPD_SIM_WIDTH, EPD_SIM_HEIGHT);
+	paint_init(&bench_red, EPD_SIM_WIDTH, EPD_SIM_HEIGHT);
+	Paint_Clear(&bench_black, 0);
+	Paint_Clear(&bench_red, 0);
+
+	epd_sim_Reset(BENCH_PIN_CS, BENCH_PIN_DC, BENCH_PIN_RST);
+	epd = bench_Boot();
+	epd_sim_ResetStats();
+
+	printf("Per update (plane: %d bytes)\n", EPD_SIM_PLANE);
+	printf("%-24s %8s %8s %6s %6s %6s %6s  %s\n", "step", "wire", "data", "refr", "part", "skip_u", "skip_r", "panel");
+
+	Paint_DrawStringAt(&bench_black, 10, 10, "Hello", &Font20, 1);
+	Paint_DrawStringAt(&bench_red, 10, 100, "Red", &Font20, 1);
+	EPD_DisplayFrame(epd, bench_black.frame_buffer, bench_red.frame_buffer);
+	bench_Report("full frame", epd);
+
+	EPD_DisplayFrame(epd, bench_black.frame_buffer, bench_red.frame_buffer);
+	bench_Report("same frame", epd);
+
+	Paint_DrawStringAt(&bench_black, 10, 200, "X", &Font20, 1);
+	EPD_DisplayFrame(epd, bench_black.frame_buffer, bench_red.frame_buffer);
+	bench_Report("black plane changed", epd);
+
+	// the reading of the firmware
+	Paint_DrawFilledRectangle(&bench_black, 0, 256, 127, 279, 0);
+	Paint_DrawStringAt(&bench_black, 22, 260, "21.5 C", &Font20, 1);
+	EPD_DisplayChanges(epd, &bench_black, &bench_red);
+	bench_Window("reading window", 260, 279);
+	bench_Report("reading changed", epd);
+
+	EPD_DisplayChanges(epd, &bench_black, &bench_red);
+	bench_Report("reading unchanged", epd);
+
+	// standby: the hashes come back from the backup registers, the RAMs are lost
+	epd = bench_Boot();
+	epd_sim_ResetStats();
+	EPD_DisplayFrame(epd, bench_black.frame_buffer, bench_red.frame_buffer);
+	bench_Report("standby, same frame", epd);
+
+	// the band hashes come back with the frame, only the reading is refreshed
+	Paint_DrawFilledRectangle(&bench_black, 0, 256, 127, 279, 0);
+	Paint_DrawStringAt(&bench_black, 22, 260, "22.0 C", &Font20, 1);
+	EPD_DisplayChanges(epd, &bench_black, &bench_red);
+	bench_Window("standby, reading window", 260, 279);
+	bench_Report("standby, reading changed", epd);
+
+	Paint_DrawStringAt(&bench_black, 10, 150, "Y", &Font20, 1);
+	EPD_DisplayFrame(epd, bench_black.frame_buffer, bench_red.frame_buffer);
+	bench_Report("standby, black changed", epd);
+
+	Paint_DrawStringAt(&bench_black, 10, 70, "W", &Font20, 1);
+	EPD_DisplayFrame(epd, bench_black.frame_buffer, bench_red.frame_buffer);
+	bench_Report("then black changed", epd);
+
+	return bench_failures ? 1 : 0;
+}
@@ -0,0 +1,228 @@
+#include <string.h>
+#include "epd_sim.h"
+
+/* Commands decoded by the model */
+#define SIM_DTM1			0x10
+#define SIM_REFRESH			0x12
+#define SIM_DTM2			0x13
+#define SIM_WINDOW			0x90
+#define SIM_PARTIAL_IN		0x91
+#define SIM_PARTIAL_OUT		0x92
+
+#define SIM_STRIDE			(EPD_SIM_WIDTH / 8)
+
+epd_sim_stats_t epd_sim_stats;
+RTC_TypeDef sim_RTC;
+
+static uint16_t sim_pin_cs;
+static uint16_t sim_pin_dc;
+static uint16_t sim_pin_rst;
+static uint8_t sim_cs = 1;
+static uint8_t sim_dc;
+static uint32_t sim_tick;
+
+static uint8_t sim_command;
+static uint8_t sim_ram_index;			/* RAM written by the data: 0 black, 1 red */
+static uint32_t sim_pos;				/* Bytes of data since the command */
+static uint8_t sim_partial;
+static uint8_t sim_args[7];
+static uint16_t sim_x0, sim_x1, sim_y0, sim_y1;
+
+static uint8_t sim_ram[2][EPD_SIM_PLANE];
+static uint8_t sim_shown[2][EPD_SIM_PLANE];
+
+
+/**	--- Controller --- **/
+
+
+static void sim_Window(uint16_t x0, uint16_t x1, uint16_t y0, uint16_t y1)
+{
+	sim_x0 = x0;
+	sim_x1 = x1;
+	sim_y0 = y0;
+	sim_y1 = y1;
+}
+
+static void sim_Command(uint8_t command)
+{
+	int c, y;
+
+	sim_command = command;
+	sim_pos = 0;
+	switch (command) {
+	case SIM_DTM1:
+	case SIM_DTM2:
+		sim_ram_index = (command == SIM_DTM2);
+		break;
+	case SIM_PARTIAL_IN:
+		sim_partial = 1;
+		sim_Window(0, EPD_SIM_WIDTH - 1, 0, EPD_SIM_HEIGHT - 1);
+		break;
+	case SIM_PARTIAL_OUT:
+		sim_partial = 0;
+		break;
+	case SIM_REFRESH:
+		if (!sim_partial) {
+			sim_Window(0, EPD_SIM_WIDTH - 1, 0, EPD_SIM_HEIGHT - 1);
+		}
+		for (c = 0; c < 2; c++) {
+			for (y = sim_y0; y <= sim_y1 && y < EPD_SIM_HEIGHT; y++) {
+				memcpy(&sim_shown[c][y * SIM_STRIDE + sim_x0 / 8], &sim_ram[c][y * SIM_STRIDE + sim_x0 / 8],
+						sim_x1 / 8 - sim_x0 / 8 + 1);
+			}
+		}
+		epd_sim_stats.refreshes++;
+		if (sim_partial) {
+			epd_sim_stats.partial++;
+			epd_sim_stats.window_y0 = sim_y0;
+			epd_sim_stats.window_y1 = sim_y1;
+		}
+		break;
+	}
+}
+
+static void sim_Data(uint8_t data)
+{
+	uint32_t width, offset;
+
+	if (sim_command == SIM_WINDOW) {
+		if (sim_pos < sizeof(sim_args)) {
+			sim_args[sim_pos++] = data;
+		}
+		if (sim_pos == sizeof(sim_args)) {
+			// HRST, HRED, VRST high and low, VRED high and low, scan
+			sim_Window(sim_args[0] & 0xF8, sim_args[1] | 0x07, sim_args[2] << 8 | sim_args[3], sim_args[4] << 8 | sim_args[5]);
+		}
+		return;
+	}
+	if (sim_command != SIM_DTM1 && sim_command != SIM_DTM2) {
+		return;
+	}
+
+	// the data fills the window, or the whole RAM outside partial mode
+	if (sim_partial) {
+		width = sim_x1 / 8 - sim_x0 / 8 + 1;
+		offset = (sim_y0 + sim_pos / width) * SIM_STRIDE + sim_x0 / 8 + sim_pos % width;
+	} else {
+		offset = sim_pos;
+	}
+	sim_pos++;
+	if (offset >= EPD_SIM_PLANE) {
+		epd_sim_stats.errors++;
+		return;
+	}
+	sim_ram[sim_ram_index][offset] = data;
+	epd_sim_stats.data_bytes++;
+}
+
+static void sim_Byte(uint8_t byte)
+{
+	epd_sim_stats.wire_bytes++;
+	if (sim_cs) {
+		epd_sim_stats.errors++;
+		return;
+	}
+	if (sim_dc) {
+		sim_Data(byte);
+	} else {
+		sim_Command(byte);
+	}
+}
+
+void epd_sim_Reset(uint16_t cs, uint16_t dc, uint16_t rst)
+{
+	sim_pin_cs = cs;
+	sim_pin_dc = dc;
+	sim_pin_rst = rst;
+	sim_cs = 1;
+	sim_partial = 0;
+	memset(sim_ram, EPD_SIM_RAM_LOST, sizeof(sim_ram));
+	memset(sim_shown, EPD_SIM_RAM_LOST, sizeof(sim_shown));
+	epd_sim_ResetStats();
+}
+
+void epd_sim_ResetStats(void)
+{
+	memset(&epd_sim_stats, 0, sizeof(epd_sim_stats));
+}
+
+uint32_t epd_sim_Compare(const uint8_t* black, const uint8_t* red)
+{
+	uint32_t diff = 0;
+	uint32_t i;
+
+	for (i = 0; i < EPD_SIM_PLANE; i++) {
+		diff += (sim_shown[0][i] != black[i]) + (sim_shown[1][i] != red[i]);
+	}
+	return diff;
+}
+
+
+/**	--- HAL --- **/
+
+
+void SystemClock_Config(void)
+{
+}
+
+uint32_t HAL_GetTick(void)
+{
+	return sim_tick;
+}
+
+void HAL_Delay(uint32_t Delay)
+{
+	sim_tick += Delay;
+}
+
+void HAL_PWR_EnableBkUpAccess(void)
+{
+}
+
+void HAL_PWR_EnterSLEEPMode(uint32_t Regulator, uint8_t SLEEPEntry)
+{
+}
+
+void HAL_PWR_EnterSTOPMode(uint32_t Regulator, uint8_t STOPEntry)
+{
+}
+
+void HAL_GPIO_WritePin(GPIO_TypeDef* GPIOx, uint16_t GPIO_Pin, GPIO_PinState PinState)
+{
+	if (GPIO_Pin == sim_pin_cs) {
+		sim_cs = PinState;
+	} else if (GPIO_Pin == sim_pin_dc) {
+		sim_dc = PinState;
+	} else if (GPIO_Pin == sim_pin_rst && PinState == GPIO_PIN_RESET) {
+		// the RAMs do not survive a reset, the panel keeps its image
+		memset(sim_ram, EPD_SIM_RAM_LOST, sizeof(sim_ram));
+		sim_partial = 0;
+	}
+}
+
+GPIO_PinState HAL_GPIO_ReadPin(GPIO_TypeDef* GPIOx, uint16_t GPIO_Pin)
+{
+	// BUSY is high when the controller is idle
+	return GPIO_PIN_SET;
+}
+
+HAL_StatusTypeDef HAL_SPI_Transmit(SPI_HandleTypeDef *hspi, uint8_t *pData, uint16_t Size, uint32_t Timeout)
+{
+	uint16_t i;
+
+	for (i = 0; i < Size; i++) {
+		sim_Byte(pData[i]);
+	}
+	return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_SPI_Transmit_DMA(SPI_HandleTypeDef *hspi, uint8_t *pData, uint16_t Size)
+{
+	// the bench leaves hdmatx NULL, the driver sends blocks with HAL_SPI_Transmit()
+	return HAL_ERROR;
+}
+
+HAL_StatusTypeDef HAL_SPI_Abort(SPI_HandleTypeDef *hspi)
+{
+	return HAL_OK;
+}
@@ -0,0 +1,56 @@
+#ifndef EPD_SIM_H
+#define EPD_SIM_H
+
+/*
+ *  Host model of the controller of the 2.9" tri-colour panel. The SPI bytes
+ *  are decoded with the DC and CS pins into the two data RAMs, full frame or
+ *  through the partial window, and each refresh copies the refreshed area of
+ *  the RAMs to what the panel shows. A reset pulse loses the RAMs, as a deep
+ *  sleep or standby does. BUSY always reads idle.
+ */
+
+#include "main.h"
+
+#define EPD_SIM_WIDTH			128
+#define EPD_SIM_HEIGHT			296
+#define EPD_SIM_PLANE			(EPD_SIM_WIDTH / 8 * EPD_SIM_HEIGHT)
+#define EPD_SIM_RAM_LOST		0x55		/* Content of the RAMs after a reset */
+
+/**
+ * @brief  Bus and panel statistics, cleared by @ref epd_sim_ResetStats()
+ */
+typedef struct {
+	uint32_t wire_bytes;	/*!< Bytes on SPI, commands included */
+	uint32_t data_bytes;	/*!< Bytes written to the data RAMs */
+	uint32_t refreshes;		/*!< Refreshes, full and partial */
+	uint32_t partial;		/*!< Refreshes of a partial window */
+	uint16_t window_y0;		/*!< Rows of the last partial window */
+	uint16_t window_y1;
+	uint32_t errors;		/*!< Bytes outside a transaction or past the end of the RAM */
+} epd_sim_stats_t;
+
+extern epd_sim_stats_t epd_sim_stats;
+
+/**
+ * @brief  Powers the model on, the RAMs and the panel are unknown
+ * @param  cs: pin number of CS
+ * @param  dc: pin number of DC
+ * @param  rst: pin number of RST
+ * @retval None
+ */
+void epd_sim_Reset(uint16_t cs, uint16_t dc, uint16_t rst);
+
+/**
+ * @brief  Clears the statistics
+ */
+void epd_sim_ResetStats(void);
+
+/**
+ * @brief  Compares what the panel shows with the frame buffers
+ * @param  black: black plane, 1 bit per pixel
+ * @param  red: red plane, 1 bit per pixel
+ * @retval Number of bytes that differ
+ */
+uint32_t epd_sim_Compare(const uint8_t* black, const uint8_t* red);
+
+#endif
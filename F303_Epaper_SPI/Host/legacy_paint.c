@@ -0,0 +1,74 @@
+/*
+ *  Fill functions of epdpaint.c before the span rewrite, kept as the
+ *  reference of the paint benchmark. They go through Paint_DrawPixel() and
+ *  Paint_DrawAbsolutePixel() one pixel at a time.
+ */
+#include "epdpaint.h"
+
+void legacy_Paint_Clear(paint_t* paint, int colored);
+void legacy_Paint_DrawHorizontalLine(paint_t* paint, int x, int y, int line_width, int colored);
+void legacy_Paint_DrawVerticalLine(paint_t* paint, int x, int y, int line_height, int colored);
+void legacy_Paint_DrawFilledRectangle(paint_t* paint, int x0, int y0, int x1, int y1, int colored);
+void legacy_Paint_DrawFilledCircle(paint_t* paint, int x, int y, int radius, int colored);
+
+void legacy_Paint_Clear(paint_t* paint, int colored) {
+    for (int x = 0; x < paint->width; x++) {
+        for (int y = 0; y < paint->height; y++) {
+            Paint_DrawAbsolutePixel(paint, x, y, colored);
+        }
+    }
+}
+
+void legacy_Paint_DrawHorizontalLine(paint_t* paint, int x, int y, int line_width, int colored) {
+    int i;
+    for (i = x; i < x + line_width; i++) {
+        Paint_DrawPixel(paint, i, y, colored);
+    }
+}
+
+void legacy_Paint_DrawVerticalLine(paint_t* paint, int x, int y, int line_height, int colored) {
+    int i;
+    for (i = y; i < y + line_height; i++) {
+        Paint_DrawPixel(paint, x, i, colored);
+    }
+}
+
+void legacy_Paint_DrawFilledRectangle(paint_t* paint, int x0, int y0, int x1, int y1, int colored) {
+    int min_x, min_y, max_x, max_y;
+    int i;
+    min_x = x1 > x0 ? x0 : x1;
+    max_x = x1 > x0 ? x1 : x0;
+    min_y = y1 > y0 ? y0 : y1;
+    max_y = y1 > y0 ? y1 : y0;
+
+    for (i = min_x; i <= max_x; i++) {
+      legacy_Paint_DrawVerticalLine(paint, i, min_y, max_y - min_y + 1, colored);
+    }
+}
+
+void legacy_Paint_DrawFilledCircle(paint_t* paint, int x, int y, int radius, int colored) {
+    /* Bresenham algorithm */
+    int x_pos = -radius;
+    int y_pos = 0;
+    int err = 2 - 2 * radius;
+    int e2;
+
+    do {
+        Paint_DrawPixel(paint, x - x_pos, y + y_pos, colored);
+        Paint_DrawPixel(paint, x + x_pos, y + y_pos, colored);
+        Paint_DrawPixel(paint, x + x_pos, y - y_pos, colored);
+        Paint_DrawPixel(paint, x - x_pos, y - y_pos, colored);
+        legacy_Paint_DrawHorizontalLine(paint, x + x_pos, y + y_pos, 2 * (-x_pos) + 1, colored);
+        legacy_Paint_DrawHorizontalLine(paint, x + x_pos, y - y_pos, 2 * (-x_pos) + 1, colored);
+        e2 = err;
+        if (e2 <= y_pos) {
+            err += ++y_pos * 2 + 1;
+            if(-x_pos == y_pos && e2 <= x_pos) {
+                e2 = 0;
+            }
+        }
+        if(e2 > x_pos) {
+            err += ++x_pos * 2 + 1;
+        }
+    } while(x_pos <= 0);
+}
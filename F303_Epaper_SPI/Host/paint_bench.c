@@ -0,0 +1,196 @@
+/*
+ *  Paint benchmark: checks that the span fills of epdpaint.c leave the frame
+ *  buffer exactly as the per-pixel code did, for every rotation, with random
+ *  shapes partly off the panel, then times both on the 128x296 frame of the
+ *  firmware.
+ *
+ *  Usage: paint_bench
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "epdpaint.h"
+
+#define BENCH_WIDTH			128
+#define BENCH_HEIGHT		296
+#define BENCH_SHAPES		20000		/* Random shapes per rotation of the check */
+
+void legacy_Paint_Clear(paint_t* paint, int colored);
+void legacy_Paint_DrawHorizontalLine(paint_t* paint, int x, int y, int line_width, int colored);
+void legacy_Paint_DrawVerticalLine(paint_t* paint, int x, int y, int line_height, int colored);
+void legacy_Paint_DrawFilledRectangle(paint_t* paint, int x0, int y0, int x1, int y1, int colored);
+void legacy_Paint_DrawFilledCircle(paint_t* paint, int x, int y, int radius, int colored);
+
+/* Drawing of the timed operations, with the old code or the span fills */
+typedef void (*bench_draw_t)(paint_t* paint, int legacy, int colored);
+
+static paint_t bench_ref;
+static paint_t bench_new;
+
+static uint64_t bench_Nanoseconds(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+/* Coordinate from a little before to a little after a side of the panel */
+static int bench_Coord(int size)
+{
+	return rand() % (size + 40) - 20;
+}
+
+static int bench_Check(void)
+{
+	const int size = BENCH_WIDTH / 8 * BENCH_HEIGHT;
+	int failures = 0;
+	int rotate, i;
+
+	for (rotate = ROTATE_0; rotate <= ROTATE_270; rotate++) {
+		for (i = 0; i < size; i++) {
+			bench_ref.frame_buffer[i] = bench_new.frame_buffer[i] = rand();
+		}
+		Paint_SetRotate(&bench_ref, rotate);
+		Paint_SetRotate(&bench_new, rotate);
+
+		for (i = 0; i < BENCH_SHAPES; i++) {
+			int w = (rotate == ROTATE_90 || rotate == ROTATE_270) ? BENCH_HEIGHT : BENCH_WIDTH;
+			int h = (rotate == ROTATE_90 || rotate == ROTATE_270) ? BENCH_WIDTH : BENCH_HEIGHT;
+			int x0 = bench_Coord(w), y0 = bench_Coord(h);
+			int x1 = bench_Coord(w), y1 = bench_Coord(h);
+			int len = rand() % (w + 20) - 10;
+			int radius = rand() % 80;
+			int colored = rand() & 1;
+			int shape = rand() % 5;
+
+			switch (shape) {
+			case 0:
+				legacy_Paint_DrawHorizontalLine(&bench_ref, x0, y0, len, colored);
+				Paint_DrawHorizontalLine(&bench_new, x0, y0, len, colored);
+				break;
+			case 1:
+				legacy_Paint_DrawVerticalLine(&bench_ref, x0, y0, len, colored);
+				Paint_DrawVerticalLine(&bench_new, x0, y0, len, colored);
+				break;
+			case 2:
+				legacy_Paint_DrawFilledRectangle(&bench_ref, x0, y0, x1, y1, colored);
+				Paint_DrawFilledRectangle(&bench_new, x0, y0, x1, y1, colored);
+				break;
+			case 3:
+				legacy_Paint_DrawFilledCircle(&bench_ref, x0, y0, radius, colored);
+				Paint_DrawFilledCircle(&bench_new, x0, y0, radius, colored);
+				break;
+			default:
+				if (rand() % 100 == 0) {
+					legacy_Paint_Clear(&bench_ref, colored);
+					Paint_Clear(&bench_new, colored);
+				}
+				break;
+			}
+			if (memcmp(bench_ref.frame_buffer, bench_new.frame_buffer, size) != 0) {
+				if (failures++ < 5) {
+					printf("MISMATCH rotate %d shape %d (%d,%d)-(%d,%d) len %d radius %d colored %d\n",
+							rotate, shape, x0, y0, x1, y1, len, radius, colored);
+				}
+				memcpy(bench_new.frame_buffer, bench_ref.frame_buffer, size);
+			}
+		}
+	}
+	return failures;
+}
+
+static void bench_Clear(paint_t* paint, int legacy, int colored)
+{
+	if (legacy) {
+		legacy_Paint_Clear(paint, colored);
+	} else {
+		Paint_Clear(paint, colored);
+	}
+}
+
+/* Reading box of the firmware, not aligned on the bytes */
+static void bench_Rect(paint_t* paint, int legacy, int colored)
+{
+	if (legacy) {
+		legacy_Paint_DrawFilledRectangle(paint, 3, 5, 117, 90, colored);
+	} else {
+		Paint_DrawFilledRectangle(paint, 3, 5, 117, 90, colored);
+	}
+}
+
+static void bench_Lines(paint_t* paint, int legacy, int colored)
+{
+	int i;
+
+	for (i = 0; i < 16; i++) {
+		if (legacy) {
+			legacy_Paint_DrawHorizontalLine(paint, 1, 10 + i * 8, 250, colored);
+			legacy_Paint_DrawVerticalLine(paint, 10 + i * 16, 1, 120, colored);
+		} else {
+			Paint_DrawHorizontalLine(paint, 1, 10 + i * 8, 250, colored);
+			Paint_DrawVerticalLine(paint, 10 + i * 16, 1, 120, colored);
+		}
+	}
+}
+
+static void bench_Circle(paint_t* paint, int legacy, int colored)
+{
+	if (legacy) {
+		legacy_Paint_DrawFilledCircle(paint, 60, 60, 50, colored);
+	} else {
+		Paint_DrawFilledCircle(paint, 60, 60, 50, colored);
+	}
+}
+
+static double bench_Time(paint_t* paint, bench_draw_t draw, int legacy)
+{
+	uint64_t start, elapsed;
+	long runs = 0;
+
+	start = bench_Nanoseconds();
+	do {
+		draw(paint, legacy, runs & 1);
+		runs++;
+		elapsed = bench_Nanoseconds() - start;
+	} while (elapsed < 200000000ULL);
+	return (double)elapsed / runs;
+}
+
+int main(void)
+{
+	static const struct {
+		const char* name;
+		bench_draw_t draw;
+	} ops[] = {
+		{"clear", bench_Clear},
+		{"filled rectangle 115x86", bench_Rect},
+		{"16 lines of each", bench_Lines},
+		{"filled circle r 50", bench_Circle},
+	};
+	static const int rotations[] = {ROTATE_0, ROTATE_90};
+	int failures;
+	unsigned r, i;
+
+	srand(1);
+	paint_init(&bench_ref, BENCH_WIDTH, BENCH_HEIGHT);
+	paint_init(&bench_new, BENCH_WIDTH, BENCH_HEIGHT);
+
+	failures = bench_Check();
+	printf("check: %d shapes per rotation, %d mismatches\n\n", BENCH_SHAPES, failures);
+
+	printf("%-24s %6s %12s %12s %8s\n", "operation", "rotate", "per pixel", "spans", "speedup");
+	for (i = 0; i < sizeof(ops) / sizeof(ops[0]); i++) {
+		for (r = 0; r < sizeof(rotations) / sizeof(rotations[0]); r++) {
+			double legacy_ns, span_ns;
+
+			Paint_SetRotate(&bench_ref, rotations[r]);
+			legacy_ns = bench_Time(&bench_ref, ops[i].draw, 1);
+			span_ns = bench_Time(&bench_ref, ops[i].draw, 0);
+			printf("%-24s %6d %9.0f ns %9.0f ns %7.1fx\n", ops[i].name, rotations[r] * 90,
+					legacy_ns, span_ns, legacy_ns / span_ns);
+		}
+	}
+	return failures ? 1 : 0;
+}
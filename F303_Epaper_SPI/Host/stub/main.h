@@ -0,0 +1,72 @@
+/*
+ *  Host stand-in for the CubeMX main.h: just enough of HAL and CMSIS for the
+ *  e-paper driver to build on Linux. The SPI, GPIO and tick functions are
+ *  implemented by the controller model (epd_sim.c). CRC is left undefined,
+ *  so the driver hashes with its FNV-1a fallback.
+ */
+#ifndef __MAIN_H
+#define __MAIN_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+typedef enum {
+	HAL_OK       = 0x00U,
+	HAL_ERROR    = 0x01U,
+	HAL_BUSY     = 0x02U,
+	HAL_TIMEOUT  = 0x03U
+} HAL_StatusTypeDef;
+
+typedef struct {
+	uint32_t dummy;
+} GPIO_TypeDef;
+
+typedef enum {
+	GPIO_PIN_RESET = 0,
+	GPIO_PIN_SET
+} GPIO_PinState;
+
+typedef struct {
+	void* hdmatx;			/* Non NULL selects the DMA transfers of the driver */
+} SPI_HandleTypeDef;
+
+/* Backup registers of the RTC domain */
+typedef struct {
+	volatile uint32_t BKP0R;
+	volatile uint32_t BKP1R;
+	volatile uint32_t BKP2R;
+	volatile uint32_t BKP3R;
+} RTC_TypeDef;
+
+extern RTC_TypeDef sim_RTC;
+
+#define RTC							(&sim_RTC)
+
+#define __IO						volatile
+
+#define PWR_MAINREGULATOR_ON		0x00000000U
+#define PWR_LOWPOWERREGULATOR_ON	0x00000001U
+#define PWR_SLEEPENTRY_WFI			((uint8_t)0x01)
+#define PWR_STOPENTRY_WFI			((uint8_t)0x01)
+
+static inline void __WFI(void) {}
+static inline void __disable_irq(void) {}
+static inline void __enable_irq(void) {}
+
+void SystemClock_Config(void);
+
+uint32_t HAL_GetTick(void);
+void HAL_Delay(uint32_t Delay);
+
+void HAL_PWR_EnableBkUpAccess(void);
+void HAL_PWR_EnterSLEEPMode(uint32_t Regulator, uint8_t SLEEPEntry);
+void HAL_PWR_EnterSTOPMode(uint32_t Regulator, uint8_t STOPEntry);
+
+void HAL_GPIO_WritePin(GPIO_TypeDef* GPIOx, uint16_t GPIO_Pin, GPIO_PinState PinState);
+GPIO_PinState HAL_GPIO_ReadPin(GPIO_TypeDef* GPIOx, uint16_t GPIO_Pin);
+
+HAL_StatusTypeDef HAL_SPI_Transmit(SPI_HandleTypeDef *hspi, uint8_t *pData, uint16_t Size, uint32_t Timeout);
+HAL_StatusTypeDef HAL_SPI_Transmit_DMA(SPI_HandleTypeDef *hspi, uint8_t *pData, uint16_t Size);
+HAL_StatusTypeDef HAL_SPI_Abort(SPI_HandleTypeDef *hspi);
+
+#endif /* __MAIN_H */
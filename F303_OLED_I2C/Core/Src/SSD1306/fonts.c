@@ -312,23 +312,320 @@ const uint16_t Font16x26 [] = {
 0x0000,0x0000,0x0000,0x0000,0x0000,0x0000,0x0000,0x0000,0x0000,0x0000,0x0000,0x3F07,0x7FC7,0x73E7,0xF1FF,0xF07E,0x0000,0x0000,0x0000,0x0000,0x0000,0x0000,0x0000,0x0000,0x0000,0x0000, // Ascii = [~]
 };
 
+/* Glyphs transposed to columns, bit n of each word is row n of the column */
+const uint32_t Font7x10_Columns [] = {
+0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,  // sp
+0x00000000, 0x00000000, 0x00000000, 0x000000BF, 0x00000000, 0x00000000, 0x00000000,  // !
+0x00000000, 0x00000000, 0x00000007, 0x00000000, 0x00000007, 0x00000000, 0x00000000,  // "
+0x00000000, 0x000000F4, 0x0000002F, 0x00000024, 0x000000F4, 0x0000002F, 0x00000000,  // #
+0x00000000, 0x00000066, 0x00000089, 0x000001FF, 0x00000089, 0x00000072, 0x00000000,  // $
+0x00000000, 0x00000026, 0x00000019, 0x0000006E, 0x00000094, 0x00000062, 0x00000000,  // %
+0x00000000, 0x00000060, 0x00000096, 0x00000099, 0x00000066, 0x00000090, 0x00000000,  // &
+0x00000000, 0x00000000, 0x00000000, 0x00000007, 0x00000000, 0x00000000, 0x00000000,  // '
+0x00000000, 0x00000000, 0x000000FC, 0x00000102, 0x00000201, 0x00000000, 0x00000000,  // (
+0x00000000, 0x00000000, 0x00000201, 0x00000102, 0x000000FC, 0x00000000, 0x00000000,  // )
+0x00000000, 0x00000000, 0x0000000A, 0x00000007, 0x0000000A, 0x00000000, 0x00000000,  // *
+0x00000000, 0x00000010, 0x00000010, 0x0000007C, 0x00000010, 0x00000010, 0x00000000,  // +
+0x00000000, 0x00000000, 0x00000000, 0x00000380, 0x00000000, 0x00000000, 0x00000000,  // ,
+0x00000000, 0x00000000, 0x00000020, 0x00000020, 0x00000020, 0x00000000, 0x00000000,  // -
+0x00000000, 0x00000000, 0x00000000, 0x00000080, 0x00000000, 0x00000000, 0x00000000,  // .
+0x00000000, 0x00000000, 0x000000C0, 0x0000003C, 0x00000003, 0x00000000, 0x00000000,  // /
+0x00000000, 0x0000007E, 0x00000081, 0x00000089, 0x00000081, 0x0000007E, 0x00000000,  // 0
+0x00000000, 0x00000004, 0x00000002, 0x000000FF, 0x00000000, 0x00000000, 0x00000000,  // 1
+0x00000000, 0x00000086, 0x000000C1, 0x000000A1, 0x00000091, 0x0000008E, 0x00000000,  // 2
+0x00000000, 0x00000042, 0x00000081, 0x00000089, 0x00000089, 0x00000076, 0x00000000,  // 3
+0x00000000, 0x00000030, 0x0000002C, 0x00000022, 0x000000FF, 0x00000020, 0x00000000,  // 4
+0x00000000, 0x0000004F, 0x00000089, 0x00000089, 0x00000089, 0x00000071, 0x00000000,  // 5
+0x00000000, 0x0000007E, 0x00000089, 0x00000089, 0x00000089, 0x00000072, 0x00000000,  // 6
+0x00000000, 0x00000001, 0x000000E1, 0x00000019, 0x00000005, 0x00000003, 0x00000000,  // 7
+0x00000000, 0x00000076, 0x00000089, 0x00000089, 0x00000089, 0x00000076, 0x00000000,  // 8
+0x00000000, 0x0000004E, 0x00000091, 0x00000091, 0x00000091, 0x0000007E, 0x00000000,  // 9
+0x00000000, 0x00000000, 0x00000000, 0x00000084, 0x00000000, 0x00000000, 0x00000000,  // :
+0x00000000, 0x00000000, 0x00000000, 0x00000388, 0x00000000, 0x00000000, 0x00000000,  // ;
+0x00000000, 0x00000010, 0x00000028, 0x00000028, 0x00000044, 0x00000044, 0x00000000,  // <
+0x00000000, 0x00000028, 0x00000028, 0x00000028, 0x00000028, 0x00000028, 0x00000000,  // =
+0x00000000, 0x00000044, 0x00000044, 0x00000028, 0x00000028, 0x00000010, 0x00000000,  // >
+0x00000000, 0x00000002, 0x00000001, 0x000000B1, 0x00000009, 0x00000006, 0x00000000,  // ?
+0x00000000, 0x0000007E, 0x00000081, 0x00000099, 0x00000095, 0x0000001E, 0x00000000,  // @
+0x00000000, 0x000000E0, 0x0000003E, 0x00000021, 0x0000003E, 0x000000E0, 0x00000000,  // A
+0x00000000, 0x000000FF, 0x00000089, 0x00000089, 0x00000089, 0x00000076, 0x00000000,  // B
+0x00000000, 0x0000007E, 0x00000081, 0x00000081, 0x00000081, 0x00000042, 0x00000000,  // C
+0x00000000, 0x000000FF, 0x00000081, 0x00000081, 0x00000042, 0x0000003C, 0x00000000,  // D
+0x00000000, 0x000000FF, 0x00000089, 0x00000089, 0x00000089, 0x00000089, 0x00000000,  // E
+0x00000000, 0x000000FF, 0x00000009, 0x00000009, 0x00000009, 0x00000001, 0x00000000,  // F
+0x00000000, 0x0000007E, 0x00000081, 0x00000091, 0x00000091, 0x00000072, 0x00000000,  // G
+0x00000000, 0x000000FF, 0x00000008, 0x00000008, 0x00000008, 0x000000FF, 0x00000000,  // H
+0x00000000, 0x00000000, 0x00000081, 0x000000FF, 0x00000081, 0x00000000, 0x00000000,  // I
+0x00000000, 0x00000040, 0x00000080, 0x00000080, 0x00000080, 0x0000007F, 0x00000000,  // J
+0x00000000, 0x000000FF, 0x00000008, 0x00000014, 0x00000062, 0x00000081, 0x00000000,  // K
+0x00000000, 0x000000FF, 0x00000080, 0x00000080, 0x00000080, 0x00000080, 0x00000000,  // L
+0x00000000, 0x000000FF, 0x00000006, 0x00000008, 0x00000006, 0x000000FF, 0x00000000,  // M
+0x00000000, 0x000000FF, 0x00000006, 0x00000018, 0x00000060, 0x000000FF, 0x00000000,  // N
+0x00000000, 0x0000007E, 0x00000081, 0x00000081, 0x00000081, 0x0000007E, 0x00000000,  // O
+0x00000000, 0x000000FF, 0x00000011, 0x00000011, 0x00000011, 0x0000000E, 0x00000000,  // P
+0x00000000, 0x0000007E, 0x00000081, 0x000000C1, 0x00000081, 0x0000017E, 0x00000000,  // Q
+0x00000000, 0x000000FF, 0x00000011, 0x00000011, 0x00000071, 0x0000008E, 0x00000000,  // R
+0x00000000, 0x00000046, 0x00000089, 0x00000089, 0x00000091, 0x00000062, 0x00000000,  // S
+0x00000000, 0x00000001, 0x00000001, 0x000000FF, 0x00000001, 0x00000001, 0x00000000,  // T
+0x00000000, 0x0000007F, 0x00000080, 0x00000080, 0x00000080, 0x0000007F, 0x00000000,  // U
+0x00000000, 0x00000007, 0x00000038, 0x000000C0, 0x00000038, 0x00000007, 0x00000000,  // V
+0x00000000, 0x0000003F, 0x000000E0, 0x0000001C, 0x000000E0, 0x0000003F, 0x00000000,  // W
+0x00000000, 0x00000081, 0x00000066, 0x00000018, 0x00000066, 0x00000081, 0x00000000,  // X
+0x00000000, 0x00000003, 0x0000000C, 0x000000F0, 0x0000000C, 0x00000003, 0x00000000,  // Y
+0x00000000, 0x000000C1, 0x000000A1, 0x00000099, 0x00000085, 0x00000083, 0x00000000,  // Z
+0x00000000, 0x00000000, 0x00000000, 0x000003FF, 0x00000201, 0x00000000, 0x00000000,  // [
+0x00000000, 0x00000000, 0x00000003, 0x0000003C, 0x000000C0, 0x00000000, 0x00000000,  
+0x00000000, 0x00000000, 0x00000201, 0x000003FF, 0x00000000, 0x00000000, 0x00000000,  // ]
+0x00000000, 0x00000008, 0x00000006, 0x00000001, 0x00000006, 0x00000008, 0x00000000,  // ^
+0x00000200, 0x00000200, 0x00000200, 0x00000200, 0x00000200, 0x00000200, 0x00000200,  // _
+0x00000000, 0x00000000, 0x00000001, 0x00000002, 0x00000000, 0x00000000, 0x00000000,  // `
+0x00000000, 0x00000068, 0x00000094, 0x00000094, 0x00000054, 0x000000F8, 0x00000000,  // a
+0x00000000, 0x000000FF, 0x00000048, 0x00000084, 0x00000084, 0x00000078, 0x00000000,  // b
+0x00000000, 0x00000078, 0x00000084, 0x00000084, 0x00000084, 0x00000048, 0x00000000,  // c
+0x00000000, 0x00000078, 0x00000084, 0x00000084, 0x00000048, 0x000000FF, 0x00000000,  // d
+0x00000000, 0x00000078, 0x00000094, 0x00000094, 0x00000094, 0x00000058, 0x00000000,  // e
+0x00000000, 0x00000004, 0x00000004, 0x000000FE, 0x00000005, 0x00000005, 0x00000000,  // f
+0x00000000, 0x00000278, 0x00000284, 0x00000284, 0x00000248, 0x000001FC, 0x00000000,  // g
+0x00000000, 0x000000FF, 0x00000008, 0x00000004, 0x00000004, 0x000000F8, 0x00000000,  // h
+0x00000000, 0x00000004, 0x00000004, 0x000000FD, 0x00000000, 0x00000000, 0x00000000,  // i
+0x00000200, 0x00000204, 0x00000204, 0x000001FD, 0x00000000, 0x00000000, 0x00000000,  // j
+0x00000000, 0x000000FF, 0x00000010, 0x00000028, 0x00000044, 0x00000080, 0x00000000,  // k
+0x00000000, 0x00000001, 0x00000001, 0x000000FF, 0x00000000, 0x00000000, 0x00000000,  // l
+0x00000000, 0x000000FC, 0x00000004, 0x000000FC, 0x00000004, 0x000000F8, 0x00000000,  // m
+0x00000000, 0x000000FC, 0x00000008, 0x00000004, 0x00000004, 0x000000F8, 0x00000000,  // n
+0x00000000, 0x00000078, 0x00000084, 0x00000084, 0x00000084, 0x00000078, 0x00000000,  // o
+0x00000000, 0x000003FC, 0x00000048, 0x00000084, 0x00000084, 0x00000078, 0x00000000,  // p
+0x00000000, 0x00000078, 0x00000084, 0x00000084, 0x00000048, 0x000003FC, 0x00000000,  // q
+0x00000000, 0x000000FC, 0x00000008, 0x00000004, 0x00000004, 0x00000008, 0x00000000,  // r
+0x00000000, 0x00000048, 0x00000094, 0x00000094, 0x000000A4, 0x00000048, 0x00000000,  // s
+0x00000000, 0x00000004, 0x0000007F, 0x00000084, 0x00000084, 0x00000000, 0x00000000,  // t
+0x00000000, 0x0000007C, 0x00000080, 0x00000080, 0x00000040, 0x000000FC, 0x00000000,  // u
+0x00000000, 0x0000000C, 0x00000070, 0x00000080, 0x00000070, 0x0000000C, 0x00000000,  // v
+0x00000000, 0x0000003C, 0x000000E0, 0x0000001C, 0x000000E0, 0x0000003C, 0x00000000,  // w
+0x00000000, 0x00000084, 0x00000048, 0x00000030, 0x00000048, 0x00000084, 0x00000000,  // x
+0x00000000, 0x0000020C, 0x00000230, 0x000001C0, 0x00000030, 0x0000000C, 0x00000000,  // y
+0x00000000, 0x000000C4, 0x000000A4, 0x00000094, 0x0000008C, 0x00000084, 0x00000000,  // z
+0x00000000, 0x00000000, 0x00000030, 0x000003CF, 0x00000201, 0x00000000, 0x00000000,  // {
+0x00000000, 0x00000000, 0x00000000, 0x000003FF, 0x00000000, 0x00000000, 0x00000000,  // |
+0x00000000, 0x00000000, 0x00000201, 0x000003CF, 0x00000030, 0x00000000, 0x00000000,  // }
+0x00000000, 0x00000018, 0x00000008, 0x00000008, 0x00000010, 0x00000018, 0x00000000,  // ~
+};
+
+const uint32_t Font11x18_Columns [] = {
+0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,  // sp
+0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00006FFE, 0x00006FFE, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,  // !
+0x00000000, 0x00000000, 0x00000000, 0x0000003E, 0x0000003E, 0x00000000, 0x0000003E, 0x0000003E, 0x00000000, 0x00000000, 0x00000000,  // "
+0x00000000, 0x00000660, 0x00007F60, 0x00007FFE, 0x000006FE, 0x00000660, 0x00007F60, 0x00007FFE, 0x000006FE, 0x00000660, 0x00000000,  // #
+0x00000000, 0x00001C38, 0x00003C7C, 0x000070EE, 0x000060C6, 0x0001FFFE, 0x00006186, 0x00003F1C, 0x00001E18, 0x00000000, 0x00000000,  // $
+0x0000003C, 0x0000187E, 0x00000C42, 0x0000067E, 0x0000033C, 0x00003D80, 0x00007EC0, 0x00004260, 0x00007E30, 0x00003C18, 0x00000000,  // %
+0x00000000, 0x00001E00, 0x00003F3C, 0x0000617E, 0x000061C6, 0x000063C6, 0x0000367E, 0x00001C3C, 0x00007F00, 0x00002300, 0x00000000,  // &
+0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x0000003E, 0x0000003E, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,  // '
+0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000FC0, 0x00007FF8, 0x0000E01C, 0x00018006, 0x00020001, 0x00000000, 0x00000000,  // (
+0x00000000, 0x00000000, 0x00020001, 0x00018006, 0x0000E01C, 0x00007FF8, 0x00000FC0, 0x00000000, 0x00000000, 0x00000000, 0x00000000,  // )
+0x00000000, 0x00000000, 0x0000002C, 0x00000038, 0x0000001E, 0x0000001E, 0x00000038, 0x0000002C, 0x00000000, 0x00000000, 0x00000000,  // *
+0x00000180, 0x00000180, 0x00000180, 0x00000180, 0x00001FF8, 0x00001FF8, 0x00000180, 0x00000180, 0x00000180, 0x00000180, 0x00000000,  // +
+0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00026000, 0x0001E000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,  // ,
+0x00000000, 0x00000000, 0x00000000, 0x00000600, 0x00000600, 0x00000600, 0x00000600, 0x00000000, 0x00000000, 0x00000000, 0x00000000,  // -
+0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00006000, 0x00006000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,  // .
+0x00000000, 0x00000000, 0x00000000, 0x00007000, 0x00007F00, 0x00000FF0, 0x000000FE, 0x0000000E, 0x00000000, 0x00000000, 0x00000000,  // /
+0x00000000, 0x00000FF0, 0x00003FFC, 0x0000700E, 0x00006186, 0x00006186, 0x0000700E, 0x00003FFC, 0x00000FF0, 0x00000000, 0x00000000,  // 0
+0x00000000, 0x00000000, 0x00000030, 0x00000018, 0x0000000C, 0x00007FFE, 0x00007FFE, 0x00000000, 0x00000000, 0x00000000, 0x00000000,  // 1
+0x00000000, 0x00007038, 0x0000783C, 0x00006C0E, 0x00006606, 0x00006306, 0x0000618E, 0x000060FC, 0x00006078, 0x00000000, 0x00000000,  // 2
+0x00000000, 0x00001818, 0x0000381C, 0x00007006, 0x000060C6, 0x000060C6, 0x000071FC, 0x00003F38, 0x00001E00, 0x00000000, 0x00000000,  // 3
+0x00000000, 0x00000E00, 0x00000F80, 0x00000DF0, 0x00000C3C, 0x00007FFE, 0x00007FFE, 0x00000C00, 0x00000C00, 0x00000000, 0x00000000,  // 4
+0x00000000, 0x000019FE, 0x000039FE, 0x00007086, 0x000060C6, 0x000060C6, 0x000071C6, 0x00003F86, 0x00001F00, 0x00000000, 0x00000000,  // 5
+0x00000000, 0x00000FF0, 0x00003FFC, 0x0000718E, 0x000060C6, 0x000060C6, 0x000071CE, 0x00003F9C, 0x00001F18, 0x00000000, 0x00000000,  // 6
+0x00000000, 0x00000006, 0x00000006, 0x00007006, 0x00007F06, 0x000007C6, 0x000000F6, 0x0000003E, 0x0000000E, 0x00000000, 0x00000000,  // 7
+0x00000000, 0x00001E38, 0x00003F7C, 0x00006186, 0x00006186, 0x00006186, 0x0000618E, 0x00003F7C, 0x00001E38, 0x00000000, 0x00000000,  // 8
+0x00000000, 0x000018F8, 0x000039FC, 0x0000738E, 0x00006306, 0x00006306, 0x0000718E, 0x00003FFC, 0x00000FF0, 0x00000000, 0x00000000,  // 9
+0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00006060, 0x00006060, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,  // :
+0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x000260C0, 0x0001E0C0, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,  // ;
+0x00000000, 0x00000100, 0x00000380, 0x00000280, 0x000006C0, 0x00000440, 0x00000C60, 0x00000820, 0x00001830, 0x00000000, 0x00000000,  // <
+0x00000000, 0x00000660, 0x00000660, 0x00000660, 0x00000660, 0x00000660, 0x00000660, 0x00000660, 0x00000660, 0x00000000, 0x00000000,  // =
+0x00000000, 0x00001830, 0x00000820, 0x00000C60, 0x00000440, 0x000006C0, 0x00000280, 0x00000380, 0x00000100, 0x00000000, 0x00000000,  // >
+0x00000000, 0x00000018, 0x0000001C, 0x0000000E, 0x00006E06, 0x00006F06, 0x00000386, 0x000001CE, 0x000000FC, 0x00000078, 0x00000000,  // ?
+0x00000000, 0x00000FF0, 0x00003FFC, 0x0000701E, 0x000063C6, 0x000067C6, 0x00003666, 0x000007FC, 0x000007F8, 0x00000000, 0x00000000,  // @
+0x00000000, 0x00007000, 0x00007F80, 0x00000FF8, 0x0000067E, 0x00000606, 0x0000067E, 0x00000FF8, 0x00007F80, 0x00007000, 0x00000000,  // A
+0x00000000, 0x00007FFE, 0x00007FFE, 0x00006186, 0x00006186, 0x00006186, 0x000073FC, 0x00003E78, 0x00001C00, 0x00000000, 0x00000000,  // B
+0x00000000, 0x00000FF0, 0x00003FFC, 0x0000700E, 0x00006006, 0x00006006, 0x00006006, 0x0000381C, 0x00001818, 0x00000000, 0x00000000,  // C
+0x00000000, 0x00007FFE, 0x00007FFE, 0x00006006, 0x00006006, 0x00006006, 0x0000381C, 0x00001FFC, 0x000007F0, 0x00000000, 0x00000000,  // D
+0x00000000, 0x00007FFE, 0x00007FFE, 0x00006186, 0x00006186, 0x00006186, 0x00006186, 0x00006186, 0x00006006, 0x00000000, 0x00000000,  // E
+0x00000000, 0x00007FFE, 0x00007FFE, 0x00000186, 0x00000186, 0x00000186, 0x00000186, 0x00000186, 0x00000006, 0x00000000, 0x00000000,  // F
+0x00000000, 0x00000FF0, 0x00003FFC, 0x0000700E, 0x00006006, 0x00006006, 0x00006306, 0x00003F1C, 0x00003F18, 0x00000000, 0x00000000,  // G
+0x00000000, 0x00007FFE, 0x00007FFE, 0x00000180, 0x00000180, 0x00000180, 0x00000180, 0x00007FFE, 0x00007FFE, 0x00000000, 0x00000000,  // H
+0x00000000, 0x00000000, 0x00006006, 0x00006006, 0x00007FFE, 0x00007FFE, 0x00006006, 0x00006006, 0x00000000, 0x00000000, 0x00000000,  // I
+0x00000000, 0x00001C00, 0x00003C00, 0x00007000, 0x00006000, 0x00006000, 0x00007000, 0x00003FFE, 0x00001FFE, 0x00000000, 0x00000000,  // J
+0x00000000, 0x00007FFE, 0x00007FFE, 0x00000180, 0x000001C0, 0x00000770, 0x00000E38, 0x0000380C, 0x00007006, 0x00004002, 0x00000000,  // K
+0x00000000, 0x00007FFE, 0x00007FFE, 0x00006000, 0x00006000, 0x00006000, 0x00006000, 0x00006000, 0x00006000, 0x00000000, 0x00000000,  // L
+0x00000000, 0x00007FFE, 0x00007FFE, 0x0000001E, 0x000000F8, 0x00000180, 0x000000F8, 0x0000000E, 0x00007FFE, 0x00007FFE, 0x00000000,  // M
+0x00000000, 0x00007FFE, 0x00007FFE, 0x0000003E, 0x000001F8, 0x00001FC0, 0x00007C00, 0x00007FFE, 0x00007FFE, 0x00000000, 0x00000000,  // N
+0x00000000, 0x00000FF0, 0x00003FFC, 0x0000700E, 0x00006006, 0x00006006, 0x0000700E, 0x00003FFC, 0x00000FF0, 0x00000000, 0x00000000,  // O
+0x00000000, 0x00007FFE, 0x00007FFE, 0x00000306, 0x00000306, 0x00000306, 0x0000038E, 0x000001FC, 0x000000F8, 0x00000000, 0x00000000,  // P
+0x00000000, 0x00000FF0, 0x00003FFC, 0x0000700E, 0x00006006, 0x00006C06, 0x0000780E, 0x00003FFC, 0x00002FF0, 0x00004000, 0x00000000,  // Q
+0x00000000, 0x00007FFE, 0x00007FFE, 0x00000186, 0x00000186, 0x00000386, 0x00000FCE, 0x00003CFC, 0x00007078, 0x00004000, 0x00000000,  // R
+0x00000000, 0x00000C00, 0x00003C78, 0x000070FC, 0x000060C6, 0x00006186, 0x00006386, 0x00003F1C, 0x00001E18, 0x00000000, 0x00000000,  // S
+0x00000006, 0x00000006, 0x00000006, 0x00000006, 0x00007FFE, 0x00007FFE, 0x00000006, 0x00000006, 0x00000006, 0x00000006, 0x00000000,  // T
+0x00000000, 0x00001FFE, 0x00003FFE, 0x00007000, 0x00006000, 0x00006000, 0x00007000, 0x00003FFE, 0x00001FFE, 0x00000000, 0x00000000,  // U
+0x00000000, 0x0000000E, 0x0000007E, 0x000007F0, 0x00003F80, 0x00007800, 0x00003F80, 0x000007F0, 0x0000007E, 0x0000000E, 0x00000000,  // V
+0x0000007E, 0x00007FFE, 0x00007000, 0x00001E00, 0x000003C0, 0x000003C0, 0x00001E00, 0x00007000, 0x00007FFE, 0x0000007E, 0x00000000,  // W
+0x00004002, 0x0000700E, 0x0000383C, 0x00001E70, 0x00000FE0, 0x000007C0, 0x00000E70, 0x00003C38, 0x0000700E, 0x00004002, 0x00000000,  // X
+0x00000002, 0x0000000E, 0x0000003C, 0x000000F0, 0x00007FC0, 0x00007FC0, 0x000000F0, 0x0000003C, 0x0000000E, 0x00000002, 0x00000000,  // Y
+0x00000000, 0x00007000, 0x00007806, 0x00006E06, 0x00006786, 0x000061C6, 0x00006076, 0x0000603E, 0x0000600E, 0x00000000, 0x00000000,  // Z
+0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x0003FFFF, 0x0003FFFF, 0x00030003, 0x00030003, 0x00000000, 0x00000000, 0x00000000,  // [
+0x00000000, 0x00000000, 0x00000000, 0x0000000E, 0x000000FE, 0x00000FF0, 0x00007F00, 0x00007000, 0x00000000, 0x00000000, 0x00000000,  
+0x00000000, 0x00000000, 0x00000000, 0x00030003, 0x00030003, 0x0003FFFF, 0x0003FFFF, 0x00000000, 0x00000000, 0x00000000, 0x00000000,  // ]
+0x00000000, 0x00000180, 0x000001E0, 0x00000078, 0x0000000E, 0x0000000E, 0x00000078, 0x000001E0, 0x00000180, 0x00000000, 0x00000000,  // ^
+0x00010000, 0x00010000, 0x00010000, 0x00010000, 0x00010000, 0x00010000, 0x00010000, 0x00010000, 0x00010000, 0x00010000, 0x00010000,  // _
+0x00000000, 0x00000000, 0x00000002, 0x00000006, 0x0000000E, 0x00000008, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,  // `
+0x00000000, 0x00003880, 0x00007CC0, 0x00006660, 0x00006660, 0x00002660, 0x00003660, 0x00003FE0, 0x00007FC0, 0x00004000, 0x00000000,  // a
+0x00000000, 0x00007FFE, 0x00007FFE, 0x000030C0, 0x00006060, 0x00006060, 0x000070E0, 0x00003FC0, 0x00001F80, 0x00000000, 0x00000000,  // b
+0x00000000, 0x00001F80, 0x00003FC0, 0x000070E0, 0x00006060, 0x00006060, 0x000070E0, 0x000039C0, 0x00001980, 0x00000000, 0x00000000,  // c
+0x00000000, 0x00001F80, 0x00003FC0, 0x000070E0, 0x00006060, 0x00006060, 0x000030C0, 0x00007FFE, 0x00007FFE, 0x00000000, 0x00000000,  // d
+0x00000000, 0x00001F80, 0x00003FC0, 0x000076E0, 0x00006660, 0x00006660, 0x000066E0, 0x000037C0, 0x00001700, 0x00000000, 0x00000000,  // e
+0x00000000, 0x00000060, 0x00000060, 0x00000060, 0x00007FFC, 0x00007FFE, 0x00000066, 0x00000066, 0x00000066, 0x00000006, 0x00000000,  // f
+0x00000000, 0x00018FC0, 0x00039FE0, 0x00033870, 0x00033030, 0x00033030, 0x00039860, 0x0001FFF0, 0x0000FFF0, 0x00000000, 0x00000000,  // g
+0x00000000, 0x00007FFE, 0x00007FFE, 0x000000C0, 0x00000060, 0x00000060, 0x00000060, 0x00007FE0, 0x00007FC0, 0x00000000, 0x00000000,  // h
+0x00000000, 0x00000000, 0x00000060, 0x00000060, 0x00000060, 0x00007FE6, 0x00007FE6, 0x00000000, 0x00000000, 0x00000000, 0x00000000,  // i
+0x00000000, 0x00018000, 0x00030030, 0x00030030, 0x00030030, 0x0003FFF3, 0x0001FFF3, 0x00000000, 0x00000000, 0x00000000, 0x00000000,  // j
+0x00000000, 0x00007FFE, 0x00007FFE, 0x00000600, 0x00000300, 0x00000780, 0x00001CC0, 0x00003860, 0x00006020, 0x00004000, 0x00000000,  // k
+0x00000000, 0x00000000, 0x00000006, 0x00000006, 0x00000006, 0x00007FFE, 0x00007FFE, 0x00000000, 0x00000000, 0x00000000, 0x00000000,  // l
+0x00007FE0, 0x00007FE0, 0x00000040, 0x00000060, 0x00007FE0, 0x00007FE0, 0x000000C0, 0x00000060, 0x00007FE0, 0x00007FC0, 0x00000000,  // m
+0x00000000, 0x00007FE0, 0x00007FE0, 0x000000C0, 0x00000060, 0x00000060, 0x00000060, 0x00007FE0, 0x00007FC0, 0x00000000, 0x00000000,  // n
+0x00000000, 0x00001F80, 0x00003FC0, 0x000070E0, 0x00006060, 0x00006060, 0x000070E0, 0x00003FC0, 0x00001F80, 0x00000000, 0x00000000,  // o
+0x00000000, 0x0003FFF0, 0x0003FFF0, 0x00001860, 0x00003030, 0x00003030, 0x00003870, 0x00001FE0, 0x00000FC0, 0x00000000, 0x00000000,  // p
+0x00000000, 0x00000FC0, 0x00001FE0, 0x00003870, 0x00003030, 0x00003030, 0x00001860, 0x0003FFF0, 0x0003FFF0, 0x00000000, 0x00000000,  // q
+0x00000000, 0x00000020, 0x00007FE0, 0x00007FC0, 0x000000C0, 0x00000060, 0x00000060, 0x000000E0, 0x00000040, 0x00000000, 0x00000000,  // r
+0x00000000, 0x00003380, 0x000037C0, 0x00006660, 0x00006660, 0x00006660, 0x00006660, 0x00003EC0, 0x00001CC0, 0x00000000, 0x00000000,  // s
+0x00000000, 0x00000060, 0x00000060, 0x00003FF8, 0x00007FFC, 0x00006060, 0x00006060, 0x00006060, 0x00006000, 0x00000000, 0x00000000,  // t
+0x00000000, 0x00003FE0, 0x00007FE0, 0x00006000, 0x00006000, 0x00006000, 0x00003000, 0x00007FE0, 0x00007FE0, 0x00000000, 0x00000000,  // u
+0x00000000, 0x00000020, 0x000001E0, 0x00000FC0, 0x00003E00, 0x00007000, 0x00007E00, 0x00000FC0, 0x000001E0, 0x00000020, 0x00000000,  // v
+0x000000E0, 0x00001FE0, 0x00007800, 0x00001FE0, 0x000000E0, 0x00001FE0, 0x00007800, 0x00001FE0, 0x000000E0, 0x00000000, 0x00000000,  // w
+0x00000000, 0x00004020, 0x000070E0, 0x000039C0, 0x00000F00, 0x00000F00, 0x000039C0, 0x000070E0, 0x00004020, 0x00000000, 0x00000000,  // x
+0x00000000, 0x00030030, 0x000301F0, 0x00038FC0, 0x0001FE00, 0x0001F000, 0x00007F80, 0x00000FF0, 0x00000070, 0x00000000, 0x00000000,  // y
+0x00000000, 0x00006060, 0x00007060, 0x00007860, 0x00006C60, 0x00006660, 0x00006360, 0x000061E0, 0x000060E0, 0x00006060, 0x00000000,  // z
+0x00000000, 0x00000000, 0x00000000, 0x00000300, 0x00000780, 0x0001FFFE, 0x0003FCFF, 0x00030003, 0x00030003, 0x00000000, 0x00000000,  // {
+0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x0003FFFF, 0x0003FFFF, 0x00000000, 0x00000000, 0x00000000, 0x00000000,  // |
+0x00000000, 0x00000000, 0x00030003, 0x00030003, 0x0003FCFF, 0x0001FFFE, 0x00000780, 0x00000300, 0x00000000, 0x00000000, 0x00000000,  // }
+0x00000000, 0x00000300, 0x00000180, 0x00000180, 0x00000180, 0x00000300, 0x00000300, 0x00000300, 0x00000180, 0x00000000, 0x00000000,  // ~
+};
+
+const uint32_t Font16x26_Columns [] = {
+0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,  // Ascii = [ ]
+0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x001C03FF, 0x001C7FFF, 0x001C7FFF, 0x001C7FFF, 0x001C00FF, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,  // Ascii = [!]
+0x00000000, 0x00000000, 0x00000000, 0x0000007F, 0x0000007F, 0x0000007F, 0x0000007F, 0x00000000, 0x00000000, 0x00000000, 0x0000007F, 0x0000007F, 0x0000007F, 0x0000007F, 0x00000000, 0x00000000,  // Ascii = ["]
+0x00006000, 0x00006080, 0x001C60C0, 0x001FE0C0, 0x001FFEC0, 0x000FFFE0, 0x0000FFFE, 0x00186FFF, 0x001FE0FF, 0x001FFCC7, 0x001FFFC0, 0x0001FFFC, 0x00007FFF, 0x000060FF, 0x000060CF, 0x000060C0,  // Ascii = [#]
+0x00000000, 0x00000000, 0x000C0000, 0x000C00FC, 0x001C01FE, 0x001C03FE, 0x001807FF, 0x007FFF87, 0x007FFFFF, 0x007FFFFF, 0x007FFFFF, 0x001FFC03, 0x000FF807, 0x000FF807, 0x0007F006, 0x00000000,  // Ascii = [$]
+0x001801FE, 0x001C01FE, 0x001F03FF, 0x000F8303, 0x0007C201, 0x0001F3CF, 0x0000FBFF, 0x00007FFE, 0x0007FFFC, 0x000FFF80, 0x001FFBE0, 0x001FF9F0, 0x001818FC, 0x0018183E, 0x001FF81F, 0x001FF807,  // Ascii = [%]
+0x0003F800, 0x0007FC00, 0x000FFC00, 0x001FFE38, 0x001E0FFE, 0x001C07FF, 0x00181FFF, 0x00183FFF, 0x0018FF83, 0x001DFDFF, 0x001FF1FF, 0x000FE0FE, 0x001F807E, 0x001FF000, 0x001FFC00, 0x001DFC00,  // Ascii = [&]
+0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x0000003F, 0x0000007F, 0x0000007F, 0x0000007F, 0x0000001F, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,  // Ascii = [']
+0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x0000FF00, 0x0007FFE0, 0x000FFFF0, 0x003FFFFC, 0x003F81FC, 0x007C003E, 0x00F0000F, 0x00E00007, 0x01C00003, 0x01C00003, 0x01800001, 0x01800001,  // Ascii = [(]
+0x00000000, 0x01800001, 0x01800001, 0x01C00003, 0x01C00003, 0x00E00007, 0x00F0000F, 0x007C003E, 0x003F81FC, 0x003FFFFC, 0x000FFFF0, 0x0007FFE0, 0x0000FF00, 0x00000000, 0x00000000, 0x00000000,  // Ascii = [)]
+0x00000000, 0x00000000, 0x00000038, 0x00000438, 0x00000638, 0x00000F30, 0x00000FF3, 0x000007FF, 0x0000011F, 0x000003BF, 0x00000FF1, 0x00000FB0, 0x00000F38, 0x00000438, 0x00000038, 0x00000030,  // Ascii = [*]
+0x00006000, 0x00006000, 0x00006000, 0x00006000, 0x00006000, 0x00006000, 0x00006000, 0x001FFFC0, 0x001FFFC0, 0x001FFFC0, 0x00006000, 0x00006000, 0x00006000, 0x00006000, 0x00006000, 0x00006000,  // Ascii = [+]
+0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x021E0000, 0x03FE0000, 0x03FE0000, 0x01FE0000, 0x00FE0000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,  // Ascii = [,]
+0x00000000, 0x00000000, 0x00001800, 0x00001800, 0x00001800, 0x00001800, 0x00001800, 0x00001800, 0x00001800, 0x00001800, 0x00001800, 0x00001800, 0x00001800, 0x00001800, 0x00001800, 0x00000000,  // Ascii = [-]
+0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x001E0000, 0x001E0000, 0x001E0000, 0x001E0000, 0x001E0000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,  // Ascii = [.]
+0x01000000, 0x01C00000, 0x01F00000, 0x01FC0000, 0x00FF0000, 0x003FC000, 0x000FF000, 0x0003FC00, 0x0000FF00, 0x00003FC0, 0x00000FF0, 0x000003FC, 0x000000FF, 0x0000003F, 0x0000000F, 0x00000003,  // Ascii = [/]
+0x00000000, 0x0000FFE0, 0x0003FFF8, 0x0007FFFC, 0x000FFFFE, 0x001FC07F, 0x001E000F, 0x001C0007, 0x00180003, 0x001C0007, 0x001E000F, 0x001FC07F, 0x000FFFFE, 0x0007FFFC, 0x0003FFF8, 0x0000FFE0,  // Ascii = [0]
+0x00000000, 0x00000000, 0x0018000C, 0x0018000C, 0x0018000C, 0x0018000E, 0x0018000E, 0x001FFFFE, 0x001FFFFF, 0x001FFFFF, 0x001FFFFF, 0x001FFFFF, 0x00180000, 0x00180000, 0x00180000, 0x00180000,  // Ascii = [1]
+0x00000000, 0x00000000, 0x001E0006, 0x001F0006, 0x001F8007, 0x001FE007, 0x001BF003, 0x0018F803, 0x00187C03, 0x00183E07, 0x00181FFF, 0x00180FFE, 0x001807FE, 0x001803FC, 0x00180070, 0x00000000,  // Ascii = [2]
+0x00000000, 0x00000000, 0x00000000, 0x001C0006, 0x001C0607, 0x001C0607, 0x00180603, 0x00180603, 0x00180703, 0x001C0F07, 0x001E1FFF, 0x000FFFFF, 0x000FFDFE, 0x0007F8FC, 0x0003F038, 0x00000000,  // Ascii = [3]
+0x00006000, 0x00007800, 0x00007C00, 0x00007F00, 0x00007F80, 0x000067E0, 0x000063F0, 0x000060F8, 0x0000607E, 0x001FFFFF, 0x001FFFFF, 0x001FFFFF, 0x001FFFFF, 0x00006000, 0x00006000, 0x00006000,  // Ascii = [4]
+0x00000000, 0x00000000, 0x00000000, 0x001C03FF, 0x001C03FF, 0x001C03FF, 0x001803FF, 0x00180307, 0x00180707, 0x001C0F07, 0x001FBF07, 0x000FFE07, 0x000FFE07, 0x0007FC07, 0x0001F000, 0x00000000,  // Ascii = [5]
+0x00000000, 0x00000C00, 0x0001FFE0, 0x0007FFF8, 0x000FFFFC, 0x000FFFFE, 0x001F0E3E, 0x001C070F, 0x00180307, 0x00180303, 0x001C0703, 0x001E0F03, 0x000FFF07, 0x000FFE07, 0x0007FC06, 0x0003F800,  // Ascii = [6]
+0x00000000, 0x00000000, 0x00000007, 0x00180007, 0x001F0007, 0x001F8007, 0x001FE007, 0x001FF807, 0x0003FE07, 0x00007F07, 0x00001FC7, 0x000007F7, 0x000001FF, 0x0000007F, 0x0000003F, 0x0000000F,  // Ascii = [7]
+0x00000000, 0x0001C000, 0x0007F030, 0x000FF8FC, 0x000FFDFE, 0x001FFFFF, 0x001C1FFF, 0x001C0787, 0x00180F03, 0x00180F03, 0x001C1F87, 0x001E7FFF, 0x000FFDFF, 0x000FF8FE, 0x0007F07C, 0x0003E000,  // Ascii = [8]
+0x00000000, 0x000001E0, 0x000C07F8, 0x001C0FFC, 0x001C0FFE, 0x00181FFF, 0x00181C07, 0x00181803, 0x001C1803, 0x001C1807, 0x001F1C0F, 0x000FEFFF, 0x0007FFFE, 0x0003FFFC, 0x0001FFF8, 0x00003FE0,  // Ascii = [9]
+0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x001E03C0, 0x001E03C0, 0x001E03C0, 0x001E03C0, 0x001E03C0, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,  // Ascii = [:]
+0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x031E03C0, 0x03FE03C0, 0x03FE03C0, 0x01FE03C0, 0x00FE03C0, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,  // Ascii = [;]
+0x00002000, 0x00002000, 0x00007000, 0x00007000, 0x0000F800, 0x0000F800, 0x0001FC00, 0x0001DC00, 0x00038E00, 0x00038E00, 0x00070700, 0x00070700, 0x000E0380, 0x000E0380, 0x001C01C0, 0x001C01C0,  // Ascii = [<]
+0x00018C00, 0x00018C00, 0x00018C00, 0x00018C00, 0x00018C00, 0x00018C00, 0x00018C00, 0x00018C00, 0x00018C00, 0x00018C00, 0x00018C00, 0x00018C00, 0x00018C00, 0x00018C00, 0x00018C00, 0x00018C00,  // Ascii = [=]
+0x001800C0, 0x001C01C0, 0x001C01C0, 0x000E0380, 0x000E0380, 0x00070700, 0x00070700, 0x00038E00, 0x00038E00, 0x0001DC00, 0x0001DC00, 0x0000F800, 0x0000F800, 0x00007000, 0x00007000, 0x00002000,  // Ascii = [>]
+0x00000000, 0x00000000, 0x0000001E, 0x0000001F, 0x0000001F, 0x001C6003, 0x001C7803, 0x001C7C03, 0x001C7E03, 0x001C7F03, 0x00000787, 0x000003FF, 0x000001FE, 0x000000FE, 0x0000007C, 0x00000018,  // Ascii = [?]
+0x00003F00, 0x0001FFE0, 0x0003FFF8, 0x0007FFFC, 0x000F807E, 0x000E001E, 0x001CFF8F, 0x001DFFC7, 0x0019FFE3, 0x0019C1F3, 0x0019C073, 0x001DF037, 0x001CFE7F, 0x000DFFFE, 0x0001FFFE, 0x0001FFF8,  // Ascii = [@]
+0x001C0000, 0x001F0000, 0x001FE000, 0x001FF800, 0x0003FF00, 0x0000FFE0, 0x0000DFF8, 0x0000C3F8, 0x0000C0F8, 0x0000C7F8, 0x0000FFF8, 0x0001FFE0, 0x0007FF00, 0x001FFC00, 0x001FE000, 0x001F8000,  // Ascii = [A]
+0x00000000, 0x00000000, 0x001FFFF8, 0x001FFFF8, 0x001FFFF8, 0x001FFFF8, 0x00181818, 0x00181818, 0x00181818, 0x00183C18, 0x00183E38, 0x001CFFF8, 0x001FF7F8, 0x000FE7F0, 0x000FE3E0, 0x0007C000,  // Ascii = [B]
+0x00000000, 0x0000FF00, 0x0003FFC0, 0x0007FFE0, 0x0007FFE0, 0x000FC1F0, 0x000F0070, 0x001E0038, 0x001C0038, 0x00180018, 0x00180018, 0x00180018, 0x00180018, 0x00180038, 0x001C0038, 0x001C0038,  // Ascii = [C]
+0x00000000, 0x001FFFF8, 0x001FFFF8, 0x001FFFF8, 0x001FFFF8, 0x00180018, 0x00180018, 0x00180018, 0x00180018, 0x001C0038, 0x001C0038, 0x000F00F8, 0x000FFFF0, 0x0007FFF0, 0x0007FFE0, 0x0001FFC0,  // Ascii = [D]
+0x00000000, 0x00000000, 0x001FFFF8, 0x001FFFF8, 0x001FFFF8, 0x001FFFF8, 0x001FFFF8, 0x00181818, 0x00181818, 0x00181818, 0x00181818, 0x00181818, 0x00181818, 0x00181818, 0x00181818, 0x00180018,  // Ascii = [E]
+0x00000000, 0x00000000, 0x00000000, 0x001FFFF8, 0x001FFFF8, 0x001FFFF8, 0x001FFFF8, 0x00001818, 0x00001818, 0x00001818, 0x00001818, 0x00001818, 0x00001818, 0x00001818, 0x00001818, 0x00001818,  // Ascii = [F]
+0x00003C00, 0x0001FF80, 0x0003FFC0, 0x0007FFE0, 0x000FFFF0, 0x000F81F0, 0x001E0078, 0x001C0038, 0x001C0038, 0x00183018, 0x00183018, 0x00183018, 0x001FF018, 0x001FF038, 0x001FF038, 0x000FF030,  // Ascii = [G]
+0x00000000, 0x001FFFF8, 0x001FFFF8, 0x001FFFF8, 0x001FFFF8, 0x001FFFF8, 0x00001800, 0x00001800, 0x00001800, 0x00001800, 0x00001800, 0x001FFFF8, 0x001FFFF8, 0x001FFFF8, 0x001FFFF8, 0x001FFFF8,  // Ascii = [H]
+0x00000000, 0x00000000, 0x00180018, 0x00180018, 0x00180018, 0x00180018, 0x001FFFF8, 0x001FFFF8, 0x001FFFF8, 0x001FFFF8, 0x001FFFF8, 0x00180018, 0x00180018, 0x00180018, 0x00180018, 0x00180018,  // Ascii = [I]
+0x00000000, 0x00000000, 0x001C0000, 0x001C0018, 0x001C0018, 0x00180018, 0x00180018, 0x00180018, 0x001C0018, 0x001FFFF8, 0x000FFFF8, 0x000FFFF8, 0x0007FFF8, 0x0000FFF8, 0x00000000, 0x00000000,  // Ascii = [J]
+0x00000000, 0x00000000, 0x001FFFF8, 0x001FFFF8, 0x001FFFF8, 0x001FFFF8, 0x00003E00, 0x00007F00, 0x0000FF80, 0x0003F7C0, 0x0007E3E0, 0x000FC0F8, 0x001F0078, 0x001E0038, 0x001C0018, 0x00180008,  // Ascii = [K]
+0x00000000, 0x00000000, 0x001FFFF8, 0x001FFFF8, 0x001FFFF8, 0x001FFFF8, 0x001FFFF8, 0x00180000, 0x00180000, 0x00180000, 0x00180000, 0x00180000, 0x00180000, 0x00180000, 0x00180000, 0x00180000,  // Ascii = [L]
+0x001FFFF8, 0x001FFFF8, 0x001FFFF8, 0x001FFFF8, 0x00000FF8, 0x00003FF0, 0x0001FFC0, 0x0001FE00, 0x0001F000, 0x0001FE00, 0x0000FFC0, 0x00001FF8, 0x000003F8, 0x001FFFF8, 0x001FFFF8, 0x001FFFF8,  // Ascii = [M]
+0x00000000, 0x001FFFF8, 0x001FFFF8, 0x001FFFF8, 0x001FFFF8, 0x000007F8, 0x00000FE0, 0x00003FC0, 0x0000FF00, 0x0001FC00, 0x0007F800, 0x001FE000, 0x001FFFF8, 0x001FFFF8, 0x001FFFF8, 0x001FFFF8,  // Ascii = [N]
+0x00007E00, 0x0003FFC0, 0x0007FFE0, 0x000FFFF0, 0x000FFFF0, 0x001E0078, 0x001C0038, 0x00180018, 0x00180018, 0x00180018, 0x001C0038, 0x001E0078, 0x000FFFF0, 0x000FFFF0, 0x0007FFE0, 0x0003FFC0,  // Ascii = [O]
+0x00000000, 0x00000000, 0x001FFFF8, 0x001FFFF8, 0x001FFFF8, 0x001FFFF8, 0x001FFFF8, 0x00003018, 0x00003018, 0x00003018, 0x00003818, 0x00003C38, 0x00001FF8, 0x00001FF8, 0x00000FF0, 0x00000FF0,  // Ascii = [P]
+0x00007E00, 0x0003FFC0, 0x0007FFE0, 0x000FFFF0, 0x000FFFF0, 0x001E0078, 0x001C0038, 0x00180018, 0x00180018, 0x00380018, 0x007C0038, 0x007E0078, 0x00FFFFF0, 0x00EFFFF0, 0x01C7FFE0, 0x01C3FFC0,  // Ascii = [Q]
+0x00000000, 0x00000000, 0x001FFFF8, 0x001FFFF8, 0x001FFFF8, 0x001FFFF8, 0x00003018, 0x00007018, 0x0000F818, 0x0001F838, 0x0003FE78, 0x000FDFF8, 0x001F8FF0, 0x001F0FF0, 0x001E03E0, 0x00180000,  // Ascii = [R]
+0x00000000, 0x00000000, 0x000E03E0, 0x001C07F0, 0x001C0FF0, 0x001C0FF8, 0x00181E38, 0x00181C18, 0x00181C18, 0x00183C18, 0x001C3818, 0x001E7818, 0x000FF838, 0x000FF038, 0x0007F030, 0x0003E000,  // Ascii = [S]
+0x00000018, 0x00000018, 0x00000018, 0x00000018, 0x00000018, 0x00000018, 0x001FFFF8, 0x001FFFF8, 0x001FFFF8, 0x001FFFF8, 0x001FFFF8, 0x00000018, 0x00000018, 0x00000018, 0x00000018, 0x00000018,  // Ascii = [T]
+0x00000000, 0x0000FFF8, 0x0007FFF8, 0x000FFFF8, 0x000FFFF8, 0x001FFFF8, 0x001C0000, 0x00180000, 0x00180000, 0x00180000, 0x001C0000, 0x001F0000, 0x000FFFF8, 0x000FFFF8, 0x0007FFF8, 0x0000FFF8,  // Ascii = [U]
+0x00000038, 0x000000F8, 0x000007F8, 0x00003FF8, 0x0000FFE0, 0x0007FF80, 0x001FFC00, 0x001FF000, 0x001F8000, 0x001FE000, 0x001FF800, 0x0007FF00, 0x0000FFC0, 0x00001FF8, 0x000007F8, 0x000000F8,  // Ascii = [V]
+0x000003F8, 0x0001FFF8, 0x001FFFF8, 0x001FFFF0, 0x001FF800, 0x001FF000, 0x001FFF80, 0x0003FF80, 0x00003F80, 0x0003FF80, 0x001FFF80, 0x001FF800, 0x001FE000, 0x001FFFC0, 0x001FFFF8, 0x0000FFF8,  // Ascii = [W]
+0x00100008, 0x001C0018, 0x001E0078, 0x001F00F8, 0x000FC1F8, 0x0003E7F0, 0x0001FFE0, 0x0000FF80, 0x00007F00, 0x0001FF00, 0x0003FFC0, 0x0007E3E0, 0x001FC1F0, 0x001F80F8, 0x001E0078, 0x001C0018,  // Ascii = [X]
+0x00000008, 0x00000038, 0x000000F8, 0x000001F8, 0x000007F8, 0x00000FE0, 0x001FFF80, 0x001FFF00, 0x001FFC00, 0x001FFE00, 0x001FFF00, 0x00000FC0, 0x000007E0, 0x000001F8, 0x000000F8, 0x00000038,  // Ascii = [Y]
+0x00000000, 0x001C0018, 0x001E0018, 0x001F0018, 0x001FC018, 0x001FE018, 0x001BF018, 0x0018F818, 0x00187E18, 0x00183F18, 0x00181F98, 0x001807D8, 0x001803F8, 0x001801F8, 0x001800F8, 0x00180078,  // Ascii = [Z]
+0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x01FFFFFF, 0x01FFFFFF, 0x01FFFFFF, 0x01FFFFFF, 0x01800001, 0x01800001, 0x01800001, 0x01800001, 0x01800001, 0x01800001, 0x01800001,  // Ascii = [[]
+0x00000000, 0x00000003, 0x0000000F, 0x0000003F, 0x000000FF, 0x000003FC, 0x00000FF0, 0x00003FC0, 0x0000FF00, 0x0003FC00, 0x000FF000, 0x003FC000, 0x00FF0000, 0x01FC0000, 0x01F00000, 0x01C00000,  // Ascii = [\]
+0x00000000, 0x01800001, 0x01800001, 0x01800001, 0x01800001, 0x01800001, 0x01800001, 0x01800001, 0x01FFFFFF, 0x01FFFFFF, 0x01FFFFFF, 0x01FFFFFF, 0x00000000, 0x00000000, 0x00000000, 0x00000000,  // Ascii = []]
+0x00000000, 0x00018000, 0x0001F000, 0x0001FC00, 0x0001FF00, 0x00003FE0, 0x00000FF8, 0x000003FE, 0x0000007F, 0x000001FF, 0x00000FF8, 0x00003FE0, 0x0000FF80, 0x0001FC00, 0x0001F000, 0x0001C000,  // Ascii = [^]
+0x00600000, 0x00600000, 0x00600000, 0x00600000, 0x00600000, 0x00600000, 0x00600000, 0x00600000, 0x00600000, 0x00600000, 0x00600000, 0x00600000, 0x00600000, 0x00600000, 0x00600000, 0x00600000,  // Ascii = [_]
+0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000001, 0x00000001, 0x00000001, 0x00000001, 0x00000000, 0x00000000, 0x00000000, 0x00000000,  // Ascii = [`]
+0x00000000, 0x00078000, 0x000FC180, 0x001FE180, 0x001FE1C0, 0x001EF1C0, 0x001870C0, 0x001830C0, 0x001830C0, 0x001C31C0, 0x000FFFC0, 0x000FFFC0, 0x001FFFC0, 0x001FFF80, 0x001FFE00, 0x00180000,  // Ascii = [a]
+0x00000000, 0x00000000, 0x001FFFFF, 0x001FFFFF, 0x001FFFFF, 0x000FFFFF, 0x001C0380, 0x001C01C0, 0x001800C0, 0x001800C0, 0x001C01C0, 0x001F03C0, 0x000FFFC0, 0x000FFF80, 0x0007FF80, 0x0001FE00,  // Ascii = [b]
+0x00000000, 0x00007000, 0x0003FE00, 0x0007FF00, 0x000FFF80, 0x000FFF80, 0x001F07C0, 0x001C01C0, 0x001C01C0, 0x001800C0, 0x001800C0, 0x001800C0, 0x001800C0, 0x001C01C0, 0x001C01C0, 0x000C0180,  // Ascii = [c]
+0x00000000, 0x0001FC00, 0x0007FF00, 0x000FFF80, 0x001FFF80, 0x001F9FC0, 0x001C01C0, 0x001800C0, 0x001800C0, 0x001C00C0, 0x000E01C0, 0x001FFFFF, 0x001FFFFF, 0x001FFFFF, 0x001FFFFF, 0x001FFFFF,  // Ascii = [d]
+0x00000000, 0x0000F800, 0x0003FE00, 0x0007FF00, 0x000FFF80, 0x000FFF80, 0x001E33C0, 0x001C31C0, 0x001830C0, 0x001830C0, 0x001831C0, 0x00183FC0, 0x00183FC0, 0x001C3F80, 0x001C3F00, 0x000C3C00,  // Ascii = [e]
+0x00000000, 0x000000C0, 0x000000C0, 0x000000C0, 0x000000C0, 0x001FFFF8, 0x001FFFFE, 0x001FFFFF, 0x001FFFFF, 0x001FFFFF, 0x000000C3, 0x000000C1, 0x000000C1, 0x000000C1, 0x000000C1, 0x000000C3,  // Ascii = [f]
+0x00000000, 0x0001FC00, 0x0307FF00, 0x030FFF80, 0x031FFF80, 0x021F8FC0, 0x021C01C0, 0x021800C0, 0x021800C0, 0x031C01C0, 0x030E01C0, 0x03FFFF80, 0x03FFFFC0, 0x01FFFFC0, 0x00FFFFC0, 0x001FFFC0,  // Ascii = [g]
+0x00000000, 0x00000000, 0x001FFFFF, 0x001FFFFF, 0x001FFFFF, 0x001FFFFF, 0x00000780, 0x000003C0, 0x000001C0, 0x000000C0, 0x000000C0, 0x001FFFC0, 0x001FFFC0, 0x001FFFC0, 0x001FFF80, 0x001FFE00,  // Ascii = [h]
+0x00000000, 0x000000C0, 0x000000C0, 0x000000C0, 0x000000C0, 0x000000C0, 0x000000C0, 0x001FFFC3, 0x001FFFC3, 0x001FFFC3, 0x001FFFC3, 0x00000003, 0x00000000, 0x00000000, 0x00000000, 0x00000000,  // Ascii = [i]
+0x00000000, 0x03000000, 0x030000C0, 0x030000C0, 0x020000C0, 0x020000C0, 0x020000C0, 0x030000C0, 0x03FFFFC3, 0x03FFFFC3, 0x03FFFFC3, 0x01FFFFC3, 0x007FFFC3, 0x00000000, 0x00000000, 0x00000000,  // Ascii = [j]
+0x00000000, 0x00000000, 0x001FFFFF, 0x001FFFFF, 0x001FFFFF, 0x001FFFFF, 0x00007000, 0x0000FC00, 0x0001FE00, 0x0003FF00, 0x0007CF80, 0x001F87C0, 0x001F03C0, 0x001E01C0, 0x001C00C0, 0x00180040,  // Ascii = [k]
+0x00000000, 0x00000001, 0x00000001, 0x00000001, 0x00000001, 0x00000001, 0x00000001, 0x001FFFFF, 0x001FFFFF, 0x001FFFFF, 0x001FFFFF, 0x001FFFFF, 0x00000000, 0x00000000, 0x00000000, 0x00000000,  // Ascii = [l]
+0x001FFFC0, 0x001FFFC0, 0x001FFFC0, 0x001FFFC0, 0x00000F80, 0x000003C0, 0x000007C0, 0x001FFFC0, 0x001FFFC0, 0x001FFF80, 0x00000F80, 0x000003C0, 0x000003C0, 0x001FFFC0, 0x001FFFC0, 0x001FFF80,  // Ascii = [m]
+0x00000000, 0x00000000, 0x001FFFC0, 0x001FFFC0, 0x001FFFC0, 0x001FFFC0, 0x00000780, 0x000003C0, 0x000001C0, 0x000000C0, 0x000000C0, 0x001FFFC0, 0x001FFFC0, 0x001FFFC0, 0x001FFF80, 0x001FFE00,  // Ascii = [n]
+0x00000000, 0x0001FC00, 0x0007FF00, 0x000FFF80, 0x000FFF80, 0x001F07C0, 0x001C01C0, 0x001800C0, 0x001800C0, 0x001800C0, 0x001C01C0, 0x001F07C0, 0x000FFF80, 0x000FFF80, 0x0007FF00, 0x0003FE00,  // Ascii = [o]
+0x00000000, 0x00000000, 0x03FFFFC0, 0x03FFFFC0, 0x03FFFFC0, 0x03FFFFC0, 0x001E0380, 0x001C01C0, 0x001800C0, 0x001800C0, 0x001C01C0, 0x001F03C0, 0x001FFFC0, 0x000FFF80, 0x0007FF80, 0x0001FE00,  // Ascii = [p]
+0x00000000, 0x0003FC00, 0x0007FF00, 0x000FFF80, 0x001FFF80, 0x001F07C0, 0x001C01C0, 0x001800C0, 0x001800C0, 0x001C01C0, 0x000E01C0, 0x03FFFF80, 0x03FFFFC0, 0x03FFFFC0, 0x03FFFFC0, 0x00000000,  // Ascii = [q]
+0x00000000, 0x00000000, 0x00000000, 0x001FFFC0, 0x001FFFC0, 0x001FFFC0, 0x001FFFC0, 0x001FFFC0, 0x00000780, 0x000003C0, 0x000001C0, 0x000000C0, 0x000000C0, 0x000007C0, 0x000007C0, 0x000007C0,  // Ascii = [r]
+0x00000000, 0x00000000, 0x000C0E00, 0x001C1F80, 0x001C1F80, 0x001C3FC0, 0x00183FC0, 0x001838C0, 0x001870C0, 0x001870C0, 0x001CF0C0, 0x001FE0C0, 0x000FE1C0, 0x000FE1C0, 0x0007C180, 0x00000000,  // Ascii = [s]
+0x00000000, 0x000000C0, 0x000000C0, 0x000000C0, 0x000000C0, 0x0007FFF8, 0x000FFFF8, 0x001FFFF8, 0x001FFFF8, 0x001C00C0, 0x001800C0, 0x001800C0, 0x001800C0, 0x001800C0, 0x001800C0, 0x001800C0,  // Ascii = [t]
+0x00000000, 0x00000000, 0x0007FFC0, 0x000FFFC0, 0x001FFFC0, 0x001FFFC0, 0x001C0000, 0x00180000, 0x001C0000, 0x001E0000, 0x000F0000, 0x001FFFC0, 0x001FFFC0, 0x001FFFC0, 0x001FFFC0, 0x00000000,  // Ascii = [u]
+0x00000040, 0x000001C0, 0x00000FC0, 0x00003FC0, 0x0001FF80, 0x0007FE00, 0x001FF800, 0x001FC000, 0x001F0000, 0x001FC000, 0x001FF000, 0x0007FE00, 0x0000FF80, 0x00003FC0, 0x00000FC0, 0x000001C0,  // Ascii = [v]
+0x00000FC0, 0x0001FFC0, 0x001FFFC0, 0x001FFFC0, 0x001FF000, 0x001FF000, 0x001FFF00, 0x0001FF80, 0x00001F80, 0x0001FF80, 0x001FFF80, 0x001FFC00, 0x001FC000, 0x001FFE00, 0x001FFFC0, 0x0001FFC0,  // Ascii = [w]
+0x00000000, 0x00100040, 0x001C01C0, 0x001E03C0, 0x001F07C0, 0x000FDFC0, 0x0007FF80, 0x0001FE00, 0x0001FC00, 0x0003FC00, 0x0007FF00, 0x001FDF80, 0x001F87C0, 0x001E03C0, 0x001C00C0, 0x00180040,  // Ascii = [x]
+0x00000040, 0x020001C0, 0x020007C0, 0x02003FC0, 0x0300FFC0, 0x0383FF00, 0x03FFF800, 0x03FFE000, 0x01FF8000, 0x007FC000, 0x000FF800, 0x0003FE00, 0x0000FF80, 0x00003FC0, 0x000007C0, 0x000001C0,  // Ascii = [y]
+0x00000000, 0x00180000, 0x001C00C0, 0x001F00C0, 0x001F80C0, 0x001FC0C0, 0x001BE0C0, 0x0019F0C0, 0x0018F8C0, 0x00187CC0, 0x00183EC0, 0x00181FC0, 0x00180FC0, 0x001807C0, 0x001803C0, 0x001801C0,  // Ascii = [z]
+0x00000000, 0x00000000, 0x00001800, 0x00001800, 0x00001800, 0x00001800, 0x007C3C3E, 0x00FFFFFF, 0x00FFFFFF, 0x01FFE7FF, 0x01C381C3, 0x01800001, 0x01800001, 0x01800001, 0x01800001, 0x00000000,  // Ascii = [{]
+0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x01FFFFFF, 0x01FFFFFF, 0x01FFFFFF, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,  // Ascii = [|]
+0x00000000, 0x00000000, 0x01800001, 0x01800001, 0x01800001, 0x01800001, 0x01C18183, 0x01FFE7FF, 0x00FFFFFF, 0x00FFFFFF, 0x007C3C3E, 0x00001800, 0x00001800, 0x00001800, 0x00001800, 0x00000000,  // Ascii = [}]
+0x0000C000, 0x0000F000, 0x0000F800, 0x0000F800, 0x00001800, 0x00001800, 0x00003800, 0x00007800, 0x00007000, 0x0000F000, 0x0000E000, 0x0000C000, 0x0000C000, 0x0000F800, 0x0000F800, 0x00007800,  // Ascii = [~]
+};
 
 FontDef_t Font_7x10 = {
 	7,
 	10,
-	Font7x10
+	Font7x10,
+	Font7x10_Columns
 };
 
 FontDef_t Font_11x18 = {
 	11,
 	18,
-	Font11x18
+	Font11x18,
+	Font11x18_Columns
 };
 
 FontDef_t Font_16x26 = {
 	16,
 	26,
-	Font16x26
+	Font16x26,
+	Font16x26_Columns
 };
 
 char* FONTS_GetStringSize(char* str, FONTS_SIZE_t* SizeStruct, FontDef_t* Font) {
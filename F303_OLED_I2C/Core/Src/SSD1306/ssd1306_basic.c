@@ -26,6 +26,244 @@
 /* SSD1306 data buffer */
 //static uint8_t SSD1306_Buffer[SSD1306_WIDTH * SSD1306_HEIGHT / 8];
 
+/* Stages of the asynchronous flush of a page */
+#define SSD1306_FLUSH_COMMAND	0
+#define SSD1306_FLUSH_DATA		1
+
+/* Enables the cycle counter used to measure the updates */
+static void ssd1306_TimerInit(void) {
+	CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+	DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+}
+
+/* Microseconds elapsed since the given cycle counter value */
+static uint32_t ssd1306_Elapsed(uint32_t start) {
+	return (DWT->CYCCNT - start) / (SystemCoreClock / 1000000);
+}
+
+/* Init command tables, sent after a 0x00 control byte */
+static const uint8_t ssd1306_Init128x64[] = {
+	0xAE,							//display off
+	0x20, SSD1306_ADDRESSING_PAGE,	//Set Memory Addressing Mode
+	0xB0,							//Set Page Start Address for Page Addressing Mode,0-7
+	0xC8,							//Set COM Output Scan Direction
+	0x00,							//---set low column address
+	0x10,							//---set high column address
+	0x40,							//--set start line address
+	0x81, 0xFF,						//--set contrast control register
+	0xA1,							//--set segment re-map 0 to 127
+	0xA6,							//--set normal display
+	0xA8, 0x3F,						//--set multiplex ratio(1 to 64)
+	0xA4,							//0xa4,Output follows RAM content;0xa5,Output ignores RAM content
+	0xD3, 0x00,						//-set display offset, not offset
+	0xD5, 0xF0,						//--set display clock divide ratio/oscillator frequency
+	0xD9, 0x22,						//--set pre-charge period
+	0xDA, 0x12,						//--set com pins hardware configuration
+	0xDB, 0x20,						//--set vcomh, 0x20,0.77xVcc
+	0x8D, 0x14,						//--set DC-DC enable
+	0xAF							//--turn on SSD1306 panel
+};
+
+static const uint8_t ssd1306_Init128x32[] = {
+	0xAE,							//display off
+	0x20, SSD1306_ADDRESSING_PAGE,	//Set Memory Addressing Mode
+	0xB0,							//Set Page Start Address for Page Addressing Mode,0-3
+	0xC8,							//Set COM Output Scan Direction
+	0x00,							//---set low column address
+	0x10,							//---set high column address
+	0x40,							//--set start line address
+	0x81, 0x8F,						//--set contrast control register
+	0xA1,							//--set segment re-map 0 to 127
+	0xA6,							//--set normal display
+	0xA8, 0x1F,						//--set multiplex ratio(1 to 32)
+	0xA4,							//0xa4,Output follows RAM content;0xa5,Output ignores RAM content
+	0xD3, 0x00,						//-set display offset, not offset
+	0xD5, 0xF0,						//--set display clock divide ratio/oscillator frequency
+	0xD9, 0x22,						//--set pre-charge period
+	0xDA, 0x02,						//--set com pins hardware configuration, sequential
+	0xDB, 0x20,						//--set vcomh, 0x20,0.77xVcc
+	0x8D, 0x14,						//--set DC-DC enable
+	0xAF							//--turn on SSD1306 panel
+};
+
+static const uint8_t ssd1306_InitSH1106[] = {
+	0xAE,							//display off
+	0xB0,							//Set Page Address, page addressing only
+	0xC8,							//Set COM Output Scan Direction
+	0x02,							//---set low column address
+	0x10,							//---set high column address
+	0x40,							//--set start line address
+	0x81, 0xFF,						//--set contrast control register
+	0xA1,							//--set segment re-map
+	0xA6,							//--set normal display
+	0xA8, 0x3F,						//--set multiplex ratio(1 to 64)
+	0xA4,							//0xa4,Output follows RAM content;0xa5,Output ignores RAM content
+	0xD3, 0x00,						//-set display offset, not offset
+	0xD5, 0xF0,						//--set display clock divide ratio/oscillator frequency
+	0xD9, 0x22,						//--set pre-charge period
+	0xDA, 0x12,						//--set com pins hardware configuration
+	0xDB, 0x20,						//--set vcomh
+	0xAD, 0x8B,						//--set DC-DC on
+	0xAF							//--turn on SH1106 panel
+};
+
+typedef struct {
+	const uint8_t* commands;
+	uint8_t length;
+	uint8_t column_offset;	/* First RAM column of the buffer, SH1106 has 132 columns */
+} ssd1306_panel_t;
+
+static const ssd1306_panel_t ssd1306_Panels[] = {
+	[SSD1306_PANEL_128x64] = {ssd1306_Init128x64, sizeof(ssd1306_Init128x64), 0},
+	[SSD1306_PANEL_128x32] = {ssd1306_Init128x32, sizeof(ssd1306_Init128x32), 0},
+	[SSD1306_PANEL_SH1106] = {ssd1306_InitSH1106, sizeof(ssd1306_InitSH1106), (132 - SSD1306_WIDTH) / 2}
+};
+
+/* Sets every page as not modified */
+static void ssd1306_ClearDirty(ssd1306_t* ssd1306) {
+	memset(ssd1306->DirtyStart, SSD1306_DIRTY_NONE, sizeof(ssd1306->DirtyStart));
+	memset(ssd1306->DirtyEnd, 0, sizeof(ssd1306->DirtyEnd));
+}
+
+/* Extends the modified column window of a page */
+static inline void ssd1306_MarkPage(ssd1306_t* ssd1306, uint8_t page, uint8_t x_start, uint8_t x_end) {
+	if (x_start < ssd1306->DirtyStart[page]) {
+		ssd1306->DirtyStart[page] = x_start;
+	}
+	if (x_end > ssd1306->DirtyEnd[page]) {
+		ssd1306->DirtyEnd[page] = x_end;
+	}
+}
+
+/* Column/page window {c0, c1, p0, p1} covering the given regions in horizontal mode.
+ * A single page keeps its column window, several pages are sent full width so the
+ * data stays contiguous in the buffer. Returns the data bytes of the window */
+static uint16_t ssd1306_BurstWindow(const uint8_t* start, const uint8_t* end, uint8_t* window) {
+	uint8_t m;
+	uint8_t first = SSD1306_PAGES;
+	uint8_t last = 0;
+
+	for (m = 0; m < SSD1306_PAGES; m++) {
+		if (start[m] <= end[m]) {
+			if (first == SSD1306_PAGES) {
+				first = m;
+			}
+			last = m;
+		}
+	}
+	if (first == SSD1306_PAGES) {
+		return 0;
+	}
+	if (first == last) {
+		window[0] = start[first];
+		window[1] = end[first];
+	} else {
+		window[0] = 0;
+		window[1] = SSD1306_WIDTH - 1;
+	}
+	window[2] = first;
+	window[3] = last;
+	return (uint16_t)(window[1] - window[0] + 1) * (last - first + 1);
+}
+
+/* Marks again the pages an aborted asynchronous flush did not transmit */
+static void ssd1306_FlushRestore(ssd1306_t* ssd1306) {
+	uint8_t m;
+
+	if (!ssd1306->FlushAborted) {
+		return;
+	}
+	for (m = ssd1306->FlushPage; m < SSD1306_PAGES; m++) {
+		if (ssd1306->FlushStart[m] <= ssd1306->FlushEnd[m]) {
+			ssd1306_MarkPage(ssd1306, m, ssd1306->FlushStart[m], ssd1306->FlushEnd[m]);
+		}
+	}
+	ssd1306->FlushAborted = 0;
+}
+
+/* Stops the asynchronous flush, the remaining pages are restored from task context */
+static void ssd1306_FlushAbort(ssd1306_t* ssd1306) {
+	ssd1306->FlushAborted = 1;
+	ssd1306->FlushBusy = 0;
+	if (ssd1306->FlushCpltCallback != NULL) {
+		ssd1306->FlushCpltCallback(ssd1306);
+	}
+}
+
+/* Ends the asynchronous flush after its last transfer */
+static void ssd1306_FlushDone(ssd1306_t* ssd1306) {
+	ssd1306->FrameTime = ssd1306_Elapsed(ssd1306->FlushStartTime);
+	ssd1306->FlushBusy = 0;
+	if (ssd1306->FlushCpltCallback != NULL) {
+		ssd1306->FlushCpltCallback(ssd1306);
+	}
+}
+
+/* Starts the single window transfer of the asynchronous flush in horizontal mode */
+static HAL_StatusTypeDef ssd1306_FlushBurst(ssd1306_t* ssd1306) {
+	uint8_t window[4];
+	uint16_t count = 0;
+
+	if (ssd1306->FlushPage < SSD1306_PAGES) {
+		count = ssd1306_BurstWindow(ssd1306->FlushStart, ssd1306->FlushEnd, window);
+	}
+	if (count == 0) {
+		ssd1306_FlushDone(ssd1306);
+		return HAL_OK;
+	}
+
+	if (ssd1306->FlushStage == SSD1306_FLUSH_COMMAND) {
+		ssd1306->FlushCmd[0] = 0x21;
+		ssd1306->FlushCmd[1] = window[0];
+		ssd1306->FlushCmd[2] = window[1];
+		ssd1306->FlushCmd[3] = 0x22;
+		ssd1306->FlushCmd[4] = window[2];
+		ssd1306->FlushCmd[5] = window[3];
+		return HAL_I2C_Mem_Write_IT(ssd1306->hi2c, ssd1306->addr, 0x00, I2C_MEMADD_SIZE_8BIT, ssd1306->FlushCmd, 6);
+	}
+
+	if (ssd1306->hi2c->hdmatx != NULL) {
+		return HAL_I2C_Mem_Write_DMA(ssd1306->hi2c, ssd1306->addr, 0x40, I2C_MEMADD_SIZE_8BIT, &ssd1306->SSD1306_Front[SSD1306_WIDTH * window[2] + window[0]], count);
+	}
+	return HAL_I2C_Mem_Write_IT(ssd1306->hi2c, ssd1306->addr, 0x40, I2C_MEMADD_SIZE_8BIT, &ssd1306->SSD1306_Front[SSD1306_WIDTH * window[2] + window[0]], count);
+}
+
+/* Starts the next transfer of the asynchronous flush */
+static HAL_StatusTypeDef ssd1306_FlushNext(ssd1306_t* ssd1306) {
+	uint8_t m = ssd1306->FlushPage;
+	uint8_t start;
+	uint16_t count;
+
+	if (ssd1306->AddressingMode == SSD1306_ADDRESSING_HORIZONTAL) {
+		return ssd1306_FlushBurst(ssd1306);
+	}
+
+	/* Skip pages without changes */
+	while (m < SSD1306_PAGES && ssd1306->FlushStart[m] > ssd1306->FlushEnd[m]) {
+		m++;
+	}
+	ssd1306->FlushPage = m;
+	if (m >= SSD1306_PAGES) {
+		ssd1306_FlushDone(ssd1306);
+		return HAL_OK;
+	}
+
+	start = ssd1306->FlushStart[m];
+	if (ssd1306->FlushStage == SSD1306_FLUSH_COMMAND) {
+		/* Page and column address in a single command transaction */
+		ssd1306->FlushCmd[0] = 0xB0 + m;
+		ssd1306->FlushCmd[1] = 0x00 | ((start + ssd1306->ColumnOffset) & 0x0F);
+		ssd1306->FlushCmd[2] = 0x10 | ((start + ssd1306->ColumnOffset) >> 4);
+		return HAL_I2C_Mem_Write_IT(ssd1306->hi2c, ssd1306->addr, 0x00, I2C_MEMADD_SIZE_8BIT, ssd1306->FlushCmd, 3);
+	}
+
+	count = ssd1306->FlushEnd[m] - start + 1;
+	if (ssd1306->hi2c->hdmatx != NULL) {
+		return HAL_I2C_Mem_Write_DMA(ssd1306->hi2c, ssd1306->addr, 0x40, I2C_MEMADD_SIZE_8BIT, &ssd1306->SSD1306_Front[SSD1306_WIDTH * m + start], count);
+	}
+	return HAL_I2C_Mem_Write_IT(ssd1306->hi2c, ssd1306->addr, 0x40, I2C_MEMADD_SIZE_8BIT, &ssd1306->SSD1306_Front[SSD1306_WIDTH * m + start], count);
+}
+
 ssd1306_t* ssd1306_new(I2C_HandleTypeDef *hi2c, uint8_t addr){
 	ssd1306_t* ssd1306 = malloc(sizeof(*ssd1306));
 	SSD1306_Init(ssd1306, hi2c, addr);
@@ -33,58 +271,67 @@ ssd1306_t* ssd1306_new(I2C_HandleTypeDef *hi2c, uint8_t addr){
 }
 
 uint8_t SSD1306_Init(ssd1306_t* ssd1306, I2C_HandleTypeDef *hi2c, uint8_t addr) {
+	return SSD1306_InitPanel(ssd1306, hi2c, addr, SSD1306_PANEL);
+}
+
+uint8_t SSD1306_InitPanel(ssd1306_t* ssd1306, I2C_HandleTypeDef *hi2c, uint8_t addr, SSD1306_PANEL_t panel) {
+	const ssd1306_panel_t* def = &ssd1306_Panels[panel];
+	uint32_t t0;
+	uint8_t step;
 
 	ssd1306->hi2c = hi2c;
 	ssd1306->addr = addr;
-	
+	ssd1306->Write = NULL;
+	ssd1306->WriteContext = NULL;
+	ssd1306->BytesSaved = 0;
+	ssd1306->AddressingMode = SSD1306_ADDRESSING_PAGE;
+	ssd1306->ColumnOffset = def->column_offset;
+	ssd1306->Scrolling = 0;
+	ssd1306->FrameTime = 0;
+	ssd1306->FlushBusy = 0;
+	ssd1306->FlushAborted = 0;
+	ssd1306->FlushCpltCallback = NULL;
+	ssd1306->Initialized = 0;
+	ssd1306_ClearDirty(ssd1306);
+	ssd1306_TimerInit();
+	for (step = 0; step < SSD1306_INIT_STEPS; step++) {
+		ssd1306->InitStatus[step] = HAL_ERROR;
+		ssd1306->InitTime[step] = 0;
+	}
+
 	/* Check if LCD connected to I2C */
-	if (HAL_I2C_IsDeviceReady(ssd1306->hi2c, ssd1306->addr, 1, 20000) != HAL_OK) {
+	t0 = DWT->CYCCNT;
+	ssd1306->InitStatus[SSD1306_INIT_PROBE] = HAL_I2C_IsDeviceReady(ssd1306->hi2c, ssd1306->addr, SSD1306_PROBE_TRIALS, SSD1306_PROBE_TIMEOUT);
+	ssd1306->InitTime[SSD1306_INIT_PROBE] = ssd1306_Elapsed(t0);
+	if (ssd1306->InitStatus[SSD1306_INIT_PROBE] != HAL_OK) {
 		/* Return false */
 		return 0;
 	}
-	
-	/* A little delay */
-//	uint32_t p = 2500;
-//	while(p>0)
-//		p--;
-	
-	/* Init LCD */
-	ssd1306_I2C_Write(ssd1306, 0x00, 0xAE);
-	ssd1306_I2C_Write(ssd1306, 0x00, 0xAE); //display off
-	ssd1306_I2C_Write(ssd1306, 0x00, 0x20); //Set Memory Addressing Mode
-	ssd1306_I2C_Write(ssd1306, 0x00, 0x10); //00,Horizontal Addressing Mode;01,Vertical Addressing Mode;10,Page Addressing Mode (RESET);11,Invalid
-	ssd1306_I2C_Write(ssd1306, 0x00, 0xB0); //Set Page Start Address for Page Addressing Mode,0-7
-	ssd1306_I2C_Write(ssd1306, 0x00, 0xC8); //Set COM Output Scan Direction
-	ssd1306_I2C_Write(ssd1306, 0x00, 0x00); //---set low column address
-	ssd1306_I2C_Write(ssd1306, 0x00, 0x10); //---set high column address
-	ssd1306_I2C_Write(ssd1306, 0x00, 0x40); //--set start line address
-	ssd1306_I2C_Write(ssd1306, 0x00, 0x81); //--set contrast control register
-	ssd1306_I2C_Write(ssd1306, 0x00, 0xFF);
-	ssd1306_I2C_Write(ssd1306, 0x00, 0xA1); //--set segment re-map 0 to 127
-	ssd1306_I2C_Write(ssd1306, 0x00, 0xA6); //--set normal display
-	ssd1306_I2C_Write(ssd1306, 0x00, 0xA8); //--set multiplex ratio(1 to 64)
-	ssd1306_I2C_Write(ssd1306, 0x00, 0x3F); //
-	ssd1306_I2C_Write(ssd1306, 0x00, 0xA4); //0xa4,Output follows RAM content;0xa5,Output ignores RAM content
-	ssd1306_I2C_Write(ssd1306, 0x00, 0xD3); //-set display offset
-	ssd1306_I2C_Write(ssd1306, 0x00, 0x00); //-not offset
-	ssd1306_I2C_Write(ssd1306, 0x00, 0xD5); //--set display clock divide ratio/oscillator frequency
-	ssd1306_I2C_Write(ssd1306, 0x00, 0xF0); //--set divide ratio
-	ssd1306_I2C_Write(ssd1306, 0x00, 0xD9); //--set pre-charge period
-	ssd1306_I2C_Write(ssd1306, 0x00, 0x22); //
-	ssd1306_I2C_Write(ssd1306, 0x00, 0xDA); //--set com pins hardware configuration
-	ssd1306_I2C_Write(ssd1306, 0x00, 0x12);
-	ssd1306_I2C_Write(ssd1306, 0x00, 0xDB); //--set vcomh
-	ssd1306_I2C_Write(ssd1306, 0x00, 0x20); //0x20,0.77xVcc
-	ssd1306_I2C_Write(ssd1306, 0x00, 0x8D); //--set DC-DC enable
-	ssd1306_I2C_Write(ssd1306, 0x00, 0x14); //
-	ssd1306_I2C_Write(ssd1306, 0x00, 0xAF); //--turn on SSD1306 panel
-	
+
+	/* Init LCD, the whole command table in a single transaction */
+	t0 = DWT->CYCCNT;
+	ssd1306->InitStatus[SSD1306_INIT_COMMANDS] = ssd1306_I2C_WriteMulti(ssd1306, 0x00, (uint8_t*)def->commands, def->length);
+	ssd1306->InitTime[SSD1306_INIT_COMMANDS] = ssd1306_Elapsed(t0);
+	if (ssd1306->InitStatus[SSD1306_INIT_COMMANDS] != HAL_OK) {
+		return 0;
+	}
+
 	/* Clear screen */
-	SSD1306_Fill(ssd1306, SSD1306_COLOR_BLACK);
-	
-	/* Update screen */
-	SSD1306_UpdateScreen(ssd1306);
-	
+	t0 = DWT->CYCCNT;
+	ssd1306->InitStatus[SSD1306_INIT_CLEAR] = HAL_OK;
+	memset(ssd1306->SSD1306_Buffer, 0x00, sizeof(ssd1306->SSD1306_Buffer));
+	for (step = 0; step < SSD1306_PAGES && ssd1306->InitStatus[SSD1306_INIT_CLEAR] == HAL_OK; step++) {
+		uint8_t cmd[3] = {0xB0 + step, 0x00 | (def->column_offset & 0x0F), 0x10 | (def->column_offset >> 4)};
+		ssd1306->InitStatus[SSD1306_INIT_CLEAR] = ssd1306_I2C_WriteMulti(ssd1306, 0x00, cmd, 3);
+		if (ssd1306->InitStatus[SSD1306_INIT_CLEAR] == HAL_OK) {
+			ssd1306->InitStatus[SSD1306_INIT_CLEAR] = ssd1306_I2C_WriteMulti(ssd1306, 0x40, &ssd1306->SSD1306_Buffer[SSD1306_WIDTH * step], SSD1306_WIDTH);
+		}
+	}
+	ssd1306->InitTime[SSD1306_INIT_CLEAR] = ssd1306_Elapsed(t0);
+	if (ssd1306->InitStatus[SSD1306_INIT_CLEAR] != HAL_OK) {
+		return 0;
+	}
+
 	/* Set default values */
 	ssd1306->CurrentX = 0;
 	ssd1306->CurrentY = 0;
@@ -99,20 +346,269 @@ uint8_t SSD1306_Init(ssd1306_t* ssd1306, I2C_HandleTypeDef *hi2c, uint8_t addr)
 
 void SSD1306_UpdateScreen(ssd1306_t* ssd1306) {
 	uint8_t m;
+	uint8_t start;
+	uint16_t count;
+	uint16_t sent = 0;
+	uint8_t window[4];
+	uint32_t t0;
+
+	/* The modified regions are sent once the asynchronous flush or the scroll ends */
+	if (ssd1306->FlushBusy || ssd1306->Scrolling) {
+		return;
+	}
+	ssd1306_FlushRestore(ssd1306);
+	t0 = DWT->CYCCNT;
+
+	if (ssd1306->AddressingMode == SSD1306_ADDRESSING_HORIZONTAL) {
+		count = ssd1306_BurstWindow(ssd1306->DirtyStart, ssd1306->DirtyEnd, window);
+		if (count > 0) {
+			/* Column and page window in one command transaction, then the data in one burst */
+			uint8_t cmd[6] = {0x21, window[0], window[1], 0x22, window[2], window[3]};
+			ssd1306_I2C_WriteMulti(ssd1306, 0x00, cmd, 6);
+			ssd1306_I2C_WriteMulti(ssd1306, 0x40, &ssd1306->SSD1306_Buffer[SSD1306_WIDTH * window[2] + window[0]], count);
+			sent = 1 + 6 + 1 + count;
+		}
+		ssd1306_ClearDirty(ssd1306);
+		ssd1306->BytesSaved = SSD1306_FRAME_BYTES - sent;
+		ssd1306->FrameTime = ssd1306_Elapsed(t0);
+		return;
+	}
+
+	for (m = 0; m < SSD1306_PAGES; m++) {
+		/* Skip pages without changes */
+		if (ssd1306->DirtyStart[m] > ssd1306->DirtyEnd[m]) {
+			continue;
+		}
+		start = ssd1306->DirtyStart[m];
+		count = ssd1306->DirtyEnd[m] - start + 1;
 
-	for (m = 0; m < 8; m++) {
 		ssd1306_I2C_Write(ssd1306, 0x00, 0xB0 + m);
-		ssd1306_I2C_Write(ssd1306, 0x00, 0x00);
-		ssd1306_I2C_Write(ssd1306, 0x00, 0x10);
+		ssd1306_I2C_Write(ssd1306, 0x00, 0x00 | ((start + ssd1306->ColumnOffset) & 0x0F));
+		ssd1306_I2C_Write(ssd1306, 0x00, 0x10 | ((start + ssd1306->ColumnOffset) >> 4));
 
 		/* Write multi data */
-		ssd1306_I2C_WriteMulti(ssd1306, 0x40, &ssd1306->SSD1306_Buffer[SSD1306_WIDTH * m], SSD1306_WIDTH);
+		ssd1306_I2C_WriteMulti(ssd1306, 0x40, &ssd1306->SSD1306_Buffer[SSD1306_WIDTH * m + start], count);
+		sent += 3 * 2 + 1 + count;
+
+		ssd1306->DirtyStart[m] = SSD1306_DIRTY_NONE;
+		ssd1306->DirtyEnd[m] = 0;
+	}
+	ssd1306->BytesSaved = SSD1306_FRAME_BYTES - sent;
+	ssd1306->FrameTime = ssd1306_Elapsed(t0);
+}
+
+uint8_t SSD1306_UpdateScreenAsync(ssd1306_t* ssd1306) {
+	uint8_t m;
+	uint8_t start;
+	uint16_t count;
+	uint16_t sent = 0;
+	uint8_t window[4];
+
+	if (ssd1306->FlushBusy || ssd1306->Scrolling) {
+		return 0;
+	}
+	if (ssd1306->Write != NULL) {
+		SSD1306_UpdateScreen(ssd1306);
+		return 0;
+	}
+	ssd1306_FlushRestore(ssd1306);
+
+	/* Hand the modified windows to the front buffer */
+	ssd1306->FlushStartTime = DWT->CYCCNT;
+	if (ssd1306->AddressingMode == SSD1306_ADDRESSING_HORIZONTAL) {
+		count = ssd1306_BurstWindow(ssd1306->DirtyStart, ssd1306->DirtyEnd, window);
+		if (count > 0) {
+			for (m = window[2]; m <= window[3]; m++) {
+				memcpy(&ssd1306->SSD1306_Front[SSD1306_WIDTH * m + window[0]], &ssd1306->SSD1306_Buffer[SSD1306_WIDTH * m + window[0]], window[1] - window[0] + 1);
+			}
+			sent = 1 + 6 + 1 + count;
+		}
+	}
+	for (m = 0; m < SSD1306_PAGES; m++) {
+		ssd1306->FlushStart[m] = ssd1306->DirtyStart[m];
+		ssd1306->FlushEnd[m] = ssd1306->DirtyEnd[m];
+		if (ssd1306->DirtyStart[m] > ssd1306->DirtyEnd[m]) {
+			continue;
+		}
+		if (ssd1306->AddressingMode == SSD1306_ADDRESSING_HORIZONTAL) {
+			ssd1306->DirtyStart[m] = SSD1306_DIRTY_NONE;
+			ssd1306->DirtyEnd[m] = 0;
+			continue;
+		}
+		start = ssd1306->DirtyStart[m];
+		count = ssd1306->DirtyEnd[m] - start + 1;
+		memcpy(&ssd1306->SSD1306_Front[SSD1306_WIDTH * m + start], &ssd1306->SSD1306_Buffer[SSD1306_WIDTH * m + start], count);
+		sent += 1 + 3 + 1 + count;
+
+		ssd1306->DirtyStart[m] = SSD1306_DIRTY_NONE;
+		ssd1306->DirtyEnd[m] = 0;
+	}
+	ssd1306->BytesSaved = SSD1306_FRAME_BYTES - sent;
+	if (sent == 0) {
+		return 0;
+	}
+
+	ssd1306->FlushPage = 0;
+	ssd1306->FlushStage = SSD1306_FLUSH_COMMAND;
+	ssd1306->FlushBusy = 1;
+	if (ssd1306_FlushNext(ssd1306) != HAL_OK) {
+		/* Bus busy, keep the windows for the next update */
+		ssd1306->FlushAborted = 1;
+		ssd1306->FlushBusy = 0;
+		ssd1306_FlushRestore(ssd1306);
+		return 0;
+	}
+	return 1;
+}
+
+void SSD1306_TxCpltCallback(ssd1306_t* ssd1306, I2C_HandleTypeDef *hi2c) {
+	if (hi2c != ssd1306->hi2c || !ssd1306->FlushBusy) {
+		return;
+	}
+	if (ssd1306->FlushStage == SSD1306_FLUSH_COMMAND) {
+		ssd1306->FlushStage = SSD1306_FLUSH_DATA;
+	} else {
+		ssd1306->FlushStage = SSD1306_FLUSH_COMMAND;
+		/* Horizontal mode sends every page in a single data transfer */
+		ssd1306->FlushPage = (ssd1306->AddressingMode == SSD1306_ADDRESSING_HORIZONTAL) ? SSD1306_PAGES : ssd1306->FlushPage + 1;
+	}
+	if (ssd1306_FlushNext(ssd1306) != HAL_OK) {
+		ssd1306_FlushAbort(ssd1306);
+	}
+}
+
+void SSD1306_ErrorCallback(ssd1306_t* ssd1306, I2C_HandleTypeDef *hi2c) {
+	if (hi2c != ssd1306->hi2c || !ssd1306->FlushBusy) {
+		return;
+	}
+	ssd1306_FlushAbort(ssd1306);
+}
+
+uint8_t SSD1306_SetAddressingMode(ssd1306_t* ssd1306, SSD1306_ADDRESSING_t mode) {
+	/* The column window of the 0x21 command only addresses 128 columns */
+	if (ssd1306->FlushBusy || (mode == SSD1306_ADDRESSING_HORIZONTAL && (SSD1306_WIDTH > 128 || ssd1306->ColumnOffset != 0))) {
+		return 0;
+	}
+	ssd1306_I2C_Write(ssd1306, 0x00, 0x20);
+	ssd1306_I2C_Write(ssd1306, 0x00, mode);
+	ssd1306->AddressingMode = mode;
+	return 1;
+}
+
+uint8_t SSD1306_UpdateWindow(ssd1306_t* ssd1306, uint16_t x, uint16_t y, uint16_t w, uint16_t h) {
+	uint16_t x_end = x + w - 1;
+	uint8_t first = y / 8;
+	uint8_t last;
+	uint8_t cmd[6];
+	uint8_t m;
+
+	if (ssd1306->FlushBusy || ssd1306->Scrolling || w == 0 || h == 0 || x >= SSD1306_WIDTH || y >= SSD1306_HEIGHT) {
+		return 0;
+	}
+	if (x_end >= SSD1306_WIDTH) {
+		x_end = SSD1306_WIDTH - 1;
+	}
+	last = (y + h - 1 >= SSD1306_HEIGHT) ? SSD1306_PAGES - 1 : (y + h - 1) / 8;
+
+	/* In horizontal mode the window keeps the address between the page transfers */
+	if (ssd1306->AddressingMode == SSD1306_ADDRESSING_HORIZONTAL) {
+		cmd[0] = 0x21;
+		cmd[1] = x;
+		cmd[2] = x_end;
+		cmd[3] = 0x22;
+		cmd[4] = first;
+		cmd[5] = last;
+		ssd1306_I2C_WriteMulti(ssd1306, 0x00, cmd, 6);
+	}
+	for (m = first; m <= last; m++) {
+		if (ssd1306->AddressingMode != SSD1306_ADDRESSING_HORIZONTAL) {
+			cmd[0] = 0xB0 + m;
+			cmd[1] = 0x00 | ((x + ssd1306->ColumnOffset) & 0x0F);
+			cmd[2] = 0x10 | ((x + ssd1306->ColumnOffset) >> 4);
+			ssd1306_I2C_WriteMulti(ssd1306, 0x00, cmd, 3);
+		}
+		ssd1306_I2C_WriteMulti(ssd1306, 0x40, &ssd1306->SSD1306_Buffer[SSD1306_WIDTH * m + x], x_end - x + 1);
+
+		if (ssd1306->DirtyStart[m] >= x && ssd1306->DirtyEnd[m] <= x_end) {
+			ssd1306->DirtyStart[m] = SSD1306_DIRTY_NONE;
+			ssd1306->DirtyEnd[m] = 0;
+		}
+	}
+	return 1;
+}
+
+uint8_t SSD1306_StartScroll(ssd1306_t* ssd1306, SSD1306_SCROLL_t dir, uint8_t start_page, uint8_t end_page, SSD1306_SCROLL_INTERVAL_t interval, uint8_t vertical_offset) {
+	uint8_t cmd[9];
+	uint8_t len = 0;
+
+	if (ssd1306->FlushBusy || start_page > end_page || end_page >= SSD1306_PAGES || vertical_offset >= SSD1306_HEIGHT) {
+		return 0;
+	}
+
+	/* The setup is only accepted with the scroll deactivated */
+	cmd[len++] = 0x2E;
+	cmd[len++] = dir;
+	cmd[len++] = 0x00;
+	cmd[len++] = start_page;
+	cmd[len++] = interval;
+	cmd[len++] = end_page;
+	if (dir == SSD1306_SCROLL_RIGHT || dir == SSD1306_SCROLL_LEFT) {
+		cmd[len++] = 0x00;
+		cmd[len++] = 0xFF;
+	} else {
+		cmd[len++] = vertical_offset;
+	}
+	cmd[len++] = 0x2F;
+	ssd1306_I2C_WriteMulti(ssd1306, 0x00, cmd, len);
+	ssd1306->Scrolling = 1;
+	return 1;
+}
+
+uint8_t SSD1306_SetScrollArea(ssd1306_t* ssd1306, uint8_t fixed_rows, uint8_t rows) {
+	uint8_t cmd[3] = {0xA3, fixed_rows, rows};
+
+	if (ssd1306->FlushBusy || fixed_rows + rows > SSD1306_HEIGHT) {
+		return 0;
+	}
+	ssd1306_I2C_WriteMulti(ssd1306, 0x00, cmd, 3);
+	return 1;
+}
+
+void SSD1306_StopScroll(ssd1306_t* ssd1306) {
+	/* Deactivate the scroll and bring the start line back to the first row */
+	uint8_t cmd[2] = {0x2E, 0x40};
+
+	if (!ssd1306->Scrolling) {
+		return;
+	}
+	ssd1306_I2C_WriteMulti(ssd1306, 0x00, cmd, 2);
+	ssd1306->Scrolling = 0;
+	SSD1306_MarkDirty(ssd1306, 0, 0, SSD1306_WIDTH, SSD1306_HEIGHT);
+}
+
+void SSD1306_MarkDirty(ssd1306_t* ssd1306, uint16_t x, uint16_t y, uint16_t w, uint16_t h) {
+	uint16_t x_end = x + w - 1;
+	uint16_t y_end = y + h - 1;
+	uint8_t page;
+
+	if (w == 0 || h == 0 || x >= SSD1306_WIDTH || y >= SSD1306_HEIGHT) {
+		return;
+	}
+	if (x_end >= SSD1306_WIDTH) {
+		x_end = SSD1306_WIDTH - 1;
+	}
+	if (y_end >= SSD1306_HEIGHT) {
+		y_end = SSD1306_HEIGHT - 1;
+	}
+	for (page = y / 8; page <= y_end / 8; page++) {
+		ssd1306_MarkPage(ssd1306, page, x, x_end);
 	}
 }
 
 void SSD1306_Fill(ssd1306_t* ssd1306, SSD1306_COLOR_t color) {
 	/* Set memory */
 	memset(ssd1306->SSD1306_Buffer, (color == SSD1306_COLOR_BLACK) ? 0x00 : 0xFF, sizeof(ssd1306->SSD1306_Buffer));
+	SSD1306_MarkDirty(ssd1306, 0, 0, SSD1306_WIDTH, SSD1306_HEIGHT);
 }
 
 void SSD1306_DrawPixel(ssd1306_t* ssd1306, uint16_t x, uint16_t y, SSD1306_COLOR_t color) {
@@ -135,6 +631,7 @@ void SSD1306_DrawPixel(ssd1306_t* ssd1306, uint16_t x, uint16_t y, SSD1306_COLOR
 	} else {
 		ssd1306->SSD1306_Buffer[x + (y / 8) * SSD1306_WIDTH] &= ~(1 << (y % 8));
 	}
+	ssd1306_MarkPage(ssd1306, y / 8, x, x);
 }
 
 void SSD1306_GotoXY(ssd1306_t* ssd1306, uint16_t x, uint16_t y) {
@@ -143,6 +640,37 @@ void SSD1306_GotoXY(ssd1306_t* ssd1306, uint16_t x, uint16_t y) {
 	ssd1306->CurrentY = y;
 }
 
+/* Writes the transposed glyph at the cursor as whole page bytes, the cursor must leave room for it */
+static void ssd1306_BlitGlyph(ssd1306_t* ssd1306, const uint32_t* columns, FontDef_t* Font, SSD1306_COLOR_t color) {
+	uint8_t shift = ssd1306->CurrentY % 8;
+	uint8_t first = ssd1306->CurrentY / 8;
+	uint8_t last = (ssd1306->CurrentY + Font->FontHeight - 1) / 8;
+	uint64_t mask = (((uint64_t)1 << Font->FontHeight) - 1) << shift;
+	uint64_t bits;
+	uint8_t* dst;
+	uint8_t page_mask;
+	uint8_t page;
+	uint8_t j;
+
+	/* Set pixels take the color, the rest of the glyph box the opposite one */
+	if (ssd1306->Inverted) {
+		color = (SSD1306_COLOR_t)!color;
+	}
+
+	for (page = first; page <= last; page++) {
+		page_mask = (uint8_t)(mask >> (8 * (page - first)));
+		dst = &ssd1306->SSD1306_Buffer[SSD1306_WIDTH * page + ssd1306->CurrentX];
+		for (j = 0; j < Font->FontWidth; j++) {
+			bits = (uint64_t)columns[j] << shift;
+			if (color == SSD1306_COLOR_BLACK) {
+				bits = ~bits;
+			}
+			dst[j] = (dst[j] & ~page_mask) | ((uint8_t)(bits >> (8 * (page - first))) & page_mask);
+		}
+	}
+	SSD1306_MarkDirty(ssd1306, ssd1306->CurrentX, ssd1306->CurrentY, Font->FontWidth, Font->FontHeight);
+}
+
 char SSD1306_Putc(ssd1306_t* ssd1306, uint8_t ch, FontDef_t* Font, SSD1306_COLOR_t color) {
 	uint32_t i, b, j;
 	
@@ -155,6 +683,12 @@ char SSD1306_Putc(ssd1306_t* ssd1306, uint8_t ch, FontDef_t* Font, SSD1306_COLOR
 		return 0;
 	}
 
+	if (Font->columns != NULL) {
+		ssd1306_BlitGlyph(ssd1306, &Font->columns[(ch - 32) * Font->FontWidth], Font, color);
+		ssd1306->CurrentX += Font->FontWidth;
+		return ch;
+	}
+
 	/* Go through font */
 	for (i = 0; i < Font->FontHeight; i++) {
 		b = Font->data[(ch - 32) * Font->FontHeight + i];
@@ -174,39 +708,59 @@ char SSD1306_Putc(ssd1306_t* ssd1306, uint8_t ch, FontDef_t* Font, SSD1306_COLOR
 	return ch;
 }
 
+/**
+ * @brief  Formats a fixed-point number into a display slot string
+ * @param  str: caller buffer of SSD1306_NUMBER_LENGTH chars
+ * @param  value: number scaled by 10^decimals
+ * @param  decimals: number of digits after the decimal point
+ * @param  unit: unit of the value, 2 char array ("mV", " A", etc.)
+ * @retval str
+ */
+char* SSD1306_FormatFixed(char* str, int32_t value, uint8_t decimals, const char* unit) {
+	char digits[10];
+	uint32_t magnitude = (value < 0) ? -(uint32_t)value : (uint32_t)value;
+	uint8_t count = 0;
+	uint8_t pos = 1;
+	uint8_t i;
+
+	/* Digits from the least significant one, at least one before the point */
+	do {
+		digits[count++] = '0' + magnitude % 10;
+		magnitude /= 10;
+	} while ((magnitude > 0 || count <= decimals) && count < sizeof(digits));
+
+	/* Sign, digits and point must fit before the separator */
+	if (magnitude > 0 || count + (decimals > 0) > 7) {
+		strcpy(str, "OVERLOAD");
+		return str;
+	}
+
+	str[0] = (value < 0) ? '-' : ' ';
+	for (i = count; i > 0; i--) {
+		if (i == decimals) {
+			str[pos++] = '.';
+		}
+		str[pos++] = digits[i - 1];
+	}
+	while (pos < 9) {
+		str[pos++] = ' ';
+	}
+	for (i = 0; i < 2; i++) {
+		str[9 + i] = (unit[0] != '\0' && unit[i] != '\0') ? unit[i] : ' ';
+	}
+	str[11] = '\0';
+	return str;
+}
+
 /**
  * @brief  Represents an integer number with a char array
+ * @param  str: caller buffer of SSD1306_NUMBER_LENGTH chars
  * @param  integer: int to be represented
  * @param  unit: unit of the value, 2 char array ("mV", " A", etc.)
  * @retval Char array containing a char for each digit
  */
-char* int_str(int integer,  char* unit){
-	char negative = ' ';
-	if (integer < 0) {
-		integer = -integer;
-		negative = '-';
-	}
-
-	int size = SSD1306_digits(integer);
-	if (size > 7){
-			return "OVERLOAD";
-	}
-	char data_char[size];
-	sprintf(data_char,"%d", integer);
-
-	static char int_str[11];
-	for(int i=1; i<11; i++){
-		if (i<size+1){
-			int_str[i] = data_char[i-1];
-		} else if (i < 9){
-			int_str[i] = ' ';
-		} else {
-			int_str[i] = unit[i-9];
-		}
-	}
-	int_str[0] = negative;
-	int_str[8] = ' ';
-	return int_str;
+char* int_str(char* str, int integer, char* unit){
+	return SSD1306_FormatFixed(str, integer, 0, unit);
 }
 
 /**
@@ -260,17 +814,8 @@ void SSD1306_SetCursor(ssd1306_t* ssd1306, int position) {
 
 }
 
-/**
- * @brief  Puts integer to internal RAM
- * @note   @ref If the number has mora than 6 digits, displays OVERLOAD
- * @param  data: integer to be written
- * @param  unit: unit of the value, 2 char array (NO, MV, V, MA, A, "uV", "ms", etc.)
- * @param  slot: slot to be used. 1, 2, and 3 are large slots. 4 and 5 are small slots
- */
-void SSD1306_Putint(ssd1306_t* ssd1306, int data, char* unit, uint8_t slot) {
-
-	char* integer_str = int_str(data, unit);
-	uint16_t x_slot = 2;
+/* Writes a formatted number into one of the 5 slots */
+static void ssd1306_PutSlot(ssd1306_t* ssd1306, char* str, uint16_t x_slot, uint8_t slot) {
 	uint16_t y_slot = 0;
 	FontDef_t font = Font_11x18;
 	switch (slot) {
@@ -296,60 +841,58 @@ void SSD1306_Putint(ssd1306_t* ssd1306, int data, char* unit, uint8_t slot) {
 	SSD1306_GotoXY (ssd1306, x_slot,y_slot);
 	SSD1306_Puts (ssd1306, "         ", &font, 1);
 	SSD1306_GotoXY (ssd1306, x_slot,y_slot);
-	SSD1306_Puts (ssd1306, integer_str, &font, 1);
+	SSD1306_Puts (ssd1306, str, &font, 1);
+}
+
+/**
+ * @brief  Puts integer to internal RAM
+ * @note   @ref If the number has more than 7 digits, displays OVERLOAD
+ * @param  data: integer to be written
+ * @param  unit: unit of the value, 2 char array (NO, MV, V, MA, A, "uV", "ms", etc.)
+ * @param  slot: slot to be used. 1, 2, and 3 are large slots. 4 and 5 are small slots
+ */
+void SSD1306_Putint(ssd1306_t* ssd1306, int data, char* unit, uint8_t slot) {
+	char str[SSD1306_NUMBER_LENGTH];
+
+	ssd1306_PutSlot(ssd1306, int_str(str, data, unit), 2, slot);
+}
+
+/**
+ * @brief  Puts fixed-point number to internal RAM
+ * @note   @ref If the number has more than 6 digits, displays OVERLOAD
+ * @param  data: number scaled by 10^decimals (1234 with 2 decimals is 12.34)
+ * @param  decimals: number of decimals to be represented
+ * @param  unit: unit of the value, 2 char array (NO, MV, V, MA, A, "uV", "ms", etc.)
+ * @param  slot: slot to be used. 1, 2, and 3 are large slots. 4 and 5 are small slots
+ */
+void SSD1306_Putfixed(ssd1306_t* ssd1306, int32_t data, uint8_t decimals, char* unit, uint8_t slot) {
+	char str[SSD1306_NUMBER_LENGTH];
+
+	ssd1306_PutSlot(ssd1306, SSD1306_FormatFixed(str, data, decimals, unit), 1, slot);
 }
 
 /**
  * @brief  Represents a double number with a char array
+ * @param  str: caller buffer of SSD1306_NUMBER_LENGTH chars
  * @param  number: double to be represented
  * @param  decimals: number of decimals to be represented
  * @param  unit: unit of the value, 2 char array (NO, MV, V, MA, A, "uV", "ms", etc.)
  * @retval Char array containing a char for each digit
  */
-char* double_str(double number, uint8_t decimals, char* unit){
-
-	uint8_t negative = ' ';
-	if (number < 0) {
-		number = -number;
-		negative = '-';
-	}
+char* double_str(char* str, double number, uint8_t decimals, char* unit){
+	static const int32_t scale[] = {1, 10, 100, 1000, 10000, 100000, 1000000};
 
-	number = round(number*pow(10, decimals));
-	uint8_t size;
-	if (number == 0){
-		size = decimals+1;
-	} else {
-		size = SSD1306_digits(number);
+	if (decimals >= sizeof(scale) / sizeof(scale[0])) {
+		strcpy(str, "OVERLOAD");
+		return str;
 	}
-	if (size > 6) {
-		return "OVERLOAD";
+	number *= scale[decimals];
+	/* Anything past 7 digits overloads, keep the conversion in range */
+	if (number >= 10000000.0 || number <= -10000000.0) {
+		strcpy(str, "OVERLOAD");
+		return str;
 	}
-
-	char data_char[size];
-	if (number == 0){
-		for(uint8_t i=0;i<size;i++){
-			data_char[i]='0';
-		}
-	} else {
-		sprintf(data_char,"%d", (int)number);
-	}
-
-	static char double_str[11];
-	for(int8_t i=1; i<11; i++){
-		if (i < (size-decimals+1)){
-			double_str[i] = data_char[i-1];
-		} else if (i < size+2){
-			double_str[i] = data_char[i-2];
-		} else if (i < 11-2){
-			double_str[i] = ' ';
-		} else {
-			double_str[i] = unit[i-9];
-		}
-	}
-	double_str[0] = negative;
-	double_str[size-decimals+1] = '.';
-	double_str[8] = ' ';
-	return double_str;
+	return SSD1306_FormatFixed(str, (int32_t)(number + ((number < 0) ? -0.5 : 0.5)), decimals, unit);
 }
 
 /**
@@ -361,36 +904,9 @@ char* double_str(double number, uint8_t decimals, char* unit){
  * @param  slot: slot to be used. 1, 2, and 3 are large slots. 4 and 5 are small slots
  */
 void SSD1306_Putdouble(ssd1306_t* ssd1306, double data, uint8_t decimals, char* unit, uint8_t slot) {
-	char* float_str = double_str(data, decimals, unit);
+	char str[SSD1306_NUMBER_LENGTH];
 
-	uint16_t x_slot = 1;
-	uint16_t y_slot = 0;
-	FontDef_t font = Font_11x18;
-	switch (slot) {
-	case 1:
-		y_slot = 0;
-		break;
-	case 2:
-		y_slot = 17;
-		break;
-	case 3:
-		y_slot = 34;
-		break;
-	case 4:
-		y_slot = 53;
-		font = Font_7x10;
-		break;
-	case 5:
-		x_slot = 65;
-		y_slot = 53;
-		font = Font_7x10;
-		break;
-	}
-
-	SSD1306_GotoXY (ssd1306, x_slot,y_slot);
-	SSD1306_Puts (ssd1306, "         ", &font, 1);
-	SSD1306_GotoXY (ssd1306, x_slot,y_slot);
-	SSD1306_Puts (ssd1306, float_str, &font, 1);
+	ssd1306_PutSlot(ssd1306, double_str(str, data, decimals, unit), 1, slot);
 }
 
 /**
@@ -399,12 +915,12 @@ void SSD1306_Putdouble(ssd1306_t* ssd1306, double data, uint8_t decimals, char*
  * @retval Number of digits in an integer
  */
 uint8_t SSD1306_digits(int integer){
-	uint8_t digits;
-	if (integer==0){
-		digits = 1;
-	}
-	else {
-		digits = floor(log10(integer))+1;
+	uint8_t digits = 1;
+	uint32_t magnitude = (integer < 0) ? -(uint32_t)integer : (uint32_t)integer;
+
+	while (magnitude >= 10) {
+		magnitude /= 10;
+		digits++;
 	}
 	return digits;
 }
@@ -436,18 +952,15 @@ char SSD1306_Puts(ssd1306_t* ssd1306, char* str, FontDef_t* Font, SSD1306_COLOR_
 //
 /////////////////////////////////////////////////////////////////////////////////////////////////////////
 
-void ssd1306_I2C_WriteMulti(ssd1306_t* ssd1306, uint8_t reg, uint8_t* data, uint16_t count) {
-	uint8_t dt[count + 1];
-	dt[0] = reg;
-	uint8_t i;
-	for(i = 1; i <= count; i++)
-		dt[i] = data[i-1];
-	HAL_I2C_Master_Transmit(ssd1306->hi2c, ssd1306->addr, dt, count, 10);
+HAL_StatusTypeDef ssd1306_I2C_WriteMulti(ssd1306_t* ssd1306, uint8_t reg, uint8_t* data, uint16_t count) {
+	if (ssd1306->Write != NULL) {
+		return ssd1306->Write(ssd1306->WriteContext, ssd1306->addr, reg, data, count);
+	}
+	/* The control byte goes out in the memory address phase, the data is sent in place.
+	 * The timeout allows a whole frame at 100 kHz */
+	return HAL_I2C_Mem_Write(ssd1306->hi2c, ssd1306->addr, reg, I2C_MEMADD_SIZE_8BIT, data, count, 10 + count / 8);
 }
 
 void ssd1306_I2C_Write(ssd1306_t* ssd1306, uint8_t reg, uint8_t data) {
-	uint8_t dt[2];
-	dt[0] = reg;
-	dt[1] = data;
-	HAL_I2C_Master_Transmit(ssd1306->hi2c, ssd1306->addr, dt, 2, 10);
+	ssd1306_I2C_WriteMulti(ssd1306, reg, &data, 1);
 }
@@ -1,6 +1,15 @@
 #include "main.h"
 
-void lcd_init (void);   // initialize lcd
+// lcd_init_process() states
+#define LCD_INIT_BUSY 0
+#define LCD_INIT_READY 1
+#define LCD_INIT_FAILED 2
+
+void lcd_init (void);   // initialize lcd, blocks for about 63 ms, or until the lcd fails for 100 ms
+
+void lcd_init_start (void (*ready)(uint8_t ok));  // start initialising in the background, ready can be NULL
+
+uint8_t lcd_init_process (void);  // send the init steps that are due, call it every ms from the main loop
 
 void lcd_send_cmd (char cmd);  // send command to the lcd
 
@@ -6,6 +6,32 @@ extern I2C_HandleTypeDef hi2c1;  // change your handler here accordingly
 
 #define SLAVE_ADDRESS_LCD 0x4E // change this according to ur setup
 
+// until 4 bit mode the lcd takes every EN pulse as a whole command, so only the high nibble is sent
+#define LCD_NIBBLE 2  // expander bytes of a nibble: EN high, EN low
+#define LCD_BYTE 4    // expander bytes of a command in 4 bit mode
+
+// a step still failing this long after it was due ends the initialisation
+#define LCD_INIT_RETRY_MS 100
+
+// init sequence: command, minimum wait in ms before the next one, expander bytes sent
+static const uint8_t init_steps[][3] = {
+	{0x30, 5, LCD_NIBBLE},  // wait for >4.1ms
+	{0x30, 1, LCD_NIBBLE},  // wait for >100us
+	{0x30, 1, LCD_NIBBLE},
+	{0x20, 1, LCD_NIBBLE},  // 4bit mode
+	{0x28, 1, LCD_BYTE},  // Function set --> DL=0 (4 bit mode), N = 1 (2 line display) F = 0 (5x8 characters)
+	{0x08, 1, LCD_BYTE},  // Display on/off control --> D=0,C=0, B=0  ---> display off
+	{0x01, 2, LCD_BYTE},  // clear display
+	{0x06, 1, LCD_BYTE},  // Entry mode set --> I/D = 1 (increment cursor) & S = 0 (no shift)
+	{0x0C, 0, LCD_BYTE},  // Display on/off control --> D = 1, C and B = 0. (Cursor and blink, last two bits)
+};
+
+static uint8_t init_state = LCD_INIT_FAILED;
+static uint8_t init_step;
+static uint8_t init_wait;
+static uint32_t init_tick;
+static void (*init_ready)(uint8_t ok);
+
 void lcd_send_cmd (char cmd)
 {
   char data_u, data_l;
@@ -43,28 +69,53 @@ void lcd_clear (void)
 
 void lcd_init (void)
 {
-	// 4 bit initialisation
-	HAL_Delay(50);  // wait for >40ms
-	lcd_send_cmd (0x30);
-	HAL_Delay(5);  // wait for >4.1ms
-	lcd_send_cmd (0x30);
-	HAL_Delay(1);  // wait for >100us
-	lcd_send_cmd (0x30);
-	HAL_Delay(10);
-	lcd_send_cmd (0x20);  // 4bit mode
-	HAL_Delay(10);
+	lcd_init_start (NULL);
+	while (lcd_init_process () == LCD_INIT_BUSY);
+}
+
+void lcd_init_start (void (*ready)(uint8_t ok))
+{
+	init_ready = ready;
+	init_step = 0;
+	init_wait = 50;  // wait for >40ms after power on
+	init_tick = HAL_GetTick();
+	init_state = LCD_INIT_BUSY;
+}
 
-  // dislay initialisation
-	lcd_send_cmd (0x28); // Function set --> DL=0 (4 bit mode), N = 1 (2 line display) F = 0 (5x8 characters)
-	HAL_Delay(1);
-	lcd_send_cmd (0x08); //Display on/off control --> D=0,C=0, B=0  ---> display off
-	HAL_Delay(1);
-	lcd_send_cmd (0x01);  // clear display
-	HAL_Delay(1);
-	HAL_Delay(1);
-	lcd_send_cmd (0x06); //Entry mode set --> I/D = 1 (increment cursor) & S = 0 (no shift)
-	HAL_Delay(1);
-	lcd_send_cmd (0x0C); //Display on/off control --> D = 1, C and B = 0. (Cursor and blink, last two bits)
+uint8_t lcd_init_process (void)
+{
+	uint8_t data_t[4];
+	char data_u, data_l;
+
+	// strictly greater, so at least init_wait whole ms have passed
+	while (init_state == LCD_INIT_BUSY && HAL_GetTick() - init_tick > init_wait)
+	{
+		data_u = (init_steps[init_step][0]&0xf0);
+		data_l = ((init_steps[init_step][0]<<4)&0xf0);
+		data_t[0] = data_u|0x0C;  //en=1, rs=0
+		data_t[1] = data_u|0x08;  //en=0, rs=0
+		data_t[2] = data_l|0x0C;  //en=1, rs=0
+		data_t[3] = data_l|0x08;  //en=0, rs=0
+		if (HAL_I2C_Master_Transmit (&hi2c1, SLAVE_ADDRESS_LCD,(uint8_t *) data_t, init_steps[init_step][2], 2) != HAL_OK)
+		{
+			// a NACK means there is no lcd, anything else is retried on the next call until the deadline
+			if ((HAL_I2C_GetError(&hi2c1) & HAL_I2C_ERROR_AF) ||
+					HAL_GetTick() - init_tick > init_wait + LCD_INIT_RETRY_MS)
+			{
+				init_state = LCD_INIT_FAILED;
+				if (init_ready) init_ready (0);
+			}
+			break;
+		}
+		init_tick = HAL_GetTick();
+		init_wait = init_steps[init_step][1];
+		if (++init_step == sizeof(init_steps) / sizeof(init_steps[0]))
+		{
+			init_state = LCD_INIT_READY;
+			if (init_ready) init_ready (1);
+		}
+	}
+	return init_state;
 }
 
 void lcd_send_string (char *str)
@@ -43,7 +43,7 @@
 I2C_HandleTypeDef hi2c1;
 
 /* USER CODE BEGIN PV */
-
+uint8_t lcd_ok = 0;
 /* USER CODE END PV */
 
 /* Private function prototypes -----------------------------------------------*/
@@ -51,7 +51,7 @@ void SystemClock_Config(void);
 static void MX_GPIO_Init(void);
 static void MX_I2C1_Init(void);
 /* USER CODE BEGIN PFP */
-
+static void lcd_ready(uint8_t ok);
 /* USER CODE END PFP */
 
 /* Private user code ---------------------------------------------------------*/
@@ -89,7 +89,10 @@ int main(void)
   MX_GPIO_Init();
   MX_I2C1_Init();
   /* USER CODE BEGIN 2 */
-	lcd_init();
+	// the lcd finishes initialising from the main loop, the other peripherals can start meanwhile
+	lcd_init_start(lcd_ready);
+	uint32_t blink_tick = HAL_GetTick();
+	uint8_t blink = 0;
 
 //	lcd_send_cmd (0x80|0x00);
 //	lcd_send_string("1");
@@ -109,12 +112,14 @@ int main(void)
   /* USER CODE BEGIN WHILE */
   while (1)
   {
-		lcd_send_cmd (0x80|0x00);
-		lcd_send_string("1");
-		HAL_Delay(600);
-		lcd_send_cmd (0x80|0x00);
-		lcd_send_string("8");
-		HAL_Delay(600);
+		lcd_init_process();
+		if (lcd_ok && HAL_GetTick() - blink_tick >= 600)
+		{
+			blink_tick = HAL_GetTick();
+			lcd_send_cmd (0x80|0x00);
+			lcd_send_string(blink ? "8" : "1");
+			blink = !blink;
+		}
     /* USER CODE END WHILE */
 
     /* USER CODE BEGIN 3 */
@@ -216,7 +221,15 @@ static void MX_GPIO_Init(void)
 }
 
 /* USER CODE BEGIN 4 */
-
+/**
+  * @brief  End of the lcd initialisation
+  * @param  ok: 0 if the lcd did not answer
+  * @retval None
+  */
+static void lcd_ready(uint8_t ok)
+{
+	lcd_ok = ok;
+}
 /* USER CODE END 4 */
 
 /**
@@ -55,6 +55,7 @@ typedef struct {
 	uint8_t FontWidth;    /*!< Font width in pixels */
 	uint8_t FontHeight;   /*!< Font height in pixels */
 	const uint16_t *data; /*!< Pointer to data font data array */
+	const uint32_t *columns; /*!< Pointer to the same glyphs transposed to columns (bit n is row n), NULL if not available */
 } FontDef_t;
 
 /** 
@@ -0,0 +1,191 @@
+#ifndef I2C_BUS_H
+#define I2C_BUS_H
+
+#include "main.h"
+#include "cmsis_os.h"
+#include <string.h>
+
+/*
+ *  Shared I2C bus manager: a task owns the I2C handle and serves the
+ *  write requests of every driver connected to it, by priority.
+ */
+
+#define I2C_BUS_QUEUE_SIZE		16		/* Requests waiting on each priority */
+#define I2C_BUS_INLINE_SIZE		8		/* Writes up to this size are copied and posted */
+#define I2C_BUS_BATCH_SIZE		32		/* Posted writes merged in a single transfer */
+#define I2C_BUS_CHUNK_SIZE		128		/* Memory writes are split so higher priorities can go in between */
+#define I2C_BUS_TIMEOUT			100		/* Time allowed to each transfer (ms) */
+
+#define I2C_BUS_NO_MEM			0xFFFF	/* Write without memory address (control byte) phase */
+
+// thread flags
+#define I2C_BUS_FLAG_REQUEST	0x0001U	/* Bus task: a request was queued */
+#define I2C_BUS_FLAG_DONE		0x0002U	/* Bus task: transfer finished */
+#define I2C_BUS_FLAG_ERROR		0x0004U	/* Bus task: transfer failed */
+#define I2C_BUS_FLAG_CLIENT		0x4000U	/* Client task: its blocking write finished */
+
+/**
+ * @brief  Request priorities, served from the highest
+ */
+typedef enum {
+	I2C_BUS_PRIO_HIGH = 0,
+	I2C_BUS_PRIO_NORMAL,
+	I2C_BUS_PRIO_LOW,
+	I2C_BUS_PRIOS
+} i2c_bus_prio_t;
+
+/**
+ * @brief  i2c_bus_client_t struct, one for each driver using the bus
+ */
+typedef struct i2c_bus_client_t {
+	const char* name;
+	struct i2c_bus_t* bus;
+	uint8_t priority;
+	uint32_t requests;		/*!< Writes completed */
+	uint32_t bytes;			/*!< Payload bytes written */
+	uint32_t errors;		/*!< Writes failed or rejected */
+	uint32_t latency_max;	/*!< Longest time from request to end of transfer (us) */
+	uint64_t latency_sum;	/*!< Sum of the latencies, divide by requests for the mean (us) */
+	uint64_t busy_time;		/*!< Bus time used (us) */
+} i2c_bus_client_t;
+
+/**
+ * @brief  i2c_bus_request_t struct, queued by value
+ */
+typedef struct {
+	i2c_bus_client_t* client;
+	uint16_t addr;
+	uint16_t mem;
+	uint8_t* data;					/* Caller data of blocking writes and reads */
+	uint16_t size;
+	uint8_t read;					/* Read from the device instead of writing */
+	uint16_t sent;
+	uint32_t enqueued;				/* Cycle counter when queued */
+	osThreadId_t waiter;			/* Task blocked on the write, NULL if posted */
+	HAL_StatusTypeDef* status;
+	uint8_t inline_data[I2C_BUS_INLINE_SIZE];
+} i2c_bus_request_t;
+
+/**
+ * @brief  i2c_bus_t struct
+ */
+typedef struct i2c_bus_t {
+	I2C_HandleTypeDef *hi2c;
+	osThreadId_t thread_id;
+	osMessageQueueId_t queue[I2C_BUS_PRIOS];
+	i2c_bus_request_t head[I2C_BUS_PRIOS];	/* Oldest request of each priority, taken from its queue */
+	uint8_t head_valid[I2C_BUS_PRIOS];
+	uint8_t batch[I2C_BUS_BATCH_SIZE];
+	uint32_t transfers;		/*!< Bus transactions */
+	uint32_t batched;		/*!< Posted writes merged into the transaction of a previous one */
+	uint64_t busy_time;		/*!< Bus time since the statistics reset (us) */
+	uint32_t stats_start;	/*!< Kernel tick of the statistics reset */
+} i2c_bus_t;
+
+
+/**	--- Initialization functions --- **/
+
+
+/**
+ * @brief  Initializes the bus manager
+ * @note   Call it after osKernelInitialize(), then run @ref i2c_bus_Run() from a task
+ *         with a higher priority than its clients
+ * @param  bus: bus manager
+ * @param  *hi2c: I2C peripheral owned by the manager. Transfers use DMA when hdmatx is linked
+ * @retval Initialization status:
+ *           - 0: The request queues could not be created
+ *           - 1: Bus manager ready
+ */
+uint8_t i2c_bus_Init(i2c_bus_t* bus, I2C_HandleTypeDef *hi2c);
+
+/**
+ * @brief  Connects a driver to the bus manager
+ * @param  bus: bus manager
+ * @param  client: statistics and priority of the driver
+ * @param  name: name shown in the statistics
+ * @param  priority: priority of the driver requests
+ * @retval None
+ */
+void i2c_bus_Client(i2c_bus_t* bus, i2c_bus_client_t* client, const char* name, i2c_bus_prio_t priority);
+
+
+/**	--- Interface functions --- **/
+
+
+/**
+ * @brief  Writes to a device through the bus manager
+ * @note   Writes up to I2C_BUS_INLINE_SIZE bytes are copied and posted: the function returns
+ *         at once and consecutive posted writes to the same device are merged. Longer writes
+ *         block the calling task until they are sent. Before the scheduler starts, the write
+ *         is done directly with HAL
+ * @param  client: i2c_bus_client_t of the driver
+ * @param  addr: I2C address of the device
+ * @param  mem: memory address (control byte) sent before the data, or I2C_BUS_NO_MEM
+ * @param  *data: data to be written
+ * @param  size: number of bytes
+ * @retval HAL status of the write (HAL_OK once queued for posted writes)
+ */
+HAL_StatusTypeDef i2c_bus_MemWrite(void* client, uint16_t addr, uint16_t mem, uint8_t* data, uint16_t size);
+
+/**
+ * @brief  Writes to a device without memory address phase, see @ref i2c_bus_MemWrite()
+ */
+HAL_StatusTypeDef i2c_bus_Write(void* client, uint16_t addr, uint8_t* data, uint16_t size);
+
+/**
+ * @brief  Reads from a device through the bus manager, blocking the calling task
+ * @note   The read is queued behind the writes of the same client, so it also waits
+ *         for its posted writes to be sent
+ * @param  client: i2c_bus_client_t of the driver
+ * @param  addr: I2C address of the device
+ * @param  *data: buffer for the data read
+ * @param  size: number of bytes
+ * @retval HAL status of the read
+ */
+HAL_StatusTypeDef i2c_bus_Read(void* client, uint16_t addr, uint8_t* data, uint16_t size);
+
+/**
+ * @brief  Serves the requests, never returns
+ * @param  bus: bus manager
+ * @retval None
+ */
+void i2c_bus_Run(i2c_bus_t* bus);
+
+/**
+ * @brief  Call it from HAL_I2C_MasterTxCpltCallback() and HAL_I2C_MemTxCpltCallback()
+ * @param  *hi2c: I2C handle whose transfer has finished
+ * @retval None
+ */
+void i2c_bus_TxCpltCallback(i2c_bus_t* bus, I2C_HandleTypeDef *hi2c);
+
+/**
+ * @brief  Call it from HAL_I2C_MasterRxCpltCallback()
+ * @param  *hi2c: I2C handle whose transfer has finished
+ * @retval None
+ */
+void i2c_bus_RxCpltCallback(i2c_bus_t* bus, I2C_HandleTypeDef *hi2c);
+
+/**
+ * @brief  Call it from HAL_I2C_ErrorCallback()
+ * @param  *hi2c: I2C handle that reported the error
+ * @retval None
+ */
+void i2c_bus_ErrorCallback(i2c_bus_t* bus, I2C_HandleTypeDef *hi2c);
+
+/**
+ * @brief  Bus utilisation since the statistics reset
+ * @param  bus: bus manager
+ * @retval Time the bus was transferring, per mille
+ */
+uint16_t i2c_bus_Utilisation(i2c_bus_t* bus);
+
+/**
+ * @brief  Clears the statistics of the bus and of the given clients
+ * @param  bus: bus manager
+ * @param  clients: array of clients, NULL to only clear the bus statistics
+ * @param  n_clients: number of clients
+ * @retval None
+ */
+void i2c_bus_ResetStats(i2c_bus_t* bus, i2c_bus_client_t** clients, uint8_t n_clients);
+
+#endif
@@ -3,6 +3,7 @@
 
 #include "main.h"
 #include <stdlib.h>
+#include "lcd_pcf8574.h"
 
 /*
  *  HD44780 datasheet
@@ -54,6 +55,22 @@
 #define Rw B00000010  // Read/Write bit
 #define Rs B00000001  // Register select bit
 
+#define LCD_I2C_STREAM_CHARS	20	/* Characters sent in a single I2C transaction */
+
+#define LCD_I2C_POWER_ON_MS		50		/* Wait after power on before the first command (>40 ms) */
+#define LCD_I2C_STEP_TIMEOUT	2		/* I2C timeout of an init step in ms, a 4 byte write takes 0.1 ms */
+#define LCD_I2C_RETRY_MS		100		/* A step still failing this long after it was due ends the initialization */
+
+// initialization states
+#define LCD_I2C_INIT_BUSY		0
+#define LCD_I2C_INIT_READY		1
+#define LCD_I2C_INIT_FAILED		2
+
+struct lcd_i2c_t;
+
+/* Called once the initialization ends, ok is 0 if the display did not answer */
+typedef void (*lcd_i2c_ready_t)(struct lcd_i2c_t* lcd_i2c, uint8_t ok);
+
 
 /**
  * @brief  lcd_i2c_RTOS_t struct
@@ -65,6 +82,11 @@ typedef struct lcd_i2c_t{
 	uint8_t n_lines;
 	uint8_t display_control;
 	uint8_t display_mode;
+	uint8_t init_state;					/* LCD_I2C_INIT_BUSY, _READY or _FAILED */
+	uint8_t init_step;					/* Next step of the initialization table */
+	uint8_t init_wait;					/* ms to wait after the last step sent */
+	uint32_t init_tick;					/* HAL tick at which the last step was sent */
+	lcd_i2c_ready_t ready;				/* End of initialization callback, can be NULL */
 } lcd_i2c_t;
 
 
@@ -73,7 +95,7 @@ typedef struct lcd_i2c_t{
 
 /**
  * @brief  Creates lcd_i2c variable corresponding to the display
- * @note   Execution time is 81 ms (lcd_i2c_Init function)
+ * @note   Execution time is 72 ms (lcd_i2c_Init function)
  * @param  *hi2c: I2C peripheral used by the mcu
  * @param  addr: I2C address corresponding to the targeted display
  * @param  n_chars: number of the diaplay columns, or chars (16 or 20)
@@ -88,7 +110,8 @@ lcd_i2c_t* lcd_i2c_new(I2C_HandleTypeDef *hi2c, uint8_t addr, uint8_t n_chars, u
 
 /**
  * @brief  Initializes Liquid Crystal LCD display
- * @note   Execution time is 81 ms
+ * @note   Execution time is 72 ms, runs lcd_i2c_Init_Start() and lcd_i2c_Init_Process()
+ * 		   until the end of the sequence
  * @param  lcd_i2c variable targeting the desired display
  * @param  *hi2c: I2C peripheral used by the MCU
  * @param  addr: I2C address corresponding to the targeted display
@@ -100,6 +123,32 @@ lcd_i2c_t* lcd_i2c_new(I2C_HandleTypeDef *hi2c, uint8_t addr, uint8_t n_chars, u
  */
 uint8_t lcd_i2c_Init(lcd_i2c_t* lcd_i2c, I2C_HandleTypeDef *hi2c, uint8_t addr, uint8_t n_chars, uint8_t n_lines);
 
+/**
+ * @brief  Starts the initialization of the display in the background
+ * @note   Returns at once, the power on wait and the commands are run by
+ * 		   lcd_i2c_Init_Process(). The display must not be written before the
+ * 		   ready callback
+ * @param  lcd_i2c variable targeting the desired display
+ * @param  *hi2c: I2C peripheral used by the MCU
+ * @param  addr: I2C address corresponding to the targeted display
+ * @param  n_chars: number of the display columns, or chars (16 or 20)
+ * @param  n_lines: number of the display lines (usually 1, 2, or 4)
+ * @param  ready: called at the end of the initialization, can be NULL
+ * @retval None
+ */
+void lcd_i2c_Init_Start(lcd_i2c_t* lcd_i2c, I2C_HandleTypeDef *hi2c, uint8_t addr, uint8_t n_chars, uint8_t n_lines,
+		lcd_i2c_ready_t ready);
+
+/**
+ * @brief  Sends the initialization steps that are due
+ * @note   Call it every ms or so from thread context (main loop, RTOS timer), it
+ * 		   never waits for the display. The first command doubles as the presence
+ * 		   check: a NACK ends the initialization as failed
+ * @param  lcd_i2c variable targeting the desired display
+ * @retval LCD_I2C_INIT_BUSY, LCD_I2C_INIT_READY or LCD_I2C_INIT_FAILED
+ */
+uint8_t lcd_i2c_Init_Process(lcd_i2c_t* lcd_i2c);
+
 /**
  * @brief  Transmits a command through I2C protocol
  * @note   Execution time is considered 0
@@ -128,7 +177,7 @@ void lcd_i2c_send_data (lcd_i2c_t* lcd_i2c, char data);  // send data to the lcd
  * @param  line: line at which the string will be displayed (1, 2, or 4)
  * @param  col: column at which the string will start to be displayed (under 16 or under 20)
  * @retval Write status:
- * 				0: line or column out of the display
+ * 				0: line or column out of the display, or display not initialized
  * 				1: string sent correctly
  */
 uint8_t lcd_i2c_Write(lcd_i2c_t* lcd_i2c, uint8_t line, uint8_t col, char *str);
@@ -3,7 +3,9 @@
 
 #include "main.h"
 #include <stdlib.h>
+#include <string.h>
 #include "cmsis_os.h"
+#include "lcd_pcf8574.h"
 #include <math.h>
 
 /*
@@ -58,37 +60,122 @@
 
 #define BUFFER_SIZE 	100
 
+#define LCD_MAX_LINES		4
+#define LCD_MAX_CHARS		20
+#define LCD_MESSAGE_BYTES	LCD_PCF8574_BYTES	/* I2C bytes of a message */
+#define LCD_JUMP_GAP		1		/* Unchanged characters rewritten instead of jumping over them */
+#define LCD_ADDRESS_UNKNOWN	0xFF
+#define LCD_STREAM_CHARS	20		/* Messages expanded into a single I2C transaction */
+
+#define LCD_EXE_UNIT_US		20		/* Resolution of the stored execution times */
+#define LCD_EXE_SHORT_US	0		/* 37 us commands, covered by the I2C time of the next message */
+#define LCD_EXE_CLEAR_US	1520	/* Clear display and return home */
+#define LCD_EXE_POWER_UP_US	40000	/* Power up of the display before the first instruction */
+#define LCD_EXE_POWER_ON_US	4100	/* First function set of the reset sequence */
+#define LCD_EXE_RESET_US	100		/* Other function sets of the reset sequence */
+#define LCD_BUSY_SPIN_US	200		/* Shorter waits are spun instead of waiting for the next tick */
+#define LCD_BUSY_POLLS		8		/* Busy flag reads in a row, then one per tick */
+#define LCD_BUSY_MARGIN_US	1000	/* A flag still busy this long after the execution time cannot be read */
+
+#define LCD_FLAG_MESSAGE	0x0001	/* Thread flag set by the producers when the buffer was empty */
+#define LCD_FLAG_SPACE		0x0002	/* Thread flag set by the consumer for a producer waiting for space */
+
+#define LCD_WRITE_FAILFAST	0		/* Nothing is queued if the update does not fit */
+#define LCD_WRITE_BLOCK		1		/* Waits for room up to the timeout */
+#define LCD_WRITE_REPLACE	2		/* Drops the pending update of the line, then waits as LCD_WRITE_BLOCK */
+
+#define LCD_LATENCY_SHIFT	4		/* Enqueue stamps in 16 us steps, wrapping after 1 s */
+#define LCD_LATENCY_BASE_US	64		/* Upper bound of the first latency bucket */
+#define LCD_LATENCY_BUCKETS	12		/* Each bucket doubles the bound, the last one has no bound */
+
+#define LCD_BUSY_TIMER	0		/* Execution times counted with the DWT cycle counter */
+#define LCD_BUSY_FLAG	1		/* Busy flag read back through the expander, needs RW wired */
+
+#define LCD_CGRAM_SLOTS		8		/* Custom glyphs, shown by the character codes 8 to 15 */
+#define LCD_GLYPH_ROWS		8		/* Rows of a 5x8 glyph, 5 low bits used */
+#define LCD_GLYPH_CODE		0x08	/* Character code of the first slot, 0 ends the strings */
+
 #define MODE_DATA 		0
 #define MODE_COMMAND 	1
+#define MODE_INIT		2		/* Command of the reset sequence, the busy flag cannot be read yet */
 
 #define CLEAR_OFF		0
 #define CLEAR_ON		1
 
 /**
- * @brief  lcd_message_t struct
+ * @brief  lcd_message_t struct, 6 bytes stored by value in the message ring
  */
 typedef struct lcd_message_t {
 	uint8_t message;
 	uint8_t exe_time;
 	uint8_t mode;
-    struct lcd_message_t* next_msg;
-    struct lcd_message_t* prev_msg;
+	uint16_t enqueued;		/* Cycle counter in LCD_LATENCY_SHIFT us steps when queued */
 } lcd_message_t;
 
+/**
+ * @brief  lcd_cgram_t struct, glyphs resident in the CGRAM of a display
+ */
+typedef struct lcd_cgram_t {
+	uint8_t glyph[LCD_CGRAM_SLOTS][LCD_GLYPH_ROWS];	/* Bitmap uploaded to each slot */
+	uint8_t lru[LCD_CGRAM_SLOTS];			/* Slots from the most to the least recently used */
+	uint8_t valid;							/* Slots holding a glyph, one bit each */
+	uint8_t locked;							/* Slots handed out since the last release */
+	uint32_t hits;							/*!< Glyphs found resident */
+	uint32_t misses;						/*!< Glyphs uploaded */
+} lcd_cgram_t;
+
+/**
+ * @brief  lcd_update_t struct, last line update queued, kept so it can be replaced
+ */
+typedef struct lcd_update_t {
+	uint8_t valid;
+	uint8_t line;
+	uint8_t start;							/* Buffer index of its first message */
+	uint8_t end;							/* Buffer head once it was queued */
+	uint8_t address;						/* Shadow address before it */
+	char ddram[LCD_MAX_CHARS];				/* Shadow of the line before it */
+} lcd_update_t;
+
 /**
  * @brief  lcd_i2c_RTOS_t struct
  */
 typedef struct lcd_i2c_RTOS_t{
 	uint8_t addr;
 	I2C_HandleTypeDef *hi2c;
+	HAL_StatusTypeDef (*write)(void* context, uint16_t addr, uint8_t* data, uint16_t size); /* Shared bus write, NULL to use hi2c directly */
+	HAL_StatusTypeDef (*read)(void* context, uint16_t addr, uint8_t* data, uint16_t size); /* Shared bus read, NULL to use hi2c directly */
+	void* write_context;
 	uint8_t n_chars;
 	uint8_t n_lines;
+	uint8_t line_address[LCD_MAX_LINES];	/* DDRAM address of the first character of each line */
 	uint8_t display_control;
 	uint8_t display_mode;
-	lcd_message_t* buffer_first_msg;
-	lcd_message_t* buffer_last_msg;
-	uint8_t n_messages;
-	osThreadId_t thread_id;
+	/* Single producer (the writer task), single consumer (StartlcdSendMessages) */
+	lcd_message_t buffer[BUFFER_SIZE + 1];	/* One slot stays free to tell full from empty */
+	volatile uint8_t buffer_head;			/* Next slot written, only moved by the producer */
+	volatile uint8_t buffer_tail;			/* Next slot transmitted, only moved by the consumer */
+	volatile uint8_t sending_end;			/* End of the run being transmitted */
+	osThreadId_t volatile space_waiter;		/* Producer waiting for space_needed free slots */
+	uint8_t space_needed;
+	lcd_update_t last_update;
+	uint32_t updates_replaced;				/*!< Updates dropped before reaching the wire */
+	char ddram[LCD_MAX_LINES][LCD_MAX_CHARS];	/* Visible characters once the queued messages are sent */
+	uint8_t address;						/* DDRAM address once the queued messages are sent */
+	lcd_cgram_t cgram;
+	uint16_t update_bytes;					/*!< I2C bytes queued by the last write */
+	uint16_t update_bytes_saved;			/*!< I2C bytes the last write saved compared to rewriting the text */
+	uint8_t stream[LCD_STREAM_CHARS * LCD_PCF8574_BYTES];	/* Expander writes of the run being sent */
+	uint16_t run_exe_time;					/* Execution time of the last message sent (us) */
+	uint8_t run_busy_flag;					/* The busy flag can be read once the run has been sent */
+	uint8_t busy_mode;						/* LCD_BUSY_TIMER or LCD_BUSY_FLAG */
+	uint8_t busy_probe;						/* LCD_BUSY_FLAG asked for, the flag is checked after the next timed run */
+	uint32_t busy_flag_failures;			/*!< Busy flag found unreadable (RW tied low, read failed) */
+	uint8_t busy_polls;						/* Busy flag reads since the last run */
+	uint32_t busy_until;					/* Cycle count at which the last run has been executed */
+	uint32_t wake_tick;						/* Kernel tick at which the next run can be sent */
+	uint32_t latency_hist[LCD_LATENCY_BUCKETS];	/*!< Messages per enqueue to wire latency bucket */
+	uint32_t latency_max;					/*!< Longest enqueue to wire latency (us) */
+	osThreadId_t thread_id;					/* Service task, signalled by the producers */
 } lcd_i2c_RTOS_t;
 
 typedef enum {
@@ -106,12 +193,12 @@ typedef enum {
 /**
  * @brief  Creates lcd_message_t variable containing an instruction to be transmitted
  * @param  message: Message to be transmitted
- * @param  exe_time: Time needed by the display to execute the instruction (ms)
- * @param  mode: Message mode: MODE_COMMAND or MODE_DATA
- * @note   Execution time is converted into ticks depending on the tick frequency used by FreeRTOS
- * @retval lcd_message_t variable
+ * @param  exe_time: Time needed by the display to execute the instruction (us)
+ * @param  mode: Message mode: MODE_COMMAND, MODE_DATA or MODE_INIT
+ * @note   Execution time is stored in LCD_EXE_UNIT_US steps, rounded up
+ * @retval lcd_message_t value, to be copied into the buffer
  */
-lcd_message_t* lcd_i2c_RTOS_message_new(uint8_t message, uint8_t exe_time, uint8_t mode);
+lcd_message_t lcd_i2c_RTOS_message_new(uint8_t message, uint16_t exe_time, uint8_t mode);
 
 /**
  * @brief  Creates lcd_i2c_RTOS_t variable corresponding to the display on a FreeRTOS environment
@@ -141,11 +228,12 @@ lcd_i2c_RTOS_t* lcd_i2c_RTOS_new(I2C_HandleTypeDef *hi2c, uint8_t addr, uint8_t
  *           - 0: LCD was not detected on I2C port
  *           - 1: LCD initialized OK and ready to use
  */
-uint8_t lcd_i2c_RTOS_Init(lcd_i2c_RTOS_t* lcd_i2c_RTOS, I2C_HandleTypeDef *hi2c, uint8_t addr, uint8_t n_chars, uint8_t n_lines);
+LCD_StatusTypeDef lcd_i2c_RTOS_Init(lcd_i2c_RTOS_t* lcd_i2c_RTOS, I2C_HandleTypeDef *hi2c, uint8_t addr, uint8_t n_chars, uint8_t n_lines);
 
 /**
  * @brief  Reads the buffer, formats the message and transmits it through I2C protocol
- * @note   While the execution time of a message is 0, transmits another message
+ * @note   Messages with an execution time of 0 are sent together with the next one, up to
+ * 		   LCD_STREAM_CHARS, as a single stream of expander writes in one transaction
  * @param  lcd_i2c_RTOS: variable targeting the desired display
  * @param  mode: message mode: MODE_COMMAND or MODE_DATA
  * @retval Transmission status :
@@ -158,12 +246,12 @@ LCD_StatusTypeDef lcd_i2c_RTOS_Transmit(lcd_i2c_RTOS_t* lcd_i2c_RTOS);
  * @brief  Adds a command to the message buffer
  * @param  lcd_i2c_RTOS: variable targeting the desired display
  * @param  cmd: command to be added to the buffer
- * @param  exe_time: time needed by the display to  execute the command (ms)
+ * @param  exe_time: time needed by the display to  execute the command (us)
  * @retval Status:
  * 				0: The buffer is full
  * 				1: The command was added succesfully
  */
-LCD_StatusTypeDef lcd_i2c_RTOS_send_cmd (lcd_i2c_RTOS_t* lcd_i2c_RTOS, char cmd, uint8_t exe_time);
+LCD_StatusTypeDef lcd_i2c_RTOS_send_cmd (lcd_i2c_RTOS_t* lcd_i2c_RTOS, char cmd, uint16_t exe_time);
 
 /**
  * @brief  Adds a data byte to the message buffer
@@ -177,13 +265,78 @@ LCD_StatusTypeDef lcd_i2c_RTOS_send_cmd (lcd_i2c_RTOS_t* lcd_i2c_RTOS, char cmd,
 LCD_StatusTypeDef lcd_i2c_RTOS_send_data (lcd_i2c_RTOS_t* lcd_i2c_RTOS, char data);  // send data to the lcd
 
 
+/**
+ * @brief  Number of messages waiting in the buffer
+ * @param  lcd_i2c_RTOS: variable targeting the desired display
+ * @retval Messages not transmitted yet
+ */
+uint8_t lcd_i2c_RTOS_Pending(lcd_i2c_RTOS_t* lcd_i2c_RTOS);
+
+/**
+ * @brief  Upper bound of a latency histogram bucket
+ * @param  bucket: index in latency_hist
+ * @retval Latencies counted in the bucket are below this value (us), 0 for the last one
+ */
+uint32_t lcd_i2c_RTOS_Latency_Bound(uint8_t bucket);
+
+/**
+ * @brief  Clears the latency histogram and the maximum latency
+ * @param  lcd_i2c_RTOS: variable targeting the desired display
+ * @retval None
+ */
+void lcd_i2c_RTOS_Reset_Latency(lcd_i2c_RTOS_t* lcd_i2c_RTOS);
+
+/**
+ * @brief  Selects how the end of the slow commands is detected
+ * @note   LCD_BUSY_FLAG needs the RW pin of the display wired to the expander. The
+ * 		   driver keeps counting the execution times until a read, once the next timed
+ * 		   command has surely been executed, finds the flag idle. A flag that reads busy
+ * 		   there, or later past LCD_BUSY_MARGIN_US, or a failed read, sends the driver
+ * 		   back to LCD_BUSY_TIMER and counts busy_flag_failures
+ * @param  lcd_i2c_RTOS: variable targeting the desired display
+ * @param  busy_mode: LCD_BUSY_TIMER (default) or LCD_BUSY_FLAG
+ * @retval None
+ */
+void lcd_i2c_RTOS_Busy_Mode(lcd_i2c_RTOS_t* lcd_i2c_RTOS, uint8_t busy_mode);
+
+/**
+ * @brief  Checks whether the display has executed the last run sent
+ * @note   Waits shorter than LCD_BUSY_SPIN_US, or LCD_BUSY_POLLS busy flag reads,
+ * 		   are done here instead of waiting for the next tick
+ * @param  lcd_i2c_RTOS: variable targeting the desired display
+ * @retval 1 if the next run can be sent, 0 otherwise
+ */
+uint8_t lcd_i2c_RTOS_Ready(lcd_i2c_RTOS_t* lcd_i2c_RTOS);
+
+
 /**	--- Interface functions --- **/
 
-void lcd_i2c_RTOS_Handle_Messages(lcd_i2c_RTOS_t* lcd_i2c_RTOS);
+/**
+ * @brief  Sends the next buffered run if the display is ready for it
+ * @note   wake_tick holds the tick at which the next run can be tried
+ * @param  lcd_i2c_RTOS: variable targeting the desired display
+ * @retval Messages left in the buffer
+ */
+uint8_t lcd_i2c_RTOS_Handle_Messages(lcd_i2c_RTOS_t* lcd_i2c_RTOS);
+
+/**
+ * @brief  Serves the displays from a single task, never returns
+ * @note   Sends one run per display in turn, so a display executing a slow command
+ * 		   does not hold back the others. Sleeps until the earliest deadline of the
+ * 		   slow commands, or until LCD_FLAG_MESSAGE when a buffer was empty
+ * @param  displays: displays served by the calling task
+ * @param  n_displays: number of displays
+ * @retval None
+ */
+void lcd_i2c_RTOS_Service(lcd_i2c_RTOS_t** displays, uint8_t n_displays);
 
 /**
  * @brief  Send a string to the the buffer, so it can be displayed on a specific
  * 		   position of the display.
+ * @note   The line is compared with a shadow of the DDRAM and only the characters that
+ * 		   change are queued, all of them or none (LCD_WRITE_FAILFAST). Address jumps are only used when they cost less than
+ * 		   rewriting the unchanged characters in between. The I2C bytes are stored in
+ * 		   update_bytes and update_bytes_saved
  * @param  lcd_i2c_RTOS: pointer to lcd_i2c_RTOS structure containing the info
  * 		   for the specified display.
  * @param  line: line at which the string will be displayed (1, 2, or 4).
@@ -196,6 +349,26 @@ void lcd_i2c_RTOS_Handle_Messages(lcd_i2c_RTOS_t* lcd_i2c_RTOS);
  */
 LCD_StatusTypeDef lcd_i2c_RTOS_Write(lcd_i2c_RTOS_t* lcd_i2c_RTOS, uint8_t line, uint8_t col, char *str, uint8_t clear);
 
+/**
+ * @brief  Send a string to the buffer as a single update
+ * @note   Buffer space for all the messages is reserved before the first one is
+ * 		   queued, so an update is never cut in half
+ * @param  lcd_i2c_RTOS: pointer to lcd_i2c_RTOS structure containing the info
+ * 		   for the specified display.
+ * @param  line: line at which the string will be displayed
+ * @param  col: column at which the string will start to be displayed
+ * @param  clear: CLEAR_ON or CLEAR_OFF, as for lcd_i2c_RTOS_Write()
+ * @param  mode: behaviour when the buffer is short of space
+ * 			 @arg LCD_WRITE_FAILFAST: returns LCD_BUFFER_FULL at once
+ * 			 @arg LCD_WRITE_BLOCK: waits up to timeout for the consumer
+ * 			 @arg LCD_WRITE_REPLACE: first drops the previous update of the same line
+ * 			 	  if it is the last one queued and has not been sent, then blocks
+ * @param  timeout: ticks to wait for space, osWaitForever to wait indefinitely
+ * @retval LCD Status
+ */
+LCD_StatusTypeDef lcd_i2c_RTOS_Write_Bulk(lcd_i2c_RTOS_t* lcd_i2c_RTOS, uint8_t line, uint8_t col, const char *str, uint8_t clear,
+		uint8_t mode, uint32_t timeout);
+
 /**
  * @brief  Turns on the display
  * @param  lcd_i2c_RTOS: variable targeting the desired display
@@ -0,0 +1,104 @@
+#ifndef LCD_I2C_RTOS_GLYPHS_H
+#define LCD_I2C_RTOS_GLYPHS_H
+
+#include "lcd_i2c_RTOS.h"
+
+/*
+ *  The 8 CGRAM slots of a display are a cache of custom glyphs keyed by their
+ *  bitmap. A glyph is uploaded only when it is not resident, replacing the least
+ *  recently used slot that is neither on screen nor locked by the current drawing.
+ */
+
+#define LCD_GLYPH_FULL			0xFF	/* Full block of the character ROM */
+#define LCD_BAR_STEPS			5		/* Columns of a character cell */
+#define LCD_BIG_DIGIT_WIDTH		4		/* Columns of a big digit, the last one blank */
+
+/**
+ * @brief  lcd_glyph_t struct, custom character used by lcd_i2c_RTOS_Write_Glyphs()
+ */
+typedef struct lcd_glyph_t {
+	char code;								/* Character replaced in the text */
+	const uint8_t* bitmap;					/* LCD_GLYPH_ROWS rows of 5 pixels */
+} lcd_glyph_t;
+
+
+/**	--- Initialization functions --- **/
+
+
+/**
+ * @brief  Forgets the resident glyphs and the statistics
+ * @param  lcd_i2c_RTOS: variable targeting the desired display
+ * @retval None
+ */
+void lcd_i2c_RTOS_Glyph_Reset(lcd_i2c_RTOS_t* lcd_i2c_RTOS);
+
+
+/**	--- Interface functions --- **/
+
+
+/**
+ * @brief  Makes a glyph resident, uploading it if needed
+ * @note   The slot is locked until lcd_i2c_RTOS_Glyph_Release(), so the glyphs of
+ * 		   a drawing do not evict each other before they reach the screen
+ * @param  lcd_i2c_RTOS: variable targeting the desired display
+ * @param  bitmap: LCD_GLYPH_ROWS rows of 5 pixels
+ * @retval Character code showing the glyph, 0 if every slot is in use or the
+ * 		   buffer is full
+ */
+char lcd_i2c_RTOS_Glyph(lcd_i2c_RTOS_t* lcd_i2c_RTOS, const uint8_t* bitmap);
+
+/**
+ * @brief  Unlocks the slots handed out by lcd_i2c_RTOS_Glyph()
+ * @param  lcd_i2c_RTOS: variable targeting the desired display
+ * @retval None
+ */
+void lcd_i2c_RTOS_Glyph_Release(lcd_i2c_RTOS_t* lcd_i2c_RTOS);
+
+/**
+ * @brief  Share of the glyphs found resident
+ * @param  lcd_i2c_RTOS: variable targeting the desired display
+ * @retval Hit rate in per mille
+ */
+uint16_t lcd_i2c_RTOS_Glyph_Hit_Rate(lcd_i2c_RTOS_t* lcd_i2c_RTOS);
+
+/**
+ * @brief  Writes a string whose custom characters are mapped to CGRAM slots
+ * @note   Characters without a slot are shown as '?'
+ * @param  lcd_i2c_RTOS: variable targeting the desired display
+ * @param  line: line at which the string will be displayed
+ * @param  col: column at which the string will start to be displayed
+ * @param  str: text, up to LCD_MAX_CHARS characters are used
+ * @param  clear: CLEAR_ON or CLEAR_OFF, as for lcd_i2c_RTOS_Write()
+ * @param  glyphs: custom characters found in the text
+ * @param  n_glyphs: number of custom characters
+ * @retval LCD Status
+ */
+LCD_StatusTypeDef lcd_i2c_RTOS_Write_Glyphs(lcd_i2c_RTOS_t* lcd_i2c_RTOS, uint8_t line, uint8_t col, const char* str,
+		uint8_t clear, const lcd_glyph_t* glyphs, uint8_t n_glyphs);
+
+/**
+ * @brief  Draws a horizontal bar graph with a resolution of a pixel column
+ * @note   Uses the ROM full block and one custom glyph for the partial cell
+ * @param  lcd_i2c_RTOS: variable targeting the desired display
+ * @param  line: line of the bar
+ * @param  col: first column of the bar
+ * @param  width: cells of the bar
+ * @param  value: value shown, clamped to 0..max
+ * @param  max: value of a full bar
+ * @retval LCD Status
+ */
+LCD_StatusTypeDef lcd_i2c_RTOS_Bar(lcd_i2c_RTOS_t* lcd_i2c_RTOS, uint8_t line, uint8_t col, uint8_t width,
+		uint16_t value, uint16_t max);
+
+/**
+ * @brief  Draws digits two lines high, LCD_BIG_DIGIT_WIDTH columns each
+ * @note   Uses the ROM full block and three custom glyphs
+ * @param  lcd_i2c_RTOS: variable targeting the desired display
+ * @param  line: upper line of the digits
+ * @param  col: first column
+ * @param  digits: text made of '0'-'9', '-' and ' '
+ * @retval LCD Status
+ */
+LCD_StatusTypeDef lcd_i2c_RTOS_Big_Digits(lcd_i2c_RTOS_t* lcd_i2c_RTOS, uint8_t line, uint8_t col, const char* digits);
+
+#endif
@@ -0,0 +1,42 @@
+#ifndef LCD_PCF8574_H
+#define LCD_PCF8574_H
+
+#include "main.h"
+#include <string.h>
+
+/*
+ *  PCF8574 backpack of the HD44780 displays: P0 RS, P1 RW, P2 EN, P3 backlight,
+ *  P4-P7 data. Each byte is sent as two nibbles, each latched by an EN pulse,
+ *  so a byte takes four expander writes that can be streamed in one transaction.
+ */
+
+#define LCD_PCF8574_RS			0x01
+#define LCD_PCF8574_RW			0x02
+#define LCD_PCF8574_EN			0x04
+#define LCD_PCF8574_BACKLIGHT	0x08
+
+#define LCD_PCF8574_BYTES		4		/* Expander writes per HD44780 byte */
+#define LCD_PCF8574_INPUT		0xF0	/* Data pins released high so the display can drive them */
+#define LCD_PCF8574_BUSY		0x80	/* Busy flag in the high nibble read back */
+
+/* Expander writes of every byte in data mode, first write in the low byte */
+extern const uint32_t lcd_pcf8574_nibbles[256];
+
+/**
+ * @brief  Expands a byte into the four expander writes that send it
+ * @param  out: LCD_PCF8574_BYTES bytes of the stream
+ * @param  byte: HD44780 command or data byte
+ * @param  rs: 1 for data, 0 for commands
+ * @retval None
+ */
+static inline void lcd_pcf8574_Expand(uint8_t* out, uint8_t byte, uint8_t rs)
+{
+	uint32_t nibbles = lcd_pcf8574_nibbles[byte];
+
+	if (!rs) {
+		nibbles &= ~(LCD_PCF8574_RS * 0x01010101UL);
+	}
+	memcpy(out, &nibbles, LCD_PCF8574_BYTES);
+}
+
+#endif
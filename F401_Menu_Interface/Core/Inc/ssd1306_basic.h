@@ -44,6 +44,13 @@ extern C {
 #ifndef SSD1306_HEIGHT
 #define SSD1306_HEIGHT           64
 #endif
+/* SSD1306 number of 8-pixel pages */
+#define SSD1306_PAGES            (SSD1306_HEIGHT / 8)
+/* Bytes handed to the I2C peripheral by a full-frame update (3 commands and the data of each page) */
+#define SSD1306_FRAME_BYTES      (SSD1306_PAGES * (3 * 2 + 1 + SSD1306_WIDTH))
+
+/* Size of the buffers filled by the number formatting functions, terminator included */
+#define SSD1306_NUMBER_LENGTH    12
 
 #define NO 	"  "
 #define MV 		"mV"
@@ -59,17 +66,101 @@ typedef enum SSD1306_COLOR_t{
 	SSD1306_COLOR_WHITE = 0x01  /*!< Pixel is set. Color depends on LCD */
 } SSD1306_COLOR_t;
 
+/**
+ * @brief  SSD1306 memory addressing modes, value of the 0x20 command argument
+ */
+typedef enum SSD1306_ADDRESSING_t{
+	SSD1306_ADDRESSING_HORIZONTAL = 0x00, /*!< Column/page window (0x21/0x22), the whole frame goes out in one transaction */
+	SSD1306_ADDRESSING_PAGE = 0x02        /*!< One transaction per page, also supported by SH1106 */
+} SSD1306_ADDRESSING_t;
+
+/**
+ * @brief  SSD1306 hardware scroll directions, value of the scroll setup command
+ */
+typedef enum SSD1306_SCROLL_t{
+	SSD1306_SCROLL_RIGHT = 0x26,      /*!< Horizontal scroll to the right */
+	SSD1306_SCROLL_LEFT = 0x27,       /*!< Horizontal scroll to the left */
+	SSD1306_SCROLL_DIAG_RIGHT = 0x29, /*!< Vertical and right horizontal scroll */
+	SSD1306_SCROLL_DIAG_LEFT = 0x2A   /*!< Vertical and left horizontal scroll */
+} SSD1306_SCROLL_t;
+
+/**
+ * @brief  SSD1306 hardware scroll step interval, in frames
+ */
+typedef enum SSD1306_SCROLL_INTERVAL_t{
+	SSD1306_SCROLL_FRAMES_2 = 0x07,
+	SSD1306_SCROLL_FRAMES_3 = 0x04,
+	SSD1306_SCROLL_FRAMES_4 = 0x05,
+	SSD1306_SCROLL_FRAMES_5 = 0x00,
+	SSD1306_SCROLL_FRAMES_25 = 0x06,
+	SSD1306_SCROLL_FRAMES_64 = 0x01,
+	SSD1306_SCROLL_FRAMES_128 = 0x02,
+	SSD1306_SCROLL_FRAMES_256 = 0x03
+} SSD1306_SCROLL_INTERVAL_t;
+
+/**
+ * @brief  Panel variants, selects the init command table
+ */
+typedef enum SSD1306_PANEL_t{
+	SSD1306_PANEL_128x64 = 0, /*!< SSD1306 128x64 */
+	SSD1306_PANEL_128x32,     /*!< SSD1306 128x32, define SSD1306_HEIGHT as 32 */
+	SSD1306_PANEL_SH1106      /*!< SH1106 132x64 RAM, a 128 columns buffer is centered with a 2 column offset */
+} SSD1306_PANEL_t;
+
+/* Panel initialized by SSD1306_Init() */
+#ifndef SSD1306_PANEL
+#define SSD1306_PANEL            SSD1306_PANEL_128x64
+#endif
+
+/**
+ * @brief  Init steps, index of InitStatus and InitTime
+ */
+typedef enum SSD1306_INIT_STEP_t{
+	SSD1306_INIT_PROBE = 0, /*!< Device address acknowledged */
+	SSD1306_INIT_COMMANDS,  /*!< Command table sent */
+	SSD1306_INIT_CLEAR,     /*!< Display RAM cleared */
+	SSD1306_INIT_STEPS
+} SSD1306_INIT_STEP_t;
+
+/* Device probe at init, the controller answers right after power-up */
+#define SSD1306_PROBE_TRIALS     2
+#define SSD1306_PROBE_TIMEOUT    5
+
+/* Marks a page without modified columns */
+#define SSD1306_DIRTY_NONE       0xFF
+
 /**
  * @brief  SSD1306 struct
  */
 typedef struct ssd1306_t{
 	uint8_t addr;
 	I2C_HandleTypeDef *hi2c;
+	HAL_StatusTypeDef (*Write)(void* context, uint16_t addr, uint16_t mem, uint8_t* data, uint16_t size); /*!< Shared bus write, NULL to use hi2c directly */
+	void* WriteContext;					/*!< First argument of Write */
 	uint16_t CurrentX;
 	uint16_t CurrentY;
 	uint8_t Inverted;
 	uint8_t Initialized;
-	uint8_t SSD1306_Buffer[SSD1306_WIDTH * SSD1306_HEIGHT / 8];
+	uint8_t DirtyStart[SSD1306_PAGES];	/*!< First modified column of each page, SSD1306_DIRTY_NONE if clean */
+	uint8_t DirtyEnd[SSD1306_PAGES];	/*!< Last modified column of each page */
+	uint16_t BytesSaved;				/*!< Bytes not transmitted by the last update compared to a full frame */
+	uint8_t AddressingMode;				/*!< Current @ref SSD1306_ADDRESSING_t of the panel */
+	uint8_t ColumnOffset;				/*!< Panel RAM column of the first buffer column */
+	HAL_StatusTypeDef InitStatus[SSD1306_INIT_STEPS];	/*!< Result of each init step, HAL_ERROR if not reached */
+	uint32_t InitTime[SSD1306_INIT_STEPS];				/*!< Duration of each init step in microseconds */
+	uint8_t Scrolling;					/*!< Set while a hardware scroll runs, updates wait for SSD1306_StopScroll() */
+	uint32_t FrameTime;					/*!< Duration of the last update in microseconds */
+	uint32_t FlushStartTime;			/*!< Cycle counter when the asynchronous flush started */
+	volatile uint8_t FlushBusy;			/*!< Set while SSD1306_UpdateScreenAsync() is transmitting the front buffer */
+	uint8_t FlushAborted;				/*!< Set when an asynchronous flush stopped before its last page */
+	uint8_t FlushPage;					/*!< Page being transmitted by the asynchronous flush */
+	uint8_t FlushStage;					/*!< Page addressing commands or page data */
+	uint8_t FlushStart[SSD1306_PAGES];	/*!< Column window of each page handed to the front buffer */
+	uint8_t FlushEnd[SSD1306_PAGES];
+	uint8_t FlushCmd[6];				/*!< Addressing commands of the asynchronous flush */
+	void (*FlushCpltCallback)(struct ssd1306_t* ssd1306); /*!< Called (from interrupt context) when the asynchronous flush ends */
+	uint8_t SSD1306_Buffer[SSD1306_WIDTH * SSD1306_HEIGHT / 8];	/*!< Back buffer, used by the drawing functions */
+	uint8_t SSD1306_Front[SSD1306_WIDTH * SSD1306_HEIGHT / 8];	/*!< Front buffer, read by the asynchronous flush */
 } ssd1306_t;
 
 /**
@@ -82,6 +173,7 @@ ssd1306_t* ssd1306_new(I2C_HandleTypeDef *hi2c, uint8_t addr);
 
 /**
  * @brief  Initializes SSD1306 LCD
+ * @note   Initializes the SSD1306_PANEL variant, see @ref SSD1306_InitPanel()
  * @param  *hi2c: I2C peripheral used by the mcu
  * @param  addr: I2C address corresponding to the targeted display
  * @retval Initialization status:
@@ -90,14 +182,133 @@ ssd1306_t* ssd1306_new(I2C_HandleTypeDef *hi2c, uint8_t addr);
  */
 uint8_t SSD1306_Init(ssd1306_t* ssd1306, I2C_HandleTypeDef *hi2c, uint8_t addr);
 
+/**
+ * @brief  Initializes a given panel variant
+ * @note   The command table of the variant is sent in a single transaction. The result and the
+ *         duration of each step are stored in InitStatus and InitTime
+ * @param  *hi2c: I2C peripheral used by the mcu
+ * @param  addr: I2C address corresponding to the targeted display
+ * @param  panel: Panel variant. This parameter can be a value of @ref SSD1306_PANEL_t enumeration
+ * @retval Initialization status:
+ *           - 0: A step failed, see InitStatus
+ *           - > 0: LCD initialized OK and ready to use
+ */
+uint8_t SSD1306_InitPanel(ssd1306_t* ssd1306, I2C_HandleTypeDef *hi2c, uint8_t addr, SSD1306_PANEL_t panel);
+
 /** 
  * @brief  Updates buffer from internal RAM to LCD
  * @note   This function must be called each time you do some changes to LCD, to update buffer from RAM to LCD
+ * @note   Only the modified column window of each modified page is transmitted.
+ *         The bytes skipped compared to a full frame are stored in BytesSaved and the
+ *         transfer duration in FrameTime
+ * @note   Nothing is sent while a hardware scroll runs
  * @param  None
  * @retval None
  */
 void SSD1306_UpdateScreen(ssd1306_t* ssd1306);
 
+/**
+ * @brief  Starts a non-blocking transfer of the modified regions to LCD
+ * @note   The modified regions are copied to the front buffer and sent through DMA (or interrupts
+ *         if the I2C handle has no DMA linked), so drawing can continue on the back buffer.
+ *         SSD1306_TxCpltCallback() and SSD1306_ErrorCallback() must be called from the HAL I2C
+ *         memory transfer callbacks. FlushCpltCallback is called when the transfer ends
+ * @note   When Write is set, the bus owner does the transfer: the regions are sent with
+ *         @ref SSD1306_UpdateScreen() and 0 is returned
+ * @param  None
+ * @retval Transfer status:
+ *           - 0: Nothing to send, a transfer or a hardware scroll is running or the bus is busy
+ *           - 1: Transfer started, wait for FlushCpltCallback
+ */
+uint8_t SSD1306_UpdateScreenAsync(ssd1306_t* ssd1306);
+
+/**
+ * @brief  Advances the asynchronous flush, call it from HAL_I2C_MemTxCpltCallback()
+ * @param  *hi2c: I2C handle whose transfer has finished
+ * @retval None
+ */
+void SSD1306_TxCpltCallback(ssd1306_t* ssd1306, I2C_HandleTypeDef *hi2c);
+
+/**
+ * @brief  Stops the asynchronous flush, call it from HAL_I2C_ErrorCallback()
+ * @note   Pages not transmitted are sent again by the next update
+ * @param  *hi2c: I2C handle that reported the error
+ * @retval None
+ */
+void SSD1306_ErrorCallback(ssd1306_t* ssd1306, I2C_HandleTypeDef *hi2c);
+
+/**
+ * @brief  Selects how the updates address the display RAM
+ * @note   In horizontal mode the modified pages are sent as a single column/page window, in one
+ *         command and one data transaction. It needs SSD1306_WIDTH <= 128, SH1106 panels only
+ *         support page mode. Compare both modes with FrameTime
+ * @param  mode: Addressing mode. This parameter can be a value of @ref SSD1306_ADDRESSING_t enumeration
+ * @retval Status:
+ *           - 0: Mode not supported by the panel or a transfer is running
+ *           - 1: Mode changed
+ */
+uint8_t SSD1306_SetAddressingMode(ssd1306_t* ssd1306, SSD1306_ADDRESSING_t mode);
+
+/**
+ * @brief  Sends a region of the internal RAM to LCD right away
+ * @note   The region is extended to whole pages vertically. Its pages stop being marked as
+ *         modified if their modified columns are inside the region
+ * @param  x: X location of the region
+ * @param  y: Y location of the region
+ * @param  w: Width of the region in pixels
+ * @param  h: Height of the region in pixels
+ * @retval Status:
+ *           - 0: Empty region, or a transfer or a hardware scroll is running
+ *           - 1: Region sent
+ */
+uint8_t SSD1306_UpdateWindow(ssd1306_t* ssd1306, uint16_t x, uint16_t y, uint16_t w, uint16_t h);
+
+/**
+ * @brief  Starts a hardware scroll of the displayed content
+ * @note   The panel moves the pixels by itself, so no data crosses the bus while it scrolls.
+ *         Updates are held until @ref SSD1306_StopScroll(). Not supported by SH1106 panels
+ * @param  dir: Scroll direction. This parameter can be a value of @ref SSD1306_SCROLL_t enumeration
+ * @param  start_page: First page (8-pixel row) scrolled horizontally
+ * @param  end_page: Last page scrolled horizontally
+ * @param  interval: Time between scroll steps. This parameter can be a value of @ref SSD1306_SCROLL_INTERVAL_t enumeration
+ * @param  vertical_offset: Rows moved at each step by diagonal scrolls, 0 to SSD1306_HEIGHT - 1
+ * @retval Status:
+ *           - 0: Invalid pages or an asynchronous transfer is running
+ *           - 1: Scroll started
+ */
+uint8_t SSD1306_StartScroll(ssd1306_t* ssd1306, SSD1306_SCROLL_t dir, uint8_t start_page, uint8_t end_page, SSD1306_SCROLL_INTERVAL_t interval, uint8_t vertical_offset);
+
+/**
+ * @brief  Sets the rows moved by the vertical part of diagonal scrolls
+ * @param  fixed_rows: Rows at the top that do not scroll
+ * @param  rows: Rows that scroll below them
+ * @retval Status:
+ *           - 0: Area larger than the LCD or an asynchronous transfer is running
+ *           - 1: Area set
+ */
+uint8_t SSD1306_SetScrollArea(ssd1306_t* ssd1306, uint8_t fixed_rows, uint8_t rows);
+
+/**
+ * @brief  Stops the hardware scroll
+ * @note   The panel RAM is not valid after a scroll, so the whole internal RAM is marked
+ *         as modified and the next update rewrites it
+ * @param  None
+ * @retval None
+ */
+void SSD1306_StopScroll(ssd1306_t* ssd1306);
+
+/**
+ * @brief  Marks a region of the internal RAM as modified, so it is sent on the next update
+ * @note   Drawing functions of this library already mark the pixels they change. Only needed
+ *         when SSD1306_Buffer is written directly
+ * @param  x: X location of the region
+ * @param  y: Y location of the region
+ * @param  w: Width of the region in pixels
+ * @param  h: Height of the region in pixels
+ * @retval None
+ */
+void SSD1306_MarkDirty(ssd1306_t* ssd1306, uint16_t x, uint16_t y, uint16_t w, uint16_t h);
+
 /**
  * @brief  Toggles pixels invertion inside internal RAM
  * @note   @ref SSD1306_UpdateScreen() must be called after that in order to see updated LCD screen
@@ -135,6 +346,7 @@ void SSD1306_GotoXY(ssd1306_t* ssd1306, uint16_t x, uint16_t y);
 /**
  * @brief  Puts character to internal RAM
  * @note   @ref SSD1306_UpdateScreen() must be called after that in order to see updated LCD screen
+ * @note   Fonts with column data are written as whole page bytes, the others pixel by pixel
  * @param  ch: Character to be written
  * @param  *Font: Pointer to @ref FontDef_t structure with used font
  * @param  color: Color used for drawing. This parameter can be a value of @ref SSD1306_COLOR_t enumeration
@@ -152,13 +364,27 @@ char SSD1306_Putc(ssd1306_t* ssd1306, uint8_t ch, FontDef_t* Font, SSD1306_COLOR
  */
 char SSD1306_Puts(ssd1306_t* ssd1306, char* str, FontDef_t* Font, SSD1306_COLOR_t color);
 
+/**
+ * @brief  Formats a fixed-point number into a display slot string
+ * @note   Integer math only and no static storage, so tasks can format at the same time.
+ *         Sign, digits and point take up to 8 chars, followed by a space and the unit.
+ *         Numbers that do not fit are written as OVERLOAD
+ * @param  str: caller buffer of SSD1306_NUMBER_LENGTH chars
+ * @param  value: number scaled by 10^decimals (1234 with 2 decimals is 12.34)
+ * @param  decimals: number of digits after the decimal point
+ * @param  unit: unit of the value, 2 char array ("mV", " A", etc.)
+ * @retval str
+ */
+char* SSD1306_FormatFixed(char* str, int32_t value, uint8_t decimals, const char* unit);
+
 /**
  * @brief  Represents an integer number with a char array
+ * @param  str: caller buffer of SSD1306_NUMBER_LENGTH chars
  * @param  integer: int to be represented
  * @param  unit: unit of the value, 2 char array ("mV", " A", etc.)
  * @retval Char array containing a char for each digit
  */
-char* int_str(int integer,  char* unit);
+char* int_str(char* str, int integer, char* unit);
 
 /**
  * @brief  Removes the cursor
@@ -176,21 +402,32 @@ void SSD1306_SetCursor(ssd1306_t* ssd1306, int position);
 
 /**
  * @brief  Puts integer to internal RAM
- * @note   @ref If the number has mora than 6 digits, displays OVERLOAD
+ * @note   @ref If the number has more than 7 digits, displays OVERLOAD
  * @param  data: integer to be written
  * @param  unit: unit of the value, 2 char array (NO, MV, V, MA, A, "uV", "ms", etc.)
  * @param  slot: slot to be used. 1, 2, and 3 are large slots. 4 and 5 are small slots
  */
 void SSD1306_Putint(ssd1306_t* ssd1306, int data, char* unit, uint8_t slot);
 
+/**
+ * @brief  Puts fixed-point number to internal RAM
+ * @note   @ref If the number has more than 6 digits, displays OVERLOAD
+ * @param  data: number scaled by 10^decimals (1234 with 2 decimals is 12.34)
+ * @param  decimals: number of decimals to be represented
+ * @param  unit: unit of the value, 2 char array (NO, MV, V, MA, A, "uV", "ms", etc.)
+ * @param  slot: slot to be used. 1, 2, and 3 are large slots. 4 and 5 are small slots
+ */
+void SSD1306_Putfixed(ssd1306_t* ssd1306, int32_t data, uint8_t decimals, char* unit, uint8_t slot);
+
 /**
  * @brief  Represents a double number with a char array
+ * @param  str: caller buffer of SSD1306_NUMBER_LENGTH chars
  * @param  number: double to be represented
  * @param  decimals: number of decimals to be represented
  * @param  unit: unit of the value, 2 char array (NO, MV, V, MA, A, "uV", "ms", etc.)
  * @retval Char array containing a char for each digit
  */
-char* double_str(double number, uint8_t decimals, char* unit);
+char* double_str(char* str, double number, uint8_t decimals, char* unit);
 
 /**
  * @brief  Puts double to internal RAM
@@ -239,9 +476,9 @@ void ssd1306_I2C_Write(ssd1306_t* ssd1306, uint8_t reg, uint8_t data);
  * @param  reg: register to write to
  * @param  *data: pointer to data array to write it to slave
  * @param  count: how many bytes will be written
- * @retval None
+ * @retval HAL status of the transfer
  */
-void ssd1306_I2C_WriteMulti(ssd1306_t* ssd1306, uint8_t reg, uint8_t* data, uint16_t count);
+HAL_StatusTypeDef ssd1306_I2C_WriteMulti(ssd1306_t* ssd1306, uint8_t reg, uint8_t* data, uint16_t count);
 
 
 
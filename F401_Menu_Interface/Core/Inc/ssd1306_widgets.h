@@ -0,0 +1,93 @@
+#ifndef SSD1306_WIDGETS_H
+#define SSD1306_WIDGETS_H
+
+#include "ssd1306_basic.h"
+#include <string.h>
+
+/*
+ *  Retained-mode widgets: each widget remembers what it drew, so setting
+ *  the same value again costs a comparison and only the characters that
+ *  change are redrawn (and marked dirty for the next update).
+ */
+
+#define SSD1306_WIDGET_LENGTH	SSD1306_NUMBER_LENGTH	/* Characters of the widest widget, terminator included */
+
+/**
+ * @brief  ssd1306_widget_t struct
+ */
+typedef struct ssd1306_widget_t {
+	uint16_t x;
+	uint16_t y;
+	FontDef_t* font;
+	uint8_t width;							/* Characters drawn by the widget */
+	uint8_t valid;							/* The cache matches the internal RAM */
+	int32_t value;							/* Last number shown */
+	uint8_t decimals;
+	char unit[2];							/* Characters of the unit shown */
+	char cache[SSD1306_WIDGET_LENGTH];		/* Characters drawn */
+} ssd1306_widget_t;
+
+
+/**	--- Initialization functions --- **/
+
+
+/**
+ * @brief  Declares a text widget
+ * @param  widget: widget to be declared
+ * @param  x: X location of the first character
+ * @param  y: Y location of the first character
+ * @param  font: font of the widget
+ * @param  width: number of characters, up to SSD1306_WIDGET_LENGTH - 1. Reduced to
+ *         the characters that fit on the panel
+ * @retval None
+ */
+void SSD1306_Widget(ssd1306_widget_t* widget, uint16_t x, uint16_t y, FontDef_t* font, uint8_t width);
+
+/**
+ * @brief  Declares a number widget on one of the slots of @ref SSD1306_Putint()
+ * @param  widget: widget to be declared
+ * @param  slot: slot to be used. 1, 2, and 3 are large slots. 4 and 5 are small slots
+ * @retval None
+ */
+void SSD1306_WidgetSlot(ssd1306_widget_t* widget, uint8_t slot);
+
+/**
+ * @brief  Forces the widget to be drawn again by its next set
+ * @param  widget: widget to be redrawn
+ * @retval None
+ */
+void SSD1306_WidgetInvalidate(ssd1306_widget_t* widget);
+
+
+/**	--- Interface functions --- **/
+
+
+/**
+ * @brief  Shows a text on the widget
+ * @note   Only the characters that differ from the ones drawn are written to internal RAM.
+ *         Text shorter than the widget is padded with spaces
+ * @param  ssd1306: ssd1306_t selected
+ * @param  widget: widget to be updated
+ * @param  text: text to be shown
+ * @retval 1 if internal RAM changed, 0 otherwise
+ */
+uint8_t SSD1306_WidgetSetText(ssd1306_t* ssd1306, ssd1306_widget_t* widget, const char* text);
+
+/**
+ * @brief  Shows a fixed-point number on the widget, formatted as @ref SSD1306_FormatFixed()
+ * @note   Nothing is formatted when the number, decimals and unit are the ones shown
+ * @param  ssd1306: ssd1306_t selected
+ * @param  widget: widget to be updated
+ * @param  value: number scaled by 10^decimals
+ * @param  decimals: number of decimals to be represented
+ * @param  unit: unit of the value, 2 char array (NO, MV, V, MA, A, "uV", "ms", etc.)
+ * @retval 1 if internal RAM changed, 0 otherwise
+ */
+uint8_t SSD1306_WidgetSetFixed(ssd1306_t* ssd1306, ssd1306_widget_t* widget, int32_t value, uint8_t decimals, const char* unit);
+
+/**
+ * @brief  Shows an integer on the widget, see @ref SSD1306_WidgetSetFixed()
+ */
+uint8_t SSD1306_WidgetSetInt(ssd1306_t* ssd1306, ssd1306_widget_t* widget, int32_t value, const char* unit);
+
+#endif
@@ -0,0 +1,318 @@
+#include <i2c_bus.h>
+
+/* Microseconds elapsed since the given cycle counter value */
+static uint32_t i2c_bus_Elapsed(uint32_t start)
+{
+	return (DWT->CYCCNT - start) / (SystemCoreClock / 1000000);
+}
+
+/* Takes the oldest request of a priority out of its queue, if there is none yet */
+static uint8_t i2c_bus_Fill(i2c_bus_t* bus, uint8_t prio)
+{
+	if (!bus->head_valid[prio]) {
+		bus->head_valid[prio] = (osMessageQueueGet(bus->queue[prio], &bus->head[prio], NULL, 0) == osOK);
+	}
+	return bus->head_valid[prio];
+}
+
+/* Highest priority with a request waiting, I2C_BUS_PRIOS if there is none */
+static uint8_t i2c_bus_Pending(i2c_bus_t* bus)
+{
+	uint8_t prio;
+
+	for (prio = 0; prio < I2C_BUS_PRIOS; prio++) {
+		if (i2c_bus_Fill(bus, prio)) {
+			break;
+		}
+	}
+	return prio;
+}
+
+/* Updates the statistics of a finished write */
+static void i2c_bus_Account(i2c_bus_client_t* client, uint32_t enqueued, uint16_t bytes, HAL_StatusTypeDef status)
+{
+	uint32_t latency = i2c_bus_Elapsed(enqueued);
+
+	client->requests++;
+	client->bytes += bytes;
+	client->latency_sum += latency;
+	if (latency > client->latency_max) {
+		client->latency_max = latency;
+	}
+	if (status != HAL_OK) {
+		client->errors++;
+	}
+}
+
+/* Frees the peripheral after a transfer that never ended. HAL_I2C_Master_Abort_IT()
+   ignores memory writes and finishes later in the interrupt, so the DMA stream is
+   stopped here and the peripheral reset before the next transfer */
+static void i2c_bus_Recover(i2c_bus_t* bus)
+{
+	I2C_HandleTypeDef *hi2c = bus->hi2c;
+
+	if (hi2c->hdmatx != NULL && hi2c->hdmatx->State == HAL_DMA_STATE_BUSY) {
+		HAL_DMA_Abort(hi2c->hdmatx);
+	}
+	HAL_I2C_DeInit(hi2c);
+	HAL_I2C_Init(hi2c);
+}
+
+/* Runs one transaction through DMA (or interrupts) and waits for its end */
+static HAL_StatusTypeDef i2c_bus_Transfer(i2c_bus_t* bus, i2c_bus_client_t* client, uint16_t addr, uint16_t mem, uint8_t* data, uint16_t size, uint8_t read)
+{
+	HAL_StatusTypeDef status;
+	uint32_t t0 = DWT->CYCCNT;
+	uint32_t flags;
+	uint32_t elapsed;
+
+	osThreadFlagsClear(I2C_BUS_FLAG_DONE | I2C_BUS_FLAG_ERROR);
+	if (read) {
+		/* Reads are a few bytes, there is no receive DMA stream */
+		status = HAL_I2C_Master_Receive_IT(bus->hi2c, addr, data, size);
+	} else if (mem == I2C_BUS_NO_MEM) {
+		if (bus->hi2c->hdmatx != NULL) {
+			status = HAL_I2C_Master_Transmit_DMA(bus->hi2c, addr, data, size);
+		} else {
+			status = HAL_I2C_Master_Transmit_IT(bus->hi2c, addr, data, size);
+		}
+	} else {
+		if (bus->hi2c->hdmatx != NULL) {
+			status = HAL_I2C_Mem_Write_DMA(bus->hi2c, addr, mem, I2C_MEMADD_SIZE_8BIT, data, size);
+		} else {
+			status = HAL_I2C_Mem_Write_IT(bus->hi2c, addr, mem, I2C_MEMADD_SIZE_8BIT, data, size);
+		}
+	}
+
+	if (status == HAL_OK) {
+		flags = osThreadFlagsWait(I2C_BUS_FLAG_DONE | I2C_BUS_FLAG_ERROR, osFlagsWaitAny, I2C_BUS_TIMEOUT);
+		if (flags & osFlagsError) {
+			i2c_bus_Recover(bus);
+			status = HAL_TIMEOUT;
+		} else if (flags & I2C_BUS_FLAG_ERROR) {
+			status = HAL_ERROR;
+		}
+	}
+
+	elapsed = i2c_bus_Elapsed(t0);
+	bus->busy_time += elapsed;
+	bus->transfers++;
+	client->busy_time += elapsed;
+	return status;
+}
+
+/* Sends the posted writes at the head of a priority, merging the ones to the same device */
+static void i2c_bus_SendBatch(i2c_bus_t* bus, uint8_t prio)
+{
+	i2c_bus_request_t* req = &bus->head[prio];
+	i2c_bus_client_t* client = req->client;
+	uint16_t addr = req->addr;
+	uint16_t mem = req->mem;
+	uint32_t enqueued[I2C_BUS_BATCH_SIZE];
+	uint8_t sizes[I2C_BUS_BATCH_SIZE];
+	uint8_t count = 0;
+	uint16_t len = 0;
+	HAL_StatusTypeDef status;
+	uint8_t i;
+
+	do {
+		memcpy(&bus->batch[len], req->inline_data, req->size);
+		len += req->size;
+		enqueued[count] = req->enqueued;
+		sizes[count++] = req->size;
+		bus->head_valid[prio] = 0;
+	} while (i2c_bus_Fill(bus, prio) && req->waiter == NULL && req->client == client &&
+			req->addr == addr && req->mem == mem && len + req->size <= I2C_BUS_BATCH_SIZE);
+
+	bus->batched += count - 1;
+	status = i2c_bus_Transfer(bus, client, addr, mem, bus->batch, len, 0);
+	for (i = 0; i < count; i++) {
+		i2c_bus_Account(client, enqueued[i], sizes[i], status);
+	}
+}
+
+/* Sends the next chunk of the blocking write at the head of a priority */
+static void i2c_bus_SendChunk(i2c_bus_t* bus, uint8_t prio)
+{
+	i2c_bus_request_t* req = &bus->head[prio];
+	uint16_t chunk = req->size - req->sent;
+	HAL_StatusTypeDef status;
+
+	/* Only memory writes can be resumed in another transaction */
+	if (!req->read && req->mem != I2C_BUS_NO_MEM && chunk > I2C_BUS_CHUNK_SIZE) {
+		chunk = I2C_BUS_CHUNK_SIZE;
+	}
+	status = i2c_bus_Transfer(bus, req->client, req->addr, req->mem, &req->data[req->sent], chunk, req->read);
+	req->sent += chunk;
+
+	if (status != HAL_OK || req->sent >= req->size) {
+		i2c_bus_Account(req->client, req->enqueued, req->sent, status);
+		*req->status = status;
+		bus->head_valid[prio] = 0;
+		osThreadFlagsSet(req->waiter, I2C_BUS_FLAG_CLIENT);
+	}
+}
+
+uint8_t i2c_bus_Init(i2c_bus_t* bus, I2C_HandleTypeDef *hi2c)
+{
+	uint8_t prio;
+
+	bus->hi2c = hi2c;
+	bus->thread_id = NULL;
+	for (prio = 0; prio < I2C_BUS_PRIOS; prio++) {
+		bus->head_valid[prio] = 0;
+		bus->queue[prio] = osMessageQueueNew(I2C_BUS_QUEUE_SIZE, sizeof(i2c_bus_request_t), NULL);
+		if (bus->queue[prio] == NULL) {
+			return 0;
+		}
+	}
+	i2c_bus_ResetStats(bus, NULL, 0);
+
+	/* Cycle counter used for the latencies */
+	CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+	DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+	return 1;
+}
+
+void i2c_bus_Client(i2c_bus_t* bus, i2c_bus_client_t* client, const char* name, i2c_bus_prio_t priority)
+{
+	client->name = name;
+	client->bus = bus;
+	client->priority = priority;
+	client->requests = 0;
+	client->bytes = 0;
+	client->errors = 0;
+	client->latency_max = 0;
+	client->latency_sum = 0;
+	client->busy_time = 0;
+}
+
+/* Queues a request, posted for short writes, blocking the caller otherwise */
+static HAL_StatusTypeDef i2c_bus_Request(void* client, uint16_t addr, uint16_t mem, uint8_t* data, uint16_t size, uint8_t read)
+{
+	i2c_bus_client_t* bus_client = client;
+	i2c_bus_t* bus = bus_client->bus;
+	HAL_StatusTypeDef status = HAL_ERROR;
+	i2c_bus_request_t req;
+
+	/* Until the bus task runs, the drivers use the bus directly */
+	if (bus->thread_id == NULL || osKernelGetState() != osKernelRunning || osThreadGetId() == bus->thread_id) {
+		if (read) {
+			return HAL_I2C_Master_Receive(bus->hi2c, addr, data, size, I2C_BUS_TIMEOUT);
+		}
+		if (mem == I2C_BUS_NO_MEM) {
+			return HAL_I2C_Master_Transmit(bus->hi2c, addr, data, size, I2C_BUS_TIMEOUT);
+		}
+		return HAL_I2C_Mem_Write(bus->hi2c, addr, mem, I2C_MEMADD_SIZE_8BIT, data, size, I2C_BUS_TIMEOUT);
+	}
+	if (size == 0) {
+		return HAL_OK;
+	}
+
+	req.client = bus_client;
+	req.addr = addr;
+	req.mem = mem;
+	req.size = size;
+	req.sent = 0;
+	req.read = read;
+	req.enqueued = DWT->CYCCNT;
+	if (!read && size <= I2C_BUS_INLINE_SIZE) {
+		memcpy(req.inline_data, data, size);
+		req.data = NULL;
+		req.waiter = NULL;
+		req.status = NULL;
+	} else {
+		req.data = data;
+		req.waiter = osThreadGetId();
+		req.status = &status;
+		osThreadFlagsClear(I2C_BUS_FLAG_CLIENT);
+	}
+
+	if (osMessageQueuePut(bus->queue[bus_client->priority], &req, 0, I2C_BUS_TIMEOUT) != osOK) {
+		bus_client->errors++;
+		return HAL_BUSY;
+	}
+	osThreadFlagsSet(bus->thread_id, I2C_BUS_FLAG_REQUEST);
+
+	if (req.waiter != NULL) {
+		osThreadFlagsWait(I2C_BUS_FLAG_CLIENT, osFlagsWaitAny, osWaitForever);
+	} else {
+		status = HAL_OK;
+	}
+	return status;
+}
+
+HAL_StatusTypeDef i2c_bus_MemWrite(void* client, uint16_t addr, uint16_t mem, uint8_t* data, uint16_t size)
+{
+	return i2c_bus_Request(client, addr, mem, data, size, 0);
+}
+
+HAL_StatusTypeDef i2c_bus_Write(void* client, uint16_t addr, uint8_t* data, uint16_t size)
+{
+	return i2c_bus_MemWrite(client, addr, I2C_BUS_NO_MEM, data, size);
+}
+
+HAL_StatusTypeDef i2c_bus_Read(void* client, uint16_t addr, uint8_t* data, uint16_t size)
+{
+	return i2c_bus_Request(client, addr, I2C_BUS_NO_MEM, data, size, 1);
+}
+
+void i2c_bus_Run(i2c_bus_t* bus)
+{
+	uint8_t prio;
+
+	bus->thread_id = osThreadGetId();
+	for (;;) {
+		prio = i2c_bus_Pending(bus);
+		if (prio == I2C_BUS_PRIOS) {
+			osThreadFlagsWait(I2C_BUS_FLAG_REQUEST, osFlagsWaitAny, osWaitForever);
+		} else if (bus->head[prio].waiter == NULL) {
+			i2c_bus_SendBatch(bus, prio);
+		} else {
+			i2c_bus_SendChunk(bus, prio);
+		}
+	}
+}
+
+void i2c_bus_TxCpltCallback(i2c_bus_t* bus, I2C_HandleTypeDef *hi2c)
+{
+	if (hi2c == bus->hi2c && bus->thread_id != NULL) {
+		osThreadFlagsSet(bus->thread_id, I2C_BUS_FLAG_DONE);
+	}
+}
+
+void i2c_bus_RxCpltCallback(i2c_bus_t* bus, I2C_HandleTypeDef *hi2c)
+{
+	i2c_bus_TxCpltCallback(bus, hi2c);
+}
+
+void i2c_bus_ErrorCallback(i2c_bus_t* bus, I2C_HandleTypeDef *hi2c)
+{
+	if (hi2c == bus->hi2c && bus->thread_id != NULL) {
+		osThreadFlagsSet(bus->thread_id, I2C_BUS_FLAG_ERROR);
+	}
+}
+
+uint16_t i2c_bus_Utilisation(i2c_bus_t* bus)
+{
+	uint32_t elapsed = osKernelGetTickCount() - bus->stats_start;
+
+	if (elapsed == 0) {
+		return 0;
+	}
+	/* busy_time in us over elapsed in ms gives per mille */
+	return (uint16_t)(bus->busy_time / elapsed);
+}
+
+void i2c_bus_ResetStats(i2c_bus_t* bus, i2c_bus_client_t** clients, uint8_t n_clients)
+{
+	uint8_t i;
+
+	bus->transfers = 0;
+	bus->batched = 0;
+	bus->busy_time = 0;
+	bus->stats_start = osKernelGetTickCount();
+	for (i = 0; i < n_clients; i++) {
+		i2c_bus_Client(bus, clients[i], clients[i]->name, clients[i]->priority);
+	}
+}
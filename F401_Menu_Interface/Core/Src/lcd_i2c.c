@@ -3,10 +3,44 @@
 
 #include <lcd_i2c.h>
 
+/* Step of the initialization: command, minimum wait before the next one and expander writes */
+typedef struct lcd_i2c_step_t {
+	uint8_t cmd;
+	uint8_t wait_ms;
+	uint8_t bytes;
+} lcd_i2c_step_t;
+
+/* Until 4 bit mode the display takes every EN pulse as a whole instruction, so only the high nibble is sent */
+#define LCD_I2C_NIBBLE	(LCD_PCF8574_BYTES / 2)
+
+static const lcd_i2c_step_t lcd_i2c_init_steps[] = {
+	{0x30, 5, LCD_I2C_NIBBLE},		// wait for >4.1ms
+	{0x30, 1, LCD_I2C_NIBBLE},		// wait for >100us
+	{0x30, 1, LCD_I2C_NIBBLE},
+	{0x20, 1, LCD_I2C_NIBBLE},		// 4bit mode
+	// dislay initialisation
+	{0x28, 1, LCD_PCF8574_BYTES},	// Function set --> DL=0 (4 bit mode), N = 1 (2 line display) F = 0 (5x8 characters)
+	{0x08, 1, LCD_PCF8574_BYTES},	// Display on/off control --> D=0,C=0, B=0  ---> display off
+	{0x01, 2, LCD_PCF8574_BYTES},	// clear display, 1.52 ms
+	{0x06, 1, LCD_PCF8574_BYTES},	// Entry mode set --> I/D = 1 (increment cursor) & S = 0 (no shift)
+	{0x0C, 0, LCD_PCF8574_BYTES},	// Display on/off control --> D = 1, C and B = 0. (Cursor and blink, last two bits)
+};
+
+#define LCD_I2C_INIT_STEPS	(sizeof(lcd_i2c_init_steps) / sizeof(lcd_i2c_init_steps[0]))
+
+/* Ends the initialization and reports it */
+static void lcd_i2c_Init_End(lcd_i2c_t* lcd_i2c, uint8_t state)
+{
+	lcd_i2c->init_state = state;
+	if (lcd_i2c->ready != NULL) {
+		lcd_i2c->ready(lcd_i2c, state == LCD_I2C_INIT_READY);
+	}
+}
+
 
 /**
  * @brief  Creates lcd_i2c variable corresponding to the display
- * @note   Execution time is 81 ms (lcd_i2c_Init function)
+ * @note   Execution time is 72 ms (lcd_i2c_Init function)
  * @param  *hi2c: I2C peripheral used by the mcu
  * @param  addr: I2C address corresponding to the targeted display
  * @param  n_chars: number of the diaplay columns, or chars (16 or 20)
@@ -22,17 +56,40 @@ lcd_i2c_t* lcd_i2c_new(I2C_HandleTypeDef *hi2c, uint8_t addr, uint8_t n_chars, u
 
 /**
  * @brief  Initializes Liquid Crystal LCD display
- * @note   Execution time is 81 ms
+ * @note   Execution time is 72 ms, runs lcd_i2c_Init_Start() and lcd_i2c_Init_Process()
+ * 		   until the end of the sequence
  * @param  lcd_i2c variable targeting the desired display
  * @param  *hi2c: I2C peripheral used by the MCU
  * @param  addr: I2C address corresponding to the targeted display
  * @param  n_chars: number of the display columns, or chars (16 or 20)
  * @param  n_lines: number of the display lines (usually 1, 2, or 4)
  * @retval Initialization status:
- *           - 0: LCD was not detected on I2C port
+ *           - 0: LCD was not detected on I2C port, or the bus kept failing for LCD_I2C_RETRY_MS
  *           - 1: LCD initialized OK and ready to use
  */
 uint8_t lcd_i2c_Init(lcd_i2c_t* lcd_i2c, I2C_HandleTypeDef *hi2c, uint8_t addr, uint8_t n_chars, uint8_t n_lines)
+{
+	lcd_i2c_Init_Start(lcd_i2c, hi2c, addr, n_chars, n_lines, NULL);
+	while (lcd_i2c_Init_Process(lcd_i2c) == LCD_I2C_INIT_BUSY) {
+	}
+	return lcd_i2c->init_state == LCD_I2C_INIT_READY;
+}
+
+/**
+ * @brief  Starts the initialization of the display in the background
+ * @note   Returns at once, the power on wait and the commands are run by
+ * 		   lcd_i2c_Init_Process(). The display must not be written before the
+ * 		   ready callback
+ * @param  lcd_i2c variable targeting the desired display
+ * @param  *hi2c: I2C peripheral used by the MCU
+ * @param  addr: I2C address corresponding to the targeted display
+ * @param  n_chars: number of the display columns, or chars (16 or 20)
+ * @param  n_lines: number of the display lines (usually 1, 2, or 4)
+ * @param  ready: called at the end of the initialization, can be NULL
+ * @retval None
+ */
+void lcd_i2c_Init_Start(lcd_i2c_t* lcd_i2c, I2C_HandleTypeDef *hi2c, uint8_t addr, uint8_t n_chars, uint8_t n_lines,
+		lcd_i2c_ready_t ready)
 {
 	lcd_i2c->hi2c = hi2c;
 	lcd_i2c->addr = addr;
@@ -40,33 +97,51 @@ uint8_t lcd_i2c_Init(lcd_i2c_t* lcd_i2c, I2C_HandleTypeDef *hi2c, uint8_t addr,
 	lcd_i2c->n_lines = n_lines;
 	lcd_i2c->display_control = LCD_DISPLAYON | LCD_CURSOROFF | LCD_BLINKOFF;
 	lcd_i2c->display_mode = LCD_ENTRYLEFT | LCD_ENTRYSHIFTDECREMENT;
+	lcd_i2c->ready = ready;
 
-	if (HAL_I2C_IsDeviceReady(lcd_i2c->hi2c, lcd_i2c->addr, 1, 20000) != HAL_OK) {
-			/* Return false */
-			return 0;
+	// the power on wait is counted from here
+	lcd_i2c->init_state = LCD_I2C_INIT_BUSY;
+	lcd_i2c->init_step = 0;
+	lcd_i2c->init_wait = LCD_I2C_POWER_ON_MS;
+	lcd_i2c->init_tick = HAL_GetTick();
+}
+
+/**
+ * @brief  Sends the initialization steps that are due
+ * @note   Call it every ms or so from thread context (main loop, RTOS timer), it
+ * 		   never waits for the display. The first command doubles as the presence
+ * 		   check: a NACK ends the initialization as failed, and so does a step
+ * 		   that still fails LCD_I2C_RETRY_MS after it was due
+ * @param  lcd_i2c variable targeting the desired display
+ * @retval LCD_I2C_INIT_BUSY, LCD_I2C_INIT_READY or LCD_I2C_INIT_FAILED
+ */
+uint8_t lcd_i2c_Init_Process(lcd_i2c_t* lcd_i2c)
+{
+	uint8_t data_t[LCD_PCF8574_BYTES];
+	HAL_StatusTypeDef status;
+
+	// strictly greater, the current tick may have started just before init_tick was taken
+	while (lcd_i2c->init_state == LCD_I2C_INIT_BUSY && HAL_GetTick() - lcd_i2c->init_tick > lcd_i2c->init_wait) {
+		lcd_pcf8574_Expand(data_t, lcd_i2c_init_steps[lcd_i2c->init_step].cmd, 0);
+		status = HAL_I2C_Master_Transmit (lcd_i2c->hi2c, lcd_i2c->addr, data_t, lcd_i2c_init_steps[lcd_i2c->init_step].bytes,
+				LCD_I2C_STEP_TIMEOUT);
+		if (status != HAL_OK) {
+			// a NACK means there is no display at this address, other errors (bus busy or
+			// stuck, timeout) are retried on the next calls until LCD_I2C_RETRY_MS have passed
+			if ((HAL_I2C_GetError(lcd_i2c->hi2c) & HAL_I2C_ERROR_AF) ||
+					HAL_GetTick() - lcd_i2c->init_tick > lcd_i2c->init_wait + LCD_I2C_RETRY_MS) {
+				lcd_i2c_Init_End(lcd_i2c, LCD_I2C_INIT_FAILED);
+			}
+			break;
 		}
-	// Init code
-	HAL_Delay(50);  // wait for >40ms
-	lcd_send_cmd (lcd_i2c, 0x30);
-	HAL_Delay(5);  // wait for >4.1ms
-	lcd_send_cmd (lcd_i2c, 0x30);
-	HAL_Delay(1);  // wait for >100us
-	lcd_send_cmd (lcd_i2c, 0x30);
-	HAL_Delay(10);
-	lcd_send_cmd (lcd_i2c, 0x20);  // 4bit mode
-	HAL_Delay(10);
 
-	// dislay initialisation
-	lcd_send_cmd (lcd_i2c, 0x28); // Function set --> DL=0 (4 bit mode), N = 1 (2 line display) F = 0 (5x8 characters)
-	HAL_Delay(1);
-	lcd_send_cmd (lcd_i2c, 0x08); //Display on/off control --> D=0,C=0, B=0  ---> display off
-	HAL_Delay(1);
-	lcd_send_cmd (lcd_i2c, 0x01);  // clear display
-	HAL_Delay(2);
-	lcd_send_cmd (lcd_i2c, 0x06); //Entry mode set --> I/D = 1 (increment cursor) & S = 0 (no shift)
-	HAL_Delay(1);
-	lcd_send_cmd (lcd_i2c, 0x0C); //Display on/off control --> D = 1, C and B = 0. (Cursor and blink, last two bits)
-	return 1;
+		lcd_i2c->init_tick = HAL_GetTick();
+		lcd_i2c->init_wait = lcd_i2c_init_steps[lcd_i2c->init_step].wait_ms;
+		if (++lcd_i2c->init_step == LCD_I2C_INIT_STEPS) {
+			lcd_i2c_Init_End(lcd_i2c, LCD_I2C_INIT_READY);
+		}
+	}
+	return lcd_i2c->init_state;
 }
 
 /**
@@ -78,15 +153,9 @@ uint8_t lcd_i2c_Init(lcd_i2c_t* lcd_i2c, I2C_HandleTypeDef *hi2c, uint8_t addr,
  */
 void lcd_send_cmd (lcd_i2c_t* lcd_i2c, char cmd)
 {
-  char data_u, data_l;
-	uint8_t data_t[4];
-	data_u = (cmd&0xf0);
-	data_l = ((cmd<<4)&0xf0);
-	data_t[0] = data_u|0x0C;  //en=1, rs=0
-	data_t[1] = data_u|0x08;  //en=0, rs=0
-	data_t[2] = data_l|0x0C;  //en=1, rs=0
-	data_t[3] = data_l|0x08;  //en=0, rs=0
-	HAL_I2C_Master_Transmit (lcd_i2c->hi2c, lcd_i2c->addr, (uint8_t *) data_t, 4, 100);
+	uint8_t data_t[LCD_PCF8574_BYTES];
+	lcd_pcf8574_Expand(data_t, cmd, 0);
+	HAL_I2C_Master_Transmit (lcd_i2c->hi2c, lcd_i2c->addr, data_t, LCD_PCF8574_BYTES, 100);
 }
 
 /**
@@ -98,15 +167,9 @@ void lcd_send_cmd (lcd_i2c_t* lcd_i2c, char cmd)
  */
 void lcd_i2c_send_data (lcd_i2c_t* lcd_i2c, char data)
 {
-	char data_u, data_l;
-	uint8_t data_t[4];
-	data_u = (data&0xf0);
-	data_l = ((data<<4)&0xf0);
-	data_t[0] = data_u|0x0D;  //en=1, rs=1
-	data_t[1] = data_u|0x09;  //en=0, rs=1
-	data_t[2] = data_l|0x0D;  //en=1, rs=1
-	data_t[3] = data_l|0x09;  //en=0, rs=1
-	HAL_I2C_Master_Transmit (lcd_i2c->hi2c, lcd_i2c->addr,(uint8_t *) data_t, 4, 100);
+	uint8_t data_t[LCD_PCF8574_BYTES];
+	lcd_pcf8574_Expand(data_t, data, 1);
+	HAL_I2C_Master_Transmit (lcd_i2c->hi2c, lcd_i2c->addr, data_t, LCD_PCF8574_BYTES, 100);
 }
 
 /**
@@ -115,7 +178,7 @@ void lcd_i2c_send_data (lcd_i2c_t* lcd_i2c, char data)
  * @param  line: line at which the string will be displayed (1, 2, or 4)
  * @param  col: column at which the string will start to be displayed (under 16 or under 20)
  * @retval Write status:
- * 				0: line or column out of the display
+ * 				0: line or column out of the display, or display not initialized
  * 				1: string sent correctly
  */
 uint8_t lcd_i2c_Write(lcd_i2c_t* lcd_i2c, uint8_t line, uint8_t col, char *str)
@@ -125,6 +188,9 @@ uint8_t lcd_i2c_Write(lcd_i2c_t* lcd_i2c, uint8_t line, uint8_t col, char *str)
 	static uint8_t start_line_2, start_line_3;
 	uint8_t position;
 
+	if (lcd_i2c->init_state != LCD_I2C_INIT_READY) {
+		return 0;
+	}
 	if (lcd_i2c->n_chars == 20) {
 		start_line_2 = 0x14;
 		start_line_3 = 0x54;
@@ -147,8 +213,21 @@ uint8_t lcd_i2c_Write(lcd_i2c_t* lcd_i2c, uint8_t line, uint8_t col, char *str)
 			return 0;
 		}
 	}
-	lcd_send_cmd (lcd_i2c, LCD_SETDDRAMADDR|position);
-	while (*str) lcd_i2c_send_data (lcd_i2c, *str++);
+	// address and characters streamed together, the I2C byte time covers their execution
+	uint8_t stream[(1 + LCD_I2C_STREAM_CHARS) * LCD_PCF8574_BYTES];
+	uint16_t len = LCD_PCF8574_BYTES;
+	lcd_pcf8574_Expand(stream, LCD_SETDDRAMADDR|position, 0);
+	while (*str) {
+		lcd_pcf8574_Expand(&stream[len], *str++, 1);
+		len += LCD_PCF8574_BYTES;
+		if (len == sizeof(stream) || *str == '\0') {
+			HAL_I2C_Master_Transmit (lcd_i2c->hi2c, lcd_i2c->addr, stream, len, 100);
+			len = 0;
+		}
+	}
+	if (len != 0) {
+		HAL_I2C_Master_Transmit (lcd_i2c->hi2c, lcd_i2c->addr, stream, len, 100);
+	}
 	return 1;
 }
 
@@ -1,24 +1,274 @@
 #include <lcd_i2c_RTOS.h>
+#include <lcd_i2c_RTOS_glyphs.h>
+
+/* Time stamp of the latencies, in LCD_LATENCY_SHIFT us steps */
+static inline uint16_t lcd_i2c_RTOS_stamp(void)
+{
+	return (DWT->CYCCNT / (SystemCoreClock / 1000000)) >> LCD_LATENCY_SHIFT;
+}
 
 /**
  * @brief  Creates lcd_message_t variable containing an instruction to be transmitted
  * @param  message: Message to be transmitted
- * @param  exe_time: Time needed by the display to execute the instruction (ms)
- * @param  mode: Message mode: MODE_COMMAND or MODE_DATA
- * @note   Execution time is converted into ticks depending on the tick frequency used by FreeRTOS
+ * @param  exe_time: Time needed by the display to execute the instruction (us)
+ * @param  mode: Message mode: MODE_COMMAND, MODE_DATA or MODE_INIT
+ * @note   Execution time is stored in LCD_EXE_UNIT_US steps, rounded up
  * @retval lcd_message_t variable
  */
-lcd_message_t* lcd_i2c_RTOS_message_new(uint8_t message, uint8_t exe_time, uint8_t mode)
-{
-	lcd_message_t* lcd_message = malloc(sizeof(*lcd_message));
-	lcd_message->message = message;
-	lcd_message->exe_time = ceil((float)(exe_time*osKernelGetTickFreq()/1000));
-	lcd_message->mode = mode;
-	lcd_message->next_msg = NULL;
-	lcd_message->prev_msg = NULL;
+lcd_message_t lcd_i2c_RTOS_message_new(uint8_t message, uint16_t exe_time, uint8_t mode)
+{
+	lcd_message_t lcd_message;
+	uint16_t units = (exe_time + LCD_EXE_UNIT_US - 1) / LCD_EXE_UNIT_US;
+
+	lcd_message.message = message;
+	lcd_message.exe_time = (units > UINT8_MAX) ? UINT8_MAX : units;
+	lcd_message.mode = mode;
+	lcd_message.enqueued = lcd_i2c_RTOS_stamp();
 	return lcd_message;
 }
 
+/* Next index of the message ring */
+static inline uint8_t lcd_i2c_RTOS_next(uint8_t index)
+{
+	return (index >= BUFFER_SIZE) ? 0 : index + 1;
+}
+
+/* Copies a message into the ring, publishes it, then wakes the consumer if it had caught up */
+static LCD_StatusTypeDef lcd_i2c_RTOS_push(lcd_i2c_RTOS_t* lcd_i2c_RTOS, uint8_t message, uint16_t exe_time, uint8_t mode)
+{
+	uint8_t head = lcd_i2c_RTOS->buffer_head;
+	uint8_t next = lcd_i2c_RTOS_next(head);
+
+	if (next == lcd_i2c_RTOS->buffer_tail) {
+		return LCD_BUFFER_FULL;
+	}
+	// any message queued after the last update ends it, lcd_i2c_RTOS_Write_Bulk() marks its own
+	lcd_i2c_RTOS->last_update.valid = 0;
+	lcd_i2c_RTOS->buffer[head] = lcd_i2c_RTOS_message_new(message, exe_time, mode);
+	__DMB();	// the message is stored before the consumer can see it
+	lcd_i2c_RTOS->buffer_head = next;
+	__DMB();	// a consumer that has not reached head yet will see the message
+	if (lcd_i2c_RTOS->buffer_tail == head && lcd_i2c_RTOS->thread_id != NULL) {
+		osThreadFlagsSet(lcd_i2c_RTOS->thread_id, LCD_FLAG_MESSAGE);
+	}
+	return LCD_OK;
+}
+
+/* Ring distance from the consumer position, to order indexes of the ring */
+static inline uint8_t lcd_i2c_RTOS_distance(lcd_i2c_RTOS_t* lcd_i2c_RTOS, uint8_t index, uint8_t tail)
+{
+	return (index >= tail) ? index - tail : BUFFER_SIZE + 1 - tail + index;
+}
+
+/*
+ * Queues the messages turning a line of the shadow into target, or only counts
+ * them when queue is 0. Short runs of unchanged characters are rewritten instead
+ * of jumping over them.
+ */
+static uint8_t lcd_i2c_RTOS_diff(lcd_i2c_RTOS_t* lcd_i2c_RTOS, uint8_t line, const char* target, uint8_t queue)
+{
+	uint8_t position = lcd_i2c_RTOS->line_address[line];
+	char* shadow = lcd_i2c_RTOS->ddram[line];
+	uint8_t address = lcd_i2c_RTOS->address;
+	uint8_t count = 0;
+	uint8_t i, j;
+
+	for (i = 0; i < lcd_i2c_RTOS->n_chars; i++) {
+		if (target[i] == shadow[i]) {
+			continue;
+		}
+		if (address != position + i) {
+			if (address != LCD_ADDRESS_UNKNOWN && address >= position && address < position + i &&
+					position + i - address <= LCD_JUMP_GAP) {
+				for (j = address - position; j < i; j++, count++) {
+					if (queue) {
+						lcd_i2c_RTOS_push(lcd_i2c_RTOS, shadow[j], 0, MODE_DATA);
+					}
+				}
+			} else {
+				if (queue) {
+					lcd_i2c_RTOS_push(lcd_i2c_RTOS, LCD_SETDDRAMADDR|(position + i), LCD_EXE_SHORT_US, MODE_COMMAND);
+				}
+				count++;
+			}
+		}
+		if (queue) {
+			lcd_i2c_RTOS_push(lcd_i2c_RTOS, target[i], 0, MODE_DATA);
+			shadow[i] = target[i];
+		}
+		count++;
+		address = (lcd_i2c_RTOS->display_mode & LCD_ENTRYLEFT) ? position + i + 1 : LCD_ADDRESS_UNKNOWN;
+	}
+	if (queue) {
+		lcd_i2c_RTOS->address = address;
+	}
+	return count;
+}
+
+/* Takes back the last update if it is still the end of the buffer and the consumer has not started it */
+static uint8_t lcd_i2c_RTOS_retract(lcd_i2c_RTOS_t* lcd_i2c_RTOS, uint8_t line)
+{
+	lcd_update_t* last = &lcd_i2c_RTOS->last_update;
+	uint8_t retracted = 0;
+	uint8_t tail;
+	int32_t lock;
+
+	if (!last->valid || last->line != line || last->end != lcd_i2c_RTOS->buffer_head) {
+		return 0;
+	}
+	// the consumer picks its run with the kernel locked as well
+	lock = osKernelLock();
+	tail = lcd_i2c_RTOS->buffer_tail;
+	if (lcd_i2c_RTOS_distance(lcd_i2c_RTOS, last->start, tail) >= lcd_i2c_RTOS_distance(lcd_i2c_RTOS, lcd_i2c_RTOS->sending_end, tail) &&
+			lcd_i2c_RTOS_distance(lcd_i2c_RTOS, last->start, tail) <= lcd_i2c_RTOS_distance(lcd_i2c_RTOS, last->end, tail)) {
+		lcd_i2c_RTOS->buffer_head = last->start;
+		retracted = 1;
+	}
+	osKernelRestoreLock(lock);
+
+	if (retracted) {
+		memcpy(lcd_i2c_RTOS->ddram[line], last->ddram, LCD_MAX_CHARS);
+		lcd_i2c_RTOS->address = last->address;
+		lcd_i2c_RTOS->updates_replaced++;
+	}
+	last->valid = 0;
+	return retracted;
+}
+
+/* Waits until count messages fit in the buffer, up to timeout ticks */
+static LCD_StatusTypeDef lcd_i2c_RTOS_reserve(lcd_i2c_RTOS_t* lcd_i2c_RTOS, uint8_t count, uint32_t timeout)
+{
+	uint32_t start = osKernelGetTickCount();
+	uint32_t elapsed;
+
+	if (count > BUFFER_SIZE) {
+		return LCD_INVALID_PARAM;
+	}
+	while (BUFFER_SIZE - lcd_i2c_RTOS_Pending(lcd_i2c_RTOS) < count) {
+		elapsed = osKernelGetTickCount() - start;
+		if (timeout == 0 || elapsed >= timeout || osKernelGetState() != osKernelRunning) {
+			return LCD_BUFFER_FULL;
+		}
+		osThreadFlagsClear(LCD_FLAG_SPACE);
+		lcd_i2c_RTOS->space_needed = count;
+		lcd_i2c_RTOS->space_waiter = osThreadGetId();
+		// the consumer may have freed the space before it could see the waiter
+		if (BUFFER_SIZE - lcd_i2c_RTOS_Pending(lcd_i2c_RTOS) < count) {
+			osThreadFlagsWait(LCD_FLAG_SPACE, osFlagsWaitAny, (timeout == osWaitForever) ? osWaitForever : timeout - elapsed);
+		}
+		lcd_i2c_RTOS->space_waiter = NULL;
+	}
+	return LCD_OK;
+}
+
+/* DDRAM is filled with spaces by the clear command */
+static void lcd_i2c_RTOS_shadow_clear(lcd_i2c_RTOS_t* lcd_i2c_RTOS)
+{
+	memset(lcd_i2c_RTOS->ddram, ' ', sizeof(lcd_i2c_RTOS->ddram));
+	lcd_i2c_RTOS->address = 0;
+}
+
+/* Microseconds to cycle counter steps */
+static inline uint32_t lcd_i2c_RTOS_cycles(uint32_t us)
+{
+	return us * (SystemCoreClock / 1000000);
+}
+
+/* Writes expander states, through the shared bus when there is one */
+static HAL_StatusTypeDef lcd_i2c_RTOS_write(lcd_i2c_RTOS_t* lcd_i2c_RTOS, uint8_t* data, uint16_t size)
+{
+	if (lcd_i2c_RTOS->write != NULL) {
+		return lcd_i2c_RTOS->write(lcd_i2c_RTOS->write_context, lcd_i2c_RTOS->addr, data, size);
+	}
+	return HAL_I2C_Master_Transmit(lcd_i2c_RTOS->hi2c, lcd_i2c_RTOS->addr, data, size, 100);
+}
+
+/* Reads the expander pins, through the shared bus when there is one */
+static HAL_StatusTypeDef lcd_i2c_RTOS_read(lcd_i2c_RTOS_t* lcd_i2c_RTOS, uint8_t* data)
+{
+	if (lcd_i2c_RTOS->read != NULL) {
+		return lcd_i2c_RTOS->read(lcd_i2c_RTOS->write_context, lcd_i2c_RTOS->addr, data, 1);
+	}
+	return HAL_I2C_Master_Receive(lcd_i2c_RTOS->hi2c, lcd_i2c_RTOS->addr, data, 1, 100);
+}
+
+/* Reads the busy flag: both nibbles have to be clocked, the flag is in the first one */
+static HAL_StatusTypeDef lcd_i2c_RTOS_read_busy(lcd_i2c_RTOS_t* lcd_i2c_RTOS, uint8_t* busy)
+{
+	uint8_t idle = LCD_PCF8574_INPUT | LCD_PCF8574_BACKLIGHT | LCD_PCF8574_RW;
+	uint8_t high[2] = {idle, idle | LCD_PCF8574_EN};
+	uint8_t low[3] = {idle, idle | LCD_PCF8574_EN, idle};
+	uint8_t pins = 0;
+	HAL_StatusTypeDef status;
+
+	status = lcd_i2c_RTOS_write(lcd_i2c_RTOS, high, sizeof(high));
+	if (status == HAL_OK) {
+		status = lcd_i2c_RTOS_read(lcd_i2c_RTOS, &pins);
+	}
+	if (status == HAL_OK) {
+		status = lcd_i2c_RTOS_write(lcd_i2c_RTOS, low, sizeof(low));
+	}
+	*busy = (status == HAL_OK) && (pins & LCD_PCF8574_BUSY);
+	return status;
+}
+
+/* The busy flag cannot be read: the execution times are counted from now on. With RW
+   tied low the read pulses were taken as commands (0xFF, DDRAM address 0x7F), so the
+   address is sent again before the next character */
+static void lcd_i2c_RTOS_flag_failed(lcd_i2c_RTOS_t* lcd_i2c_RTOS)
+{
+	lcd_i2c_RTOS->busy_mode = LCD_BUSY_TIMER;
+	lcd_i2c_RTOS->busy_flag_failures++;
+	lcd_i2c_RTOS->address = LCD_ADDRESS_UNKNOWN;
+}
+
+/* Reads the flag once the timed run has surely been executed: a display with RW wired reads idle */
+static void lcd_i2c_RTOS_probe(lcd_i2c_RTOS_t* lcd_i2c_RTOS)
+{
+	uint8_t busy;
+
+	lcd_i2c_RTOS->busy_probe = 0;
+	if (lcd_i2c_RTOS_read_busy(lcd_i2c_RTOS, &busy) == HAL_OK && !busy) {
+		lcd_i2c_RTOS->busy_mode = LCD_BUSY_FLAG;
+	} else {
+		lcd_i2c_RTOS_flag_failed(lcd_i2c_RTOS);
+	}
+}
+
+/* Counts the enqueue to wire latency of a message just sent */
+static void lcd_i2c_RTOS_latency(lcd_i2c_RTOS_t* lcd_i2c_RTOS, const lcd_message_t* msg, uint16_t now)
+{
+	uint32_t latency = (uint16_t)(now - msg->enqueued) << LCD_LATENCY_SHIFT;
+	uint8_t bucket = 0;
+
+	while (bucket < LCD_LATENCY_BUCKETS - 1 && latency >= lcd_i2c_RTOS_Latency_Bound(bucket)) {
+		bucket++;
+	}
+	lcd_i2c_RTOS->latency_hist[bucket]++;
+	if (latency > lcd_i2c_RTOS->latency_max) {
+		lcd_i2c_RTOS->latency_max = latency;
+	}
+}
+
+uint32_t lcd_i2c_RTOS_Latency_Bound(uint8_t bucket)
+{
+	return (bucket < LCD_LATENCY_BUCKETS - 1) ? (uint32_t)LCD_LATENCY_BASE_US << bucket : 0;
+}
+
+void lcd_i2c_RTOS_Reset_Latency(lcd_i2c_RTOS_t* lcd_i2c_RTOS)
+{
+	memset(lcd_i2c_RTOS->latency_hist, 0, sizeof(lcd_i2c_RTOS->latency_hist));
+	lcd_i2c_RTOS->latency_max = 0;
+}
+
+uint8_t lcd_i2c_RTOS_Pending(lcd_i2c_RTOS_t* lcd_i2c_RTOS)
+{
+	uint8_t head = lcd_i2c_RTOS->buffer_head;
+	uint8_t tail = lcd_i2c_RTOS->buffer_tail;
+
+	return (head >= tail) ? head - tail : BUFFER_SIZE + 1 - tail + head;
+}
+
 /**
  * @brief  Creates lcd_i2c_RTOS_t variable corresponding to the display on a FreeRTOS environment
  * @param  *hi2c: I2C peripheral used by the mcu
@@ -50,36 +300,64 @@ LCD_StatusTypeDef lcd_i2c_RTOS_Init(lcd_i2c_RTOS_t* lcd_i2c_RTOS, I2C_HandleType
 	if ((n_chars != 16) && (n_chars != 20)) {
 		return LCD_INVALID_PARAM;
 	}
-	if ((n_lines != 1) && (n_lines != 2) && (n_lines != 2)) {
+	if ((n_lines != 1) && (n_lines != 2) && (n_lines != 4)) {
 		return LCD_INVALID_PARAM;
 	}
 
 	lcd_i2c_RTOS->hi2c = hi2c;
 	lcd_i2c_RTOS->addr = addr;
+	lcd_i2c_RTOS->write = NULL;
+	lcd_i2c_RTOS->read = NULL;
+	lcd_i2c_RTOS->write_context = NULL;
 	lcd_i2c_RTOS->n_chars = n_chars;
 	lcd_i2c_RTOS->n_lines = n_lines;
+	// lines 2 and 3 continue lines 0 and 1 in DDRAM
+	lcd_i2c_RTOS->line_address[0] = 0x00;
+	lcd_i2c_RTOS->line_address[1] = 0x40;
+	lcd_i2c_RTOS->line_address[2] = 0x00 + n_chars;
+	lcd_i2c_RTOS->line_address[3] = 0x40 + n_chars;
 	lcd_i2c_RTOS->display_control = LCD_DISPLAYON | LCD_CURSOROFF | LCD_BLINKOFF;
 	lcd_i2c_RTOS->display_mode = LCD_ENTRYLEFT | LCD_ENTRYSHIFTDECREMENT;
-	lcd_i2c_RTOS->buffer_first_msg = NULL;
-	lcd_i2c_RTOS->buffer_last_msg = NULL;
-	lcd_i2c_RTOS->n_messages = 0;
+	lcd_i2c_RTOS->buffer_head = 0;
+	lcd_i2c_RTOS->buffer_tail = 0;
+	lcd_i2c_RTOS->sending_end = 0;
+	lcd_i2c_RTOS->space_waiter = NULL;
+	lcd_i2c_RTOS->last_update.valid = 0;
+	lcd_i2c_RTOS->updates_replaced = 0;
+	lcd_i2c_RTOS->update_bytes = 0;
+	lcd_i2c_RTOS->update_bytes_saved = 0;
+	lcd_i2c_RTOS->run_busy_flag = 0;
+	lcd_i2c_RTOS->busy_mode = LCD_BUSY_TIMER;
+	lcd_i2c_RTOS->busy_probe = 0;
+	lcd_i2c_RTOS->busy_flag_failures = 0;
+	lcd_i2c_RTOS->thread_id = NULL;
+	lcd_i2c_RTOS_Reset_Latency(lcd_i2c_RTOS);
+	lcd_i2c_RTOS_shadow_clear(lcd_i2c_RTOS);
+	lcd_i2c_RTOS_Glyph_Reset(lcd_i2c_RTOS);
+
+	/* Cycle counter used for the execution times */
+	CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+	DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+	// the first run waits for the end of the power on, counted from here
+	lcd_i2c_RTOS->run_exe_time = LCD_EXE_POWER_UP_US;
+	lcd_i2c_RTOS->busy_until = DWT->CYCCNT + lcd_i2c_RTOS_cycles(LCD_EXE_POWER_UP_US);
 
 	if (HAL_I2C_IsDeviceReady(lcd_i2c_RTOS->hi2c, lcd_i2c_RTOS->addr, 1, 20000) != HAL_OK) {
 			/* Return false */
 			return LCD_I2C_ERROR;
 		}
-	// Init code
-	lcd_i2c_RTOS_send_cmd (lcd_i2c_RTOS, 0x30, 5);
-	lcd_i2c_RTOS_send_cmd (lcd_i2c_RTOS, 0x30, 1);
-	lcd_i2c_RTOS_send_cmd (lcd_i2c_RTOS, 0x30, 10);
-	lcd_i2c_RTOS_send_cmd (lcd_i2c_RTOS, 0x20, 10); // 4bit mode
+	// Init code, timed: the busy flag cannot be read before 4 bit mode
+	lcd_i2c_RTOS_push (lcd_i2c_RTOS, 0x30, LCD_EXE_POWER_ON_US, MODE_INIT);
+	lcd_i2c_RTOS_push (lcd_i2c_RTOS, 0x30, LCD_EXE_RESET_US, MODE_INIT);
+	lcd_i2c_RTOS_push (lcd_i2c_RTOS, 0x30, LCD_EXE_RESET_US, MODE_INIT);
+	lcd_i2c_RTOS_push (lcd_i2c_RTOS, 0x20, LCD_EXE_RESET_US, MODE_INIT); // 4bit mode
 
 	// dislay initialisation
-	lcd_i2c_RTOS_send_cmd (lcd_i2c_RTOS, 0x28, 1);	// Function set --> DL=0 (4 bit mode), N = 1 (2 line display) F = 0 (5x8 characters)
-	lcd_i2c_RTOS_send_cmd (lcd_i2c_RTOS, 0x08, 1); 	//Display on/off control --> D=0,C=0, B=0  ---> display off
-	lcd_i2c_RTOS_send_cmd (lcd_i2c_RTOS, 0x01, 2);	// clear display
-	lcd_i2c_RTOS_send_cmd (lcd_i2c_RTOS, 0x06, 1); 	//Entry mode set --> I/D = 1 (increment cursor) & S = 0 (no shift)
-	lcd_i2c_RTOS_send_cmd (lcd_i2c_RTOS, 0x0C, 0); 	//Display on/off control --> D = 1, C and B = 0. (Cursor and blink, last two bits)
+	lcd_i2c_RTOS_send_cmd (lcd_i2c_RTOS, 0x28, LCD_EXE_SHORT_US);	// Function set --> DL=0 (4 bit mode), N = 1 (2 line display) F = 0 (5x8 characters)
+	lcd_i2c_RTOS_send_cmd (lcd_i2c_RTOS, 0x08, LCD_EXE_SHORT_US); 	//Display on/off control --> D=0,C=0, B=0  ---> display off
+	lcd_i2c_RTOS_send_cmd (lcd_i2c_RTOS, 0x01, LCD_EXE_CLEAR_US);	// clear display
+	lcd_i2c_RTOS_send_cmd (lcd_i2c_RTOS, 0x06, LCD_EXE_SHORT_US); 	//Entry mode set --> I/D = 1 (increment cursor) & S = 0 (no shift)
+	lcd_i2c_RTOS_send_cmd (lcd_i2c_RTOS, 0x0C, LCD_EXE_SHORT_US); 	//Display on/off control --> D = 1, C and B = 0. (Cursor and blink, last two bits)
 	return LCD_OK;
 }
 
@@ -94,79 +372,87 @@ LCD_StatusTypeDef lcd_i2c_RTOS_Init(lcd_i2c_RTOS_t* lcd_i2c_RTOS, I2C_HandleType
  */
 LCD_StatusTypeDef lcd_i2c_RTOS_Transmit(lcd_i2c_RTOS_t* lcd_i2c_RTOS)
 {
-	uint8_t data_u, data_l;
-	uint8_t data_t[4];
 	lcd_message_t* msg;
+	uint8_t tail = lcd_i2c_RTOS->buffer_tail;
+	uint8_t count = 0;
+	uint16_t len = 0;
 	uint8_t keep_tx_msg = 1;
+	uint8_t pins;
+	uint16_t now;
+	osThreadId_t waiter;
+	int32_t lock;
+	HAL_StatusTypeDef status;
+
+	if (tail == lcd_i2c_RTOS->buffer_head) {
+		return LCD_BUFFER_EMPTY;
+	}
 
-	while(keep_tx_msg) {
-		if (lcd_i2c_RTOS->n_messages == 0) {
-			return LCD_BUFFER_EMPTY;
-		} else {
-			msg = lcd_i2c_RTOS->buffer_last_msg;
-			data_u = (msg->message&0xf0);
-			data_l = ((msg->message<<4)&0xf0);
-
-			if (msg->mode == MODE_COMMAND) {
-				data_t[0] = data_u|0x0C;  //en=1, rs=0
-				data_t[1] = data_u|0x08;  //en=0, rs=0
-				data_t[2] = data_l|0x0C;  //en=1, rs=0
-				data_t[3] = data_l|0x08;  //en=0, rs=0
-			} else if (msg->mode == MODE_DATA) {
-				data_t[0] = data_u|0x0D;  //en=1, rs=1
-				data_t[1] = data_u|0x09;  //en=0, rs=1
-				data_t[2] = data_l|0x0D;  //en=1, rs=1
-				data_t[3] = data_l|0x09;  //en=0, rs=1
-			} else {
-				return LCD_INVALID_PARAM;
-			}
+	// the run is picked with the kernel locked, so the producer cannot take it back meanwhile
+	lock = osKernelLock();
+	// the run ends with the first message the display needs time to execute
+	while (keep_tx_msg && tail != lcd_i2c_RTOS->buffer_head && count < LCD_STREAM_CHARS) {
+		msg = &lcd_i2c_RTOS->buffer[tail];
+		if ((msg->mode != MODE_COMMAND) && (msg->mode != MODE_DATA) && (msg->mode != MODE_INIT)) {
+			break;
+		}
+		lcd_pcf8574_Expand(&lcd_i2c_RTOS->stream[len], msg->message, msg->mode == MODE_DATA);
+		// until 4 bit mode each EN pulse is a whole instruction, only the high nibble is sent
+		len += (msg->mode == MODE_INIT) ? LCD_PCF8574_BYTES / 2 : LCD_PCF8574_BYTES;
+		lcd_i2c_RTOS->run_exe_time = msg->exe_time * LCD_EXE_UNIT_US;
+		lcd_i2c_RTOS->busy_polls = 0;
+		lcd_i2c_RTOS->run_busy_flag = (msg->mode != MODE_INIT);
+		keep_tx_msg = (msg->exe_time == 0);
+		tail = lcd_i2c_RTOS_next(tail);
+		count++;
+	}
+	lcd_i2c_RTOS->sending_end = tail;
+	osKernelRestoreLock(lock);
+	if (count == 0) {
+		lcd_i2c_RTOS->sending_end = lcd_i2c_RTOS->buffer_tail;
+		return LCD_INVALID_PARAM;
+	}
 
-			if (HAL_I2C_IsDeviceReady(lcd_i2c_RTOS->hi2c, lcd_i2c_RTOS->addr, 1, 10) != HAL_OK) {
-				return LCD_I2C_ERROR;
-			} else {
-				HAL_I2C_Master_Transmit (lcd_i2c_RTOS->hi2c, lcd_i2c_RTOS->addr, (uint8_t *) data_t, 4, 100);
-			}
+	status = lcd_i2c_RTOS_write(lcd_i2c_RTOS, lcd_i2c_RTOS->stream, len);
+	if (status != HAL_OK) {
+		// the messages stay in the buffer for the next attempt
+		lcd_i2c_RTOS->sending_end = lcd_i2c_RTOS->buffer_tail;
+		return LCD_I2C_ERROR;
+	}
+	if (lcd_i2c_RTOS->run_exe_time != 0 && lcd_i2c_RTOS->busy_mode == LCD_BUSY_TIMER && lcd_i2c_RTOS->read != NULL) {
+		// short writes are posted to the bus owner: reading the expander, without any
+		// EN pulse, waits behind them so the timer starts once the command is sent
+		lcd_i2c_RTOS_read(lcd_i2c_RTOS, &pins);
+	}
+	lcd_i2c_RTOS->busy_until = DWT->CYCCNT + lcd_i2c_RTOS_cycles(lcd_i2c_RTOS->run_exe_time);
 
-			if (msg->exe_time != 0) {
-				keep_tx_msg = 0;
-			}
-			lcd_i2c_RTOS->buffer_last_msg = msg->prev_msg;
-			free(msg);
-			lcd_i2c_RTOS->n_messages--;
-			if (lcd_i2c_RTOS->n_messages == 0) {
-				lcd_i2c_RTOS->buffer_first_msg = NULL;
-				lcd_i2c_RTOS->buffer_last_msg = NULL;
-			}
-		}
+	now = lcd_i2c_RTOS_stamp();
+	for (count = lcd_i2c_RTOS->buffer_tail; count != tail; count = lcd_i2c_RTOS_next(count)) {
+		lcd_i2c_RTOS_latency(lcd_i2c_RTOS, &lcd_i2c_RTOS->buffer[count], now);
+	}
+
+	// the slots are handed back to the producer once the messages have been sent
+	__DMB();
+	lcd_i2c_RTOS->buffer_tail = tail;
+
+	waiter = lcd_i2c_RTOS->space_waiter;
+	if (waiter != NULL && BUFFER_SIZE - lcd_i2c_RTOS_Pending(lcd_i2c_RTOS) >= lcd_i2c_RTOS->space_needed) {
+		osThreadFlagsSet(waiter, LCD_FLAG_SPACE);
 	}
 	return LCD_OK;
 }
 
 /**
- * @brief  Push a command to the start of the buffer
+ * @brief  Adds a command to the message buffer
  * @param  lcd_i2c_RTOS: variable targeting the desired display
  * @param  cmd: command to be added to the buffer
- * @param  exe_time: time needed by the display to  execute the command (ms)
+ * @param  exe_time: time needed by the display to  execute the command (us)
  * @retval Status:
  * 				0: The buffer is full
  * 				1: The command was added succesfully
  */
-LCD_StatusTypeDef lcd_i2c_RTOS_send_cmd (lcd_i2c_RTOS_t* lcd_i2c_RTOS, char cmd, uint8_t exe_time)
+LCD_StatusTypeDef lcd_i2c_RTOS_send_cmd (lcd_i2c_RTOS_t* lcd_i2c_RTOS, char cmd, uint16_t exe_time)
 {
-	if (lcd_i2c_RTOS->n_messages >= BUFFER_SIZE) {
-		return LCD_BUFFER_FULL;
-	} else {
-		lcd_message_t* msg = lcd_i2c_RTOS_message_new(cmd, exe_time, MODE_COMMAND);
-		msg->next_msg = lcd_i2c_RTOS->buffer_first_msg;
-		if (lcd_i2c_RTOS->buffer_first_msg != NULL) {
-			lcd_i2c_RTOS->buffer_first_msg->prev_msg = msg;
-		} else {
-			lcd_i2c_RTOS->buffer_last_msg = msg;
-		}
-		lcd_i2c_RTOS->buffer_first_msg = msg;
-		lcd_i2c_RTOS->n_messages++;
-		return LCD_OK;
-	}
+	return lcd_i2c_RTOS_push(lcd_i2c_RTOS, cmd, exe_time, MODE_COMMAND);
 }
 
 /**
@@ -180,42 +466,110 @@ LCD_StatusTypeDef lcd_i2c_RTOS_send_cmd (lcd_i2c_RTOS_t* lcd_i2c_RTOS, char cmd,
  */
 LCD_StatusTypeDef lcd_i2c_RTOS_send_data (lcd_i2c_RTOS_t* lcd_i2c_RTOS, char data)
 {
-	if (lcd_i2c_RTOS->n_messages >= BUFFER_SIZE) {
-		return LCD_BUFFER_FULL;
-	} else {
-		lcd_message_t* msg = lcd_i2c_RTOS_message_new(data, 0, MODE_DATA);
-		msg->next_msg = lcd_i2c_RTOS->buffer_first_msg;
-		msg->prev_msg = NULL;
-		if (lcd_i2c_RTOS->buffer_first_msg != NULL) {
-			lcd_i2c_RTOS->buffer_first_msg->prev_msg = msg;
+	return lcd_i2c_RTOS_push(lcd_i2c_RTOS, data, 0, MODE_DATA);
+}
+
+void lcd_i2c_RTOS_Busy_Mode(lcd_i2c_RTOS_t* lcd_i2c_RTOS, uint8_t busy_mode)
+{
+	// the flag is only used once lcd_i2c_RTOS_probe() has read it idle
+	lcd_i2c_RTOS->busy_mode = LCD_BUSY_TIMER;
+	lcd_i2c_RTOS->busy_probe = (busy_mode == LCD_BUSY_FLAG);
+}
+
+uint8_t lcd_i2c_RTOS_Ready(lcd_i2c_RTOS_t* lcd_i2c_RTOS)
+{
+	uint8_t busy;
+	int32_t remaining;
+
+	if (lcd_i2c_RTOS->run_exe_time == 0) {
+		// the I2C time of a message covers the short commands
+		return 1;
+	}
+
+	if (lcd_i2c_RTOS->busy_mode == LCD_BUSY_FLAG && lcd_i2c_RTOS->run_busy_flag) {
+		if (lcd_i2c_RTOS_read_busy(lcd_i2c_RTOS, &busy) != HAL_OK) {
+			// the expander does not answer: count the time instead
+			lcd_i2c_RTOS_flag_failed(lcd_i2c_RTOS);
+		} else if (!busy) {
+			lcd_i2c_RTOS->run_exe_time = 0;
+			return 1;
+		} else if ((int32_t)(DWT->CYCCNT - lcd_i2c_RTOS->busy_until) > (int32_t)lcd_i2c_RTOS_cycles(LCD_BUSY_MARGIN_US)) {
+			// still busy well past the execution time, the run is done: RW reads back high
+			lcd_i2c_RTOS_flag_failed(lcd_i2c_RTOS);
+			lcd_i2c_RTOS->run_exe_time = 0;
+			return 1;
 		} else {
-			lcd_i2c_RTOS->buffer_last_msg = msg;
+			// one read per call, the other displays are served in between
+			lcd_i2c_RTOS->busy_polls++;
+			lcd_i2c_RTOS->wake_tick = osKernelGetTickCount() + (lcd_i2c_RTOS->busy_polls >= LCD_BUSY_POLLS);
+			return 0;
 		}
-		lcd_i2c_RTOS->buffer_first_msg = msg;
-		lcd_i2c_RTOS->n_messages++;
-		return LCD_OK;
 	}
+
+	// wrap safe difference with the cycle counter, short waits are not worth a tick
+	remaining = (int32_t)(lcd_i2c_RTOS->busy_until - DWT->CYCCNT);
+	if (remaining > (int32_t)lcd_i2c_RTOS_cycles(LCD_BUSY_SPIN_US)) {
+		remaining /= SystemCoreClock / osKernelGetTickFreq();
+		lcd_i2c_RTOS->wake_tick = osKernelGetTickCount() + remaining + 1;
+		return 0;
+	}
+	while ((int32_t)(lcd_i2c_RTOS->busy_until - DWT->CYCCNT) > 0) {
+	}
+	lcd_i2c_RTOS->run_exe_time = 0;
+	if (lcd_i2c_RTOS->busy_probe && lcd_i2c_RTOS->run_busy_flag) {
+		lcd_i2c_RTOS_probe(lcd_i2c_RTOS);
+	}
+	return 1;
 }
 
-extern osThreadId_t lcdSendMessagesHandle;
+uint8_t lcd_i2c_RTOS_Handle_Messages(lcd_i2c_RTOS_t* lcd_i2c_RTOS) {
+	if (lcd_i2c_RTOS_Pending(lcd_i2c_RTOS) == 0 || !lcd_i2c_RTOS_Ready(lcd_i2c_RTOS)) {
+		return lcd_i2c_RTOS_Pending(lcd_i2c_RTOS);
+	}
+	if (lcd_i2c_RTOS_Transmit(lcd_i2c_RTOS) != LCD_OK) {
+		// the run stays in the buffer, try again on the next tick
+		lcd_i2c_RTOS->wake_tick = osKernelGetTickCount() + 1;
+	} else {
+		// the next run is due at once, Ready() tells whether the display agrees
+		lcd_i2c_RTOS->wake_tick = osKernelGetTickCount();
+	}
+	return lcd_i2c_RTOS_Pending(lcd_i2c_RTOS);
+}
 
-void lcd_i2c_RTOS_Handle_Messages(lcd_i2c_RTOS_t* lcd_i2c_RTOS) {
+void lcd_i2c_RTOS_Service(lcd_i2c_RTOS_t** displays, uint8_t n_displays)
+{
 	uint32_t now;
-	uint8_t lcd_busy;
-	static uint32_t tick_cooldown;
+	uint32_t wait;
+	uint8_t pending;
+	uint8_t i;
 
-	if (lcd_i2c_RTOS->n_messages == 0) {
-		osThreadSuspend(osThreadGetId());
-	} else {
-		now = osKernelGetTickCount();
-		if (now > tick_cooldown) {
-//			lcd_busy = get_busy_state
-			lcd_busy = 0;
-			if (lcd_busy == 0) {
-				tick_cooldown = now + lcd_i2c_RTOS->buffer_last_msg->exe_time;
-				lcd_i2c_RTOS_Transmit(lcd_i2c_RTOS);
+	for (i = 0; i < n_displays; i++) {
+		displays[i]->thread_id = osThreadGetId();
+	}
+	for (;;) {
+		osThreadFlagsClear(LCD_FLAG_MESSAGE);
+		pending = 0;
+		wait = osWaitForever;
+
+		// one run per display and pass, so a slow command only holds back its own display
+		for (i = 0; i < n_displays; i++) {
+			if (lcd_i2c_RTOS_Handle_Messages(displays[i]) == 0) {
+				continue;
+			}
+			pending = 1;
+			now = osKernelGetTickCount();
+			if ((int32_t)(displays[i]->wake_tick - now) <= 0) {
+				wait = 0;
+			} else if (displays[i]->wake_tick - now < wait) {
+				wait = displays[i]->wake_tick - now;
 			}
 		}
+
+		if (pending && wait == 0) {
+			continue;
+		}
+		// a message for an idle display ends the wait early
+		osThreadFlagsWait(LCD_FLAG_MESSAGE, osFlagsWaitAny, wait);
 	}
 }
 
@@ -234,50 +588,57 @@ void lcd_i2c_RTOS_Handle_Messages(lcd_i2c_RTOS_t* lcd_i2c_RTOS) {
  */
 LCD_StatusTypeDef lcd_i2c_RTOS_Write(lcd_i2c_RTOS_t* lcd_i2c_RTOS, uint8_t line, uint8_t col, char *str, uint8_t clear)
 {
-	static uint8_t start_line_0 = 0x00;
-	static uint8_t start_line_1 = 0x40;
-	static uint8_t start_line_2, start_line_3;
-	uint8_t position;
+	return lcd_i2c_RTOS_Write_Bulk(lcd_i2c_RTOS, line, col, str, clear, LCD_WRITE_FAILFAST, 0);
+}
 
-	if (lcd_i2c_RTOS->n_chars == 20) {
-		start_line_2 = 0x14;
-		start_line_3 = 0x54;
-	} else if (lcd_i2c_RTOS->n_chars == 16) {
-		start_line_2 = 0x10;
-		start_line_3 = 0x50;
-	}
-	if (col >= lcd_i2c_RTOS->n_chars) {
+LCD_StatusTypeDef lcd_i2c_RTOS_Write_Bulk(lcd_i2c_RTOS_t* lcd_i2c_RTOS, uint8_t line, uint8_t col, const char *str, uint8_t clear,
+		uint8_t mode, uint32_t timeout)
+{
+	char target[LCD_MAX_CHARS];
+	lcd_update_t* last = &lcd_i2c_RTOS->last_update;
+	uint16_t naive;
+	uint8_t count;
+	uint8_t i;
+	LCD_StatusTypeDef ret;
+
+	if (col >= lcd_i2c_RTOS->n_chars || line >= lcd_i2c_RTOS->n_lines) {
 		return LCD_INVALID_PARAM;
-	} else {
-		if ((line == 0) && (lcd_i2c_RTOS->n_lines > 0)) {
-			position = start_line_0;
-		} else if ((line == 1) && (lcd_i2c_RTOS->n_lines > 1)) {
-			position = start_line_1;
-		} else if ((line == 2) && (lcd_i2c_RTOS->n_lines > 2)) {
-			position = start_line_2;
-		} else if ((line == 3) && (lcd_i2c_RTOS->n_lines > 3)) {
-			position = start_line_3;
-		} else {
-			return LCD_INVALID_PARAM;
-		}
 	}
+	// bytes of rewriting the text as sent before the shadow
+	naive = ((clear ? 1 + lcd_i2c_RTOS->n_chars : 0) + 1 + strlen(str)) * LCD_MESSAGE_BYTES;
+
+	if (mode == LCD_WRITE_REPLACE) {
+		// a pending update of the line that has not reached the wire is dropped
+		lcd_i2c_RTOS_retract(lcd_i2c_RTOS, line);
+	}
+
 	if (clear) {
-		lcd_i2c_RTOS_send_cmd (lcd_i2c_RTOS, LCD_SETDDRAMADDR|position, 1);
-		for (int i=0; i<lcd_i2c_RTOS->n_chars; i++) {
-			LCD_StatusTypeDef ret = lcd_i2c_RTOS_send_data (lcd_i2c_RTOS, ' ');
-			if (ret != LCD_OK) {
-				return ret;
-			}
-		}
+		memset(target, ' ', lcd_i2c_RTOS->n_chars);
+	} else {
+		memcpy(target, lcd_i2c_RTOS->ddram[line], lcd_i2c_RTOS->n_chars);
+	}
+	for (i = col; i < lcd_i2c_RTOS->n_chars && *str; i++) {
+		target[i] = *str++;
 	}
 
-	lcd_i2c_RTOS_send_cmd (lcd_i2c_RTOS, LCD_SETDDRAMADDR|(position + col), 1);
-	while (*str) {
-		LCD_StatusTypeDef ret = lcd_i2c_RTOS_send_data (lcd_i2c_RTOS, *str++);
-		if (ret != LCD_OK) {
-			return ret;
-		}
+	// the whole update is queued or nothing is
+	count = lcd_i2c_RTOS_diff(lcd_i2c_RTOS, line, target, 0);
+	ret = lcd_i2c_RTOS_reserve(lcd_i2c_RTOS, count, (mode == LCD_WRITE_FAILFAST) ? 0 : timeout);
+	if (ret != LCD_OK) {
+		return ret;
 	}
+
+	last->line = line;
+	last->start = lcd_i2c_RTOS->buffer_head;
+	last->address = lcd_i2c_RTOS->address;
+	memcpy(last->ddram, lcd_i2c_RTOS->ddram[line], LCD_MAX_CHARS);
+	lcd_i2c_RTOS_diff(lcd_i2c_RTOS, line, target, 1);
+	last->end = lcd_i2c_RTOS->buffer_head;
+	// set once its own messages are queued, the pushes above clear it
+	last->valid = (count != 0);
+
+	lcd_i2c_RTOS->update_bytes = count * LCD_MESSAGE_BYTES;
+	lcd_i2c_RTOS->update_bytes_saved = (naive > lcd_i2c_RTOS->update_bytes) ? naive - lcd_i2c_RTOS->update_bytes : 0;
 	return LCD_OK;
 }
 
@@ -419,7 +780,12 @@ LCD_StatusTypeDef lcd_i2c_RTOS_Autoscroll_Off(lcd_i2c_RTOS_t* lcd_i2c_RTOS)
  */
 LCD_StatusTypeDef lcd_i2c_RTOS_Clear (lcd_i2c_RTOS_t* lcd_i2c_RTOS)
 {
-	return lcd_i2c_RTOS_send_cmd(lcd_i2c_RTOS, LCD_CLEARDISPLAY, 2);
+	LCD_StatusTypeDef ret = lcd_i2c_RTOS_send_cmd(lcd_i2c_RTOS, LCD_CLEARDISPLAY, LCD_EXE_CLEAR_US);
+
+	if (ret == LCD_OK) {
+		lcd_i2c_RTOS_shadow_clear(lcd_i2c_RTOS);
+	}
+	return ret;
 }
 
 /**
@@ -430,7 +796,12 @@ LCD_StatusTypeDef lcd_i2c_RTOS_Clear (lcd_i2c_RTOS_t* lcd_i2c_RTOS)
  */
 LCD_StatusTypeDef lcd_i2c_RTOS_Reset_Poistion(lcd_i2c_RTOS_t* lcd_i2c_RTOS)
 {
-	return lcd_i2c_RTOS_send_cmd(lcd_i2c_RTOS, LCD_RETURNHOME, 2);
+	LCD_StatusTypeDef ret = lcd_i2c_RTOS_send_cmd(lcd_i2c_RTOS, LCD_RETURNHOME, LCD_EXE_CLEAR_US);
+
+	if (ret == LCD_OK) {
+		lcd_i2c_RTOS->address = 0;
+	}
+	return ret;
 }
 
 
@@ -0,0 +1,249 @@
+#include <lcd_i2c_RTOS_glyphs.h>
+
+/* Partial cells of the bar graphs, 1 to 4 pixel columns filled from the left */
+static const uint8_t lcd_bar_glyphs[LCD_BAR_STEPS - 1][LCD_GLYPH_ROWS] = {
+	{0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10},
+	{0x18, 0x18, 0x18, 0x18, 0x18, 0x18, 0x18, 0x18},
+	{0x1C, 0x1C, 0x1C, 0x1C, 0x1C, 0x1C, 0x1C, 0x1C},
+	{0x1E, 0x1E, 0x1E, 0x1E, 0x1E, 0x1E, 0x1E, 0x1E},
+};
+
+/* Segments of the big digits: top bar, bottom bar, both bars */
+static const uint8_t lcd_big_glyphs[3][LCD_GLYPH_ROWS] = {
+	{0x1F, 0x1F, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
+	{0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x1F, 0x1F},
+	{0x1F, 0x1F, 0x00, 0x00, 0x00, 0x00, 0x1F, 0x1F},
+};
+
+/* Cells of the big digits, upper then lower line: F full block, T B M the segments above */
+static const char lcd_big_digits[10][2][4] = {
+	{"FTF", "FBF"}, {"TF ", "BFB"}, {"MMF", "FBB"}, {"MMF", "BBF"}, {"FBF", "  F"},
+	{"FMM", "BBF"}, {"FMM", "FBF"}, {"TTF", "  F"}, {"FMF", "FBF"}, {"FMF", "BBF"},
+};
+static const char lcd_big_minus[2][4] = {"BBB", "   "};
+static const char lcd_big_space[2][4] = {"   ", "   "};
+
+/* Moves the slot at a position of the LRU list to the front */
+static void lcd_glyph_touch(lcd_cgram_t* cgram, uint8_t pos)
+{
+	uint8_t slot = cgram->lru[pos];
+
+	for (; pos > 0; pos--) {
+		cgram->lru[pos] = cgram->lru[pos - 1];
+	}
+	cgram->lru[0] = slot;
+}
+
+/* Slots shown by the DDRAM once the queued messages are sent, one bit each */
+static uint8_t lcd_glyph_on_screen(lcd_i2c_RTOS_t* lcd_i2c_RTOS)
+{
+	uint8_t mask = 0;
+	uint8_t line, i;
+	uint8_t c;
+
+	for (line = 0; line < lcd_i2c_RTOS->n_lines; line++) {
+		for (i = 0; i < lcd_i2c_RTOS->n_chars; i++) {
+			c = lcd_i2c_RTOS->ddram[line][i];
+			if (c < 2 * LCD_CGRAM_SLOTS) {
+				// codes 0-7 and 8-15 both show the CGRAM
+				mask |= 1 << (c % LCD_CGRAM_SLOTS);
+			}
+		}
+	}
+	return mask;
+}
+
+void lcd_i2c_RTOS_Glyph_Reset(lcd_i2c_RTOS_t* lcd_i2c_RTOS)
+{
+	lcd_cgram_t* cgram = &lcd_i2c_RTOS->cgram;
+	uint8_t slot;
+
+	for (slot = 0; slot < LCD_CGRAM_SLOTS; slot++) {
+		cgram->lru[slot] = slot;
+	}
+	cgram->valid = 0;
+	cgram->locked = 0;
+	cgram->hits = 0;
+	cgram->misses = 0;
+}
+
+char lcd_i2c_RTOS_Glyph(lcd_i2c_RTOS_t* lcd_i2c_RTOS, const uint8_t* bitmap)
+{
+	lcd_cgram_t* cgram = &lcd_i2c_RTOS->cgram;
+	uint8_t in_use;
+	uint8_t slot;
+	uint8_t pos;
+	uint8_t row;
+
+	for (pos = 0; pos < LCD_CGRAM_SLOTS; pos++) {
+		slot = cgram->lru[pos];
+		if ((cgram->valid & (1 << slot)) && memcmp(cgram->glyph[slot], bitmap, LCD_GLYPH_ROWS) == 0) {
+			cgram->hits++;
+			cgram->locked |= 1 << slot;
+			lcd_glyph_touch(cgram, pos);
+			return LCD_GLYPH_CODE + slot;
+		}
+	}
+
+	// replacing a glyph on screen would change the characters already shown
+	in_use = cgram->locked | lcd_glyph_on_screen(lcd_i2c_RTOS);
+	for (pos = LCD_CGRAM_SLOTS; pos > 0; pos--) {
+		if (!(in_use & (1 << cgram->lru[pos - 1]))) {
+			break;
+		}
+	}
+	if (pos == 0 || BUFFER_SIZE - lcd_i2c_RTOS_Pending(lcd_i2c_RTOS) < 1 + LCD_GLYPH_ROWS) {
+		return 0;
+	}
+	pos--;
+	slot = cgram->lru[pos];
+
+	lcd_i2c_RTOS_send_cmd(lcd_i2c_RTOS, LCD_SETCGRAMADDR | (slot * LCD_GLYPH_ROWS), LCD_EXE_SHORT_US);
+	for (row = 0; row < LCD_GLYPH_ROWS; row++) {
+		lcd_i2c_RTOS_send_data(lcd_i2c_RTOS, bitmap[row] & 0x1F);
+	}
+	// the address counter now points into the CGRAM
+	lcd_i2c_RTOS->address = LCD_ADDRESS_UNKNOWN;
+
+	memcpy(cgram->glyph[slot], bitmap, LCD_GLYPH_ROWS);
+	cgram->valid |= 1 << slot;
+	cgram->locked |= 1 << slot;
+	cgram->misses++;
+	lcd_glyph_touch(cgram, pos);
+	return LCD_GLYPH_CODE + slot;
+}
+
+void lcd_i2c_RTOS_Glyph_Release(lcd_i2c_RTOS_t* lcd_i2c_RTOS)
+{
+	lcd_i2c_RTOS->cgram.locked = 0;
+}
+
+uint16_t lcd_i2c_RTOS_Glyph_Hit_Rate(lcd_i2c_RTOS_t* lcd_i2c_RTOS)
+{
+	uint32_t total = lcd_i2c_RTOS->cgram.hits + lcd_i2c_RTOS->cgram.misses;
+
+	if (total == 0) {
+		return 0;
+	}
+	return (uint64_t)lcd_i2c_RTOS->cgram.hits * 1000 / total;
+}
+
+LCD_StatusTypeDef lcd_i2c_RTOS_Write_Glyphs(lcd_i2c_RTOS_t* lcd_i2c_RTOS, uint8_t line, uint8_t col, const char* str,
+		uint8_t clear, const lcd_glyph_t* glyphs, uint8_t n_glyphs)
+{
+	char text[LCD_MAX_CHARS + 1];
+	LCD_StatusTypeDef ret;
+	uint8_t i, j;
+
+	for (i = 0; i < LCD_MAX_CHARS && str[i] != '\0'; i++) {
+		text[i] = str[i];
+		for (j = 0; j < n_glyphs; j++) {
+			if (str[i] == glyphs[j].code) {
+				text[i] = lcd_i2c_RTOS_Glyph(lcd_i2c_RTOS, glyphs[j].bitmap);
+				if (text[i] == 0) {
+					text[i] = '?';
+				}
+				break;
+			}
+		}
+	}
+	text[i] = '\0';
+
+	ret = lcd_i2c_RTOS_Write(lcd_i2c_RTOS, line, col, text, clear);
+	lcd_i2c_RTOS_Glyph_Release(lcd_i2c_RTOS);
+	return ret;
+}
+
+LCD_StatusTypeDef lcd_i2c_RTOS_Bar(lcd_i2c_RTOS_t* lcd_i2c_RTOS, uint8_t line, uint8_t col, uint8_t width,
+		uint16_t value, uint16_t max)
+{
+	char text[LCD_MAX_CHARS + 1];
+	uint16_t pixels = 0;
+	LCD_StatusTypeDef ret;
+	uint8_t i;
+
+	if (col >= lcd_i2c_RTOS->n_chars) {
+		return LCD_INVALID_PARAM;
+	}
+	if (width > lcd_i2c_RTOS->n_chars - col) {
+		width = lcd_i2c_RTOS->n_chars - col;
+	}
+	if (max != 0) {
+		pixels = (uint32_t)((value < max) ? value : max) * width * LCD_BAR_STEPS / max;
+	}
+
+	for (i = 0; i < width; i++) {
+		text[i] = ' ';
+	}
+	for (i = 0; i < pixels / LCD_BAR_STEPS; i++) {
+		text[i] = LCD_GLYPH_FULL;
+	}
+	if (pixels % LCD_BAR_STEPS) {
+		text[i] = lcd_i2c_RTOS_Glyph(lcd_i2c_RTOS, lcd_bar_glyphs[pixels % LCD_BAR_STEPS - 1]);
+		if (text[i] == 0) {
+			text[i] = ' ';
+		}
+	}
+	text[width] = '\0';
+
+	ret = lcd_i2c_RTOS_Write(lcd_i2c_RTOS, line, col, text, CLEAR_OFF);
+	lcd_i2c_RTOS_Glyph_Release(lcd_i2c_RTOS);
+	return ret;
+}
+
+LCD_StatusTypeDef lcd_i2c_RTOS_Big_Digits(lcd_i2c_RTOS_t* lcd_i2c_RTOS, uint8_t line, uint8_t col, const char* digits)
+{
+	char text[2][LCD_MAX_CHARS + 1];
+	char segment[3] = {0, 0, 0};
+	const char (*cells)[4];
+	uint8_t len = 0;
+	uint8_t half, i, s;
+	char c;
+	LCD_StatusTypeDef ret;
+
+	if (col >= lcd_i2c_RTOS->n_chars || line + 1 >= lcd_i2c_RTOS->n_lines) {
+		return LCD_INVALID_PARAM;
+	}
+
+	for (; *digits != '\0' && len + LCD_BIG_DIGIT_WIDTH - 1 <= lcd_i2c_RTOS->n_chars - col; digits++) {
+		if (*digits >= '0' && *digits <= '9') {
+			cells = lcd_big_digits[*digits - '0'];
+		} else if (*digits == '-') {
+			cells = lcd_big_minus;
+		} else {
+			cells = lcd_big_space;
+		}
+		for (half = 0; half < 2; half++) {
+			for (i = 0; i < LCD_BIG_DIGIT_WIDTH - 1; i++) {
+				c = cells[half][i];
+				s = (c == 'T') ? 0 : (c == 'B') ? 1 : (c == 'M') ? 2 : 3;
+				if (c == 'F') {
+					c = LCD_GLYPH_FULL;
+				} else if (s < 3) {
+					// the segments are looked up once per call
+					if (segment[s] == 0) {
+						segment[s] = lcd_i2c_RTOS_Glyph(lcd_i2c_RTOS, lcd_big_glyphs[s]);
+					}
+					c = (segment[s] != 0) ? segment[s] : '?';
+				}
+				text[half][len + i] = c;
+			}
+			if (len + LCD_BIG_DIGIT_WIDTH <= lcd_i2c_RTOS->n_chars - col) {
+				text[half][len + LCD_BIG_DIGIT_WIDTH - 1] = ' ';
+			}
+		}
+		len += LCD_BIG_DIGIT_WIDTH;
+		if (len > lcd_i2c_RTOS->n_chars - col) {
+			len = lcd_i2c_RTOS->n_chars - col;
+		}
+	}
+	text[0][len] = '\0';
+	text[1][len] = '\0';
+
+	ret = lcd_i2c_RTOS_Write(lcd_i2c_RTOS, line, col, text[0], CLEAR_OFF);
+	if (ret == LCD_OK) {
+		ret = lcd_i2c_RTOS_Write(lcd_i2c_RTOS, line + 1, col, text[1], CLEAR_OFF);
+	}
+	lcd_i2c_RTOS_Glyph_Release(lcd_i2c_RTOS);
+	return ret;
+}
@@ -0,0 +1,17 @@
+#include <lcd_pcf8574.h>
+
+/* The four writes of a byte: high nibble with EN set then cleared, then the low nibble */
+#define LCD_NIBBLES(c) ( \
+		((uint32_t)(((c) & 0xF0) | LCD_PCF8574_BACKLIGHT | LCD_PCF8574_EN | LCD_PCF8574_RS)) | \
+		((uint32_t)(((c) & 0xF0) | LCD_PCF8574_BACKLIGHT | LCD_PCF8574_RS) << 8) | \
+		((uint32_t)((((c) << 4) & 0xF0) | LCD_PCF8574_BACKLIGHT | LCD_PCF8574_EN | LCD_PCF8574_RS) << 16) | \
+		((uint32_t)((((c) << 4) & 0xF0) | LCD_PCF8574_BACKLIGHT | LCD_PCF8574_RS) << 24))
+
+#define LCD_NIBBLES_4(c)	LCD_NIBBLES(c), LCD_NIBBLES((c) + 1), LCD_NIBBLES((c) + 2), LCD_NIBBLES((c) + 3)
+#define LCD_NIBBLES_16(c)	LCD_NIBBLES_4(c), LCD_NIBBLES_4((c) + 4), LCD_NIBBLES_4((c) + 8), LCD_NIBBLES_4((c) + 12)
+#define LCD_NIBBLES_64(c)	LCD_NIBBLES_16(c), LCD_NIBBLES_16((c) + 16), LCD_NIBBLES_16((c) + 32), LCD_NIBBLES_16((c) + 48)
+
+/* Stored little endian, as the Cortex-M reads it */
+const uint32_t lcd_pcf8574_nibbles[256] = {
+	LCD_NIBBLES_64(0), LCD_NIBBLES_64(64), LCD_NIBBLES_64(128), LCD_NIBBLES_64(192)
+};
@@ -24,8 +24,10 @@
 /* Private includes ----------------------------------------------------------*/
 /* USER CODE BEGIN Includes */
 #include "ssd1306_basic.h"
+#include "ssd1306_widgets.h"
 #include "lcd_i2c.h"
 #include "lcd_i2c_RTOS.h"
+#include "i2c_bus.h"
 /* USER CODE END Includes */
 
 /* Private typedef -----------------------------------------------------------*/
@@ -35,6 +37,8 @@
 
 /* Private define ------------------------------------------------------------*/
 /* USER CODE BEGIN PD */
+#define OLED_MENU_ROWS 5
+
 /* USER CODE END PD */
 
 /* Private macro -------------------------------------------------------------*/
@@ -44,6 +48,7 @@
 
 /* Private variables ---------------------------------------------------------*/
 I2C_HandleTypeDef hi2c1;
+DMA_HandleTypeDef hdma_i2c1_tx;
 
 TIM_HandleTypeDef htim2;
 
@@ -75,6 +80,13 @@ const osThreadAttr_t lcdDisplayUpdat_attributes = {
   .stack_size = 128 * 4,
   .priority = (osPriority_t) osPriorityLow,
 };
+/* Definitions for i2cBusManager */
+osThreadId_t i2cBusManagerHandle;
+const osThreadAttr_t i2cBusManager_attributes = {
+  .name = "i2cBusManager",
+  .stack_size = 256 * 4,
+  .priority = (osPriority_t) osPriorityAboveNormal,
+};
 /* Definitions for mutex_position */
 osMutexId_t mutex_positionHandle;
 const osMutexAttr_t mutex_position_attributes = {
@@ -93,9 +105,16 @@ const osMutexAttr_t mutex_cursor_attributes = {
 	uint32_t now;
 
 	ssd1306_t* ssd1306_1;
+	ssd1306_widget_t menu_cursor[OLED_MENU_ROWS];
+	ssd1306_widget_t menu_rows[OLED_MENU_ROWS];
+	const char* menu_labels[OLED_MENU_ROWS] = {" Menu 1", " Menu 2", " Menu 3", " Menu 4", " Menu 5"};
 	lcd_i2c_t* lcd_i2c_1;
 	lcd_i2c_RTOS_t* lcd_i2c_RTOS_1;
 
+	i2c_bus_t i2c_bus_1;
+	i2c_bus_client_t oled_bus_client;
+	i2c_bus_client_t lcd_bus_client;
+
 	uint32_t tick_begin;
 	uint32_t tick_end;
 	uint32_t time_ms;
@@ -104,12 +123,14 @@ const osMutexAttr_t mutex_cursor_attributes = {
 /* Private function prototypes -----------------------------------------------*/
 void SystemClock_Config(void);
 static void MX_GPIO_Init(void);
+static void MX_DMA_Init(void);
 static void MX_TIM2_Init(void);
 static void MX_I2C1_Init(void);
 void StartEncoderPolling(void *argument);
 void StartOledDisplayUpdate(void *argument);
 void StartlcdSendMessages(void *argument);
 void StartLcdDisplayUpdate(void *argument);
+void StartI2cBusManager(void *argument);
 
 /* USER CODE BEGIN PFP */
 
@@ -147,6 +168,7 @@ int main(void)
 
   /* Initialize all configured peripherals */
   MX_GPIO_Init();
+  MX_DMA_Init();
   MX_TIM2_Init();
   MX_I2C1_Init();
   /* USER CODE BEGIN 2 */
@@ -154,16 +176,17 @@ int main(void)
 //  lcd_i2c_1 = lcd_i2c_new(&hi2c1, 0x27<<1, 16, 2);
   lcd_i2c_RTOS_1 = lcd_i2c_RTOS_new(&hi2c1, 0x27<<1, 16, 2);
 
-  SSD1306_GotoXY(ssd1306_1, 2, 0);
-  SSD1306_Puts(ssd1306_1, "  Menu 1", &Font_11x18, 1);
-  SSD1306_GotoXY(ssd1306_1, 2, 18);
-  SSD1306_Puts(ssd1306_1, "  Menu 2", &Font_11x18, 1);
-  SSD1306_GotoXY(ssd1306_1, 2, 36);
-  SSD1306_Puts(ssd1306_1, "  Menu 3", &Font_11x18, 1);
-  SSD1306_GotoXY(ssd1306_1, 2, 53);
-  SSD1306_Puts(ssd1306_1, "  Menu 4", &Font_7x10, 1);
-  SSD1306_GotoXY(ssd1306_1, SSD1306_WIDTH/2, 53);
-  SSD1306_Puts(ssd1306_1, "  Menu 5", &Font_7x10, 1);
+  /* Menu rows and cursor are drawn once, then only redrawn when they change */
+  for (uint8_t row = 0; row < OLED_MENU_ROWS; row++) {
+	  FontDef_t* font = (row < 3) ? &Font_11x18 : &Font_7x10;
+	  uint16_t x = (row == 4) ? SSD1306_WIDTH/2 : 2;
+	  uint16_t y = (row < 3) ? row*Font_11x18.FontHeight : 3*Font_11x18.FontHeight-1;
+
+	  SSD1306_Widget(&menu_cursor[row], x, y, font, 1);
+	  SSD1306_Widget(&menu_rows[row], x + font->FontWidth, y, font, 7);
+	  SSD1306_WidgetSetText(ssd1306_1, &menu_cursor[row], " ");
+	  SSD1306_WidgetSetText(ssd1306_1, &menu_rows[row], menu_labels[row]);
+  }
   SSD1306_UpdateScreen(ssd1306_1);
 
 
@@ -204,6 +227,19 @@ int main(void)
 
   /* USER CODE BEGIN RTOS_QUEUES */
   /* add queues, ... */
+  /* hi2c1 is shared: from now on the displays go through the bus manager,
+   * the LCD timing first and the OLED frames in the remaining bus time */
+  i2c_bus_Init(&i2c_bus_1, &hi2c1);
+  i2c_bus_Client(&i2c_bus_1, &lcd_bus_client, "lcd", I2C_BUS_PRIO_HIGH);
+  i2c_bus_Client(&i2c_bus_1, &oled_bus_client, "oled", I2C_BUS_PRIO_LOW);
+  lcd_i2c_RTOS_1->write = i2c_bus_Write;
+  lcd_i2c_RTOS_1->read = i2c_bus_Read;
+  lcd_i2c_RTOS_1->write_context = &lcd_bus_client;
+  /* RW of the backpack is wired to P1: once a read after the clear command finds the
+   * flag idle, the slow commands end on the busy flag. Otherwise the timer stays in use */
+  lcd_i2c_RTOS_Busy_Mode(lcd_i2c_RTOS_1, LCD_BUSY_FLAG);
+  ssd1306_1->Write = i2c_bus_MemWrite;
+  ssd1306_1->WriteContext = &oled_bus_client;
   /* USER CODE END RTOS_QUEUES */
 
   /* Create the thread(s) */
@@ -219,6 +255,9 @@ int main(void)
   /* creation of lcdDisplayUpdat */
   lcdDisplayUpdatHandle = osThreadNew(StartLcdDisplayUpdate, NULL, &lcdDisplayUpdat_attributes);
 
+  /* creation of i2cBusManager */
+  i2cBusManagerHandle = osThreadNew(StartI2cBusManager, NULL, &i2cBusManager_attributes);
+
   /* USER CODE BEGIN RTOS_THREADS */
   /* add threads, ... */
   /* USER CODE END RTOS_THREADS */
@@ -369,6 +408,22 @@ static void MX_TIM2_Init(void)
 
 }
 
+/**
+  * Enable DMA controller clock
+  */
+static void MX_DMA_Init(void)
+{
+
+  /* DMA controller clock enable */
+  __HAL_RCC_DMA1_CLK_ENABLE();
+
+  /* DMA interrupt init */
+  /* DMA1_Stream6_IRQn interrupt configuration */
+  HAL_NVIC_SetPriority(DMA1_Stream6_IRQn, 5, 0);
+  HAL_NVIC_EnableIRQ(DMA1_Stream6_IRQn);
+
+}
+
 /**
   * @brief GPIO Initialization Function
   * @param None
@@ -407,6 +462,26 @@ static void MX_GPIO_Init(void)
 }
 
 /* USER CODE BEGIN 4 */
+void HAL_I2C_MasterTxCpltCallback(I2C_HandleTypeDef *hi2c)
+{
+	i2c_bus_TxCpltCallback(&i2c_bus_1, hi2c);
+}
+
+void HAL_I2C_MemTxCpltCallback(I2C_HandleTypeDef *hi2c)
+{
+	i2c_bus_TxCpltCallback(&i2c_bus_1, hi2c);
+}
+
+void HAL_I2C_MasterRxCpltCallback(I2C_HandleTypeDef *hi2c)
+{
+	i2c_bus_RxCpltCallback(&i2c_bus_1, hi2c);
+}
+
+void HAL_I2C_ErrorCallback(I2C_HandleTypeDef *hi2c)
+{
+	i2c_bus_ErrorCallback(&i2c_bus_1, hi2c);
+}
+
 //void HAL_TIM_IC_CaptureCallback(TIM_HandleTypeDef *htim){
 //
 //}
@@ -479,18 +554,22 @@ void StartOledDisplayUpdate(void *argument)
 	  uint16_t cursor_l = cursor_enable;
 	  osMutexRelease(mutex_cursorHandle);
 
+      int16_t position_l = -1;
       if (cursor_l){
           osMutexAcquire(mutex_positionHandle, 0);
-          int16_t position_l = position;
+          position_l = position;
           osMutexRelease(mutex_positionHandle);
+      }
 
-          tick_begin = osKernelGetTickCount();
-          SSD1306_SetCursor(ssd1306_1, position_l);
-          tick_end = osKernelGetTickCount();
-          time_ms = tick_end - tick_begin;
-      } else {
-          SSD1306_ResetCursor(ssd1306_1);
+      /* Unchanged rows cost a compare: nothing is drawn or marked dirty */
+      tick_begin = osKernelGetTickCount();
+      for (uint8_t row = 0; row < OLED_MENU_ROWS; row++) {
+          SSD1306_WidgetSetText(ssd1306_1, &menu_cursor[row], (row == position_l) ? ">" : " ");
       }
+      tick_end = osKernelGetTickCount();
+      time_ms = tick_end - tick_begin;
+
+      /* The bus manager sends the dirty pages through DMA, this task sleeps meanwhile */
       SSD1306_UpdateScreen(ssd1306_1);
 
       tick += 100;
@@ -512,13 +591,9 @@ void StartlcdSendMessages(void *argument)
 {
   /* USER CODE BEGIN StartlcdSendMessages */
   /* Infinite loop */
-	uint32_t tick = osKernelGetTickCount();
-  for(;;)
-  {
-	  lcd_i2c_RTOS_Handle_Messages(lcd_i2c_RTOS_1);
-	  tick += 1;
-	  osDelayUntil(tick);
-  }
+  lcd_i2c_RTOS_t* displays[] = {lcd_i2c_RTOS_1};
+
+  lcd_i2c_RTOS_Service(displays, sizeof(displays) / sizeof(displays[0]));
   osThreadTerminate(NULL);
   /* USER CODE END StartlcdSendMessages */
 }
@@ -538,7 +613,6 @@ void StartLcdDisplayUpdate(void *argument)
 	static uint16_t position_last ;
 	lcd_i2c_RTOS_Write(lcd_i2c_RTOS_1, 0, 0, "Cursor position:", CLEAR_ON);
 	lcd_i2c_RTOS_Write(lcd_i2c_RTOS_1, 1, 0, "0", CLEAR_OFF);
-	osThreadResume(lcdSendMessagesHandle);
 
   for(;;)
   {
@@ -553,8 +627,7 @@ void StartLcdDisplayUpdate(void *argument)
 		  if (position_last != position_l) {
 			  char position_str[5];
 			  sprintf(position_str, "%d", position_l);
-			  lcd_i2c_RTOS_Write(lcd_i2c_RTOS_1, 1, 0, position_str, CLEAR_OFF);
-			  osThreadResume(lcdSendMessagesHandle);
+			  lcd_i2c_RTOS_Write_Bulk(lcd_i2c_RTOS_1, 1, 0, position_str, CLEAR_ON, LCD_WRITE_REPLACE, 0);
 			  position_last = position_l;
 		  }
 	  }
@@ -564,6 +637,22 @@ void StartLcdDisplayUpdate(void *argument)
   /* USER CODE END StartLcdDisplayUpdate */
 }
 
+/* USER CODE BEGIN Header_StartI2cBusManager */
+/**
+* @brief Function implementing the i2cBusManager thread.
+* @param argument: Not used
+* @retval None
+*/
+/* USER CODE END Header_StartI2cBusManager */
+void StartI2cBusManager(void *argument)
+{
+  /* USER CODE BEGIN StartI2cBusManager */
+  /* Infinite loop */
+  i2c_bus_Run(&i2c_bus_1);
+  osThreadTerminate(NULL);
+  /* USER CODE END StartI2cBusManager */
+}
+
  /**
   * @brief  Period elapsed callback in non blocking mode
   * @note   This function is called  when TIM11 interrupt took place, inside
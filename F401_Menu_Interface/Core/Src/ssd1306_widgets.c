@@ -0,0 +1,85 @@
+#include <ssd1306_widgets.h>
+
+/* Position of the slots used by SSD1306_Putint(), 1 to 5 */
+static const uint8_t ssd1306_SlotX[] = {2, 2, 2, 2, 65};
+static const uint8_t ssd1306_SlotY[] = {0, 17, 34, 53, 53};
+
+void SSD1306_Widget(ssd1306_widget_t* widget, uint16_t x, uint16_t y, FontDef_t* font, uint8_t width)
+{
+	uint16_t max;
+
+	widget->x = x;
+	widget->y = y;
+	widget->font = font;
+	widget->width = (width < SSD1306_WIDGET_LENGTH) ? width : SSD1306_WIDGET_LENGTH - 1;
+	/* SSD1306_Putc() draws nothing unless the whole character fits left of the last column */
+	max = (x < SSD1306_WIDTH) ? (SSD1306_WIDTH - 1 - x) / font->FontWidth : 0;
+	if (widget->width > max) {
+		widget->width = max;
+	}
+	widget->cache[widget->width] = '\0';
+	SSD1306_WidgetInvalidate(widget);
+}
+
+void SSD1306_WidgetSlot(ssd1306_widget_t* widget, uint8_t slot)
+{
+	if (slot < 1 || slot > 5) {
+		slot = 1;
+	}
+	SSD1306_Widget(widget, ssd1306_SlotX[slot - 1], ssd1306_SlotY[slot - 1],
+			(slot <= 3) ? &Font_11x18 : &Font_7x10, SSD1306_WIDGET_LENGTH - 1);
+}
+
+void SSD1306_WidgetInvalidate(ssd1306_widget_t* widget)
+{
+	widget->valid = 0;
+}
+
+uint8_t SSD1306_WidgetSetText(ssd1306_t* ssd1306, ssd1306_widget_t* widget, const char* text)
+{
+	uint8_t changed = 0;
+	uint8_t i;
+	char ch;
+
+	for (i = 0; i < widget->width; i++) {
+		ch = (*text != '\0') ? *text++ : ' ';
+		if (widget->valid && widget->cache[i] == ch) {
+			continue;
+		}
+		SSD1306_GotoXY(ssd1306, widget->x + i * widget->font->FontWidth, widget->y);
+		/* A character that was not drawn is never taken as shown */
+		widget->cache[i] = SSD1306_Putc(ssd1306, ch, widget->font, SSD1306_COLOR_WHITE);
+		changed = 1;
+	}
+	widget->valid = 1;
+	return changed;
+}
+
+/* The 2 characters of a unit, as SSD1306_FormatFixed() shows them */
+static void ssd1306_WidgetUnit(char* dst, const char* unit)
+{
+	dst[0] = unit[0];
+	dst[1] = (unit[0] != '\0') ? unit[1] : '\0';
+}
+
+uint8_t SSD1306_WidgetSetFixed(ssd1306_t* ssd1306, ssd1306_widget_t* widget, int32_t value, uint8_t decimals, const char* unit)
+{
+	char str[SSD1306_NUMBER_LENGTH];
+	char shown[2];
+
+	/* The unit is compared by its characters, the caller may reuse its buffer */
+	ssd1306_WidgetUnit(shown, unit);
+	if (widget->valid && memcmp(widget->unit, shown, sizeof(shown)) == 0 && widget->value == value &&
+			widget->decimals == decimals) {
+		return 0;
+	}
+	widget->value = value;
+	widget->decimals = decimals;
+	memcpy(widget->unit, shown, sizeof(shown));
+	return SSD1306_WidgetSetText(ssd1306, widget, SSD1306_FormatFixed(str, value, decimals, unit));
+}
+
+uint8_t SSD1306_WidgetSetInt(ssd1306_t* ssd1306, ssd1306_widget_t* widget, int32_t value, const char* unit)
+{
+	return SSD1306_WidgetSetFixed(ssd1306, widget, value, 0, unit);
+}
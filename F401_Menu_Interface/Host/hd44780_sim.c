@@ -0,0 +1,356 @@
+#include "hd44780_sim.h"
+#include <stdio.h>
+#include <string.h>
+
+/* PCF8574 pins of the backpack */
+#define SIM_RS		0x01
+#define SIM_RW		0x02
+#define SIM_EN		0x04
+#define SIM_DATA	0xF0
+
+lcd_sim_stats_t lcd_sim_stats;
+uint32_t SystemCoreClock = 84000000;
+CoreDebug_Type sim_CoreDebug;
+
+static DWT_Type sim_Dwt;
+static uint64_t sim_Now;
+static uint8_t sim_Verbose;
+static uint8_t sim_RwGrounded;
+
+/* State of the simulated expander and controller */
+static struct {
+	uint16_t addr;
+	uint8_t pins;					/* Expander outputs, high at power on */
+	uint8_t four_bit;
+	uint8_t two_line;
+	uint8_t nibble;					/* 4 bit mode: the next nibble is the low one */
+	uint8_t high;					/* High nibble of the byte being received */
+	uint8_t resets;					/* Function sets received in 8 bit mode */
+	uint8_t entry;					/* Entry mode: I/D and S */
+	uint8_t control;				/* Display control: D, C and B */
+	uint8_t cgram_selected;			/* The address counter points into the CGRAM */
+	uint8_t ac;
+	uint8_t shift;					/* Display shift to the left, modulo the line length */
+	uint8_t ddram[0x80];
+	uint8_t cgram[64];
+	uint64_t busy_until;
+} sim;
+
+uint64_t lcd_sim_Nanoseconds(void)
+{
+	return sim_Now;
+}
+
+void lcd_sim_AdvanceTo(uint64_t ns)
+{
+	if (ns > sim_Now) {
+		sim_Now = ns;
+	}
+}
+
+/* Reading the clock takes a few cycles, so polling loops see the time pass */
+static uint64_t sim_Read(void)
+{
+	sim_Now += LCD_SIM_CLOCK_READ_NS;
+	return sim_Now;
+}
+
+DWT_Type* sim_DWT(void)
+{
+	sim_Dwt.CYCCNT = (uint32_t)(sim_Read() * (SystemCoreClock / 1000000) / 1000);
+	return &sim_Dwt;
+}
+
+uint32_t HAL_GetTick(void)
+{
+	return (uint32_t)(sim_Read() / 1000000);
+}
+
+void HAL_Delay(uint32_t Delay)
+{
+	sim_Now += (uint64_t)Delay * 1000000;
+}
+
+/* Length of a DDRAM line: 2 lines of 40 characters or a single one of 80 */
+static uint8_t sim_LineLength(void)
+{
+	return sim.two_line ? 40 : 80;
+}
+
+/* Address counter after a RAM access or a cursor move */
+static uint8_t sim_Step(uint8_t ac, uint8_t increment)
+{
+	uint8_t length = sim_LineLength();
+	uint8_t base = (sim.two_line && ac >= 0x40) ? 0x40 : 0x00;
+	uint8_t other = sim.two_line ? 0x40 - base : 0x00;
+
+	if (sim.cgram_selected) {
+		return (ac + (increment ? 1 : -1)) & 0x3F;
+	}
+	// the end of a line continues on the other one
+	if (increment) {
+		return (ac - base + 1 < length) ? ac + 1 : other;
+	}
+	return (ac > base) ? ac - 1 : other + length - 1;
+}
+
+static void sim_Execute(uint8_t byte, uint8_t rs)
+{
+	uint64_t exe = LCD_SIM_EXE_NS;
+	uint8_t length = sim_LineLength();
+
+	if (rs) {
+		lcd_sim_stats.data_writes++;
+		if (sim.cgram_selected) {
+			sim.cgram[sim.ac & 0x3F] = byte & 0x1F;
+		} else {
+			sim.ddram[sim.ac & 0x7F] = byte;
+			if (sim.entry & 0x01) {
+				// the display follows the cursor
+				sim.shift = (sim.entry & 0x02) ? (sim.shift + 1) % length : (sim.shift + length - 1) % length;
+			}
+		}
+		sim.ac = sim_Step(sim.ac, sim.entry & 0x02);
+		exe = LCD_SIM_EXE_DATA_NS;
+	} else {
+		lcd_sim_stats.instructions++;
+		if (byte & 0x80) {
+			sim.ac = byte & 0x7F;
+			sim.cgram_selected = 0;
+		} else if (byte & 0x40) {
+			sim.ac = byte & 0x3F;
+			sim.cgram_selected = 1;
+		} else if (byte & 0x20) {
+			if (!sim.four_bit) {
+				// the reset sequence: the first two function sets take longer
+				sim.resets++;
+				exe = (sim.resets == 1) ? LCD_SIM_EXE_RESET1_NS : (sim.resets == 2) ? LCD_SIM_EXE_RESET2_NS : LCD_SIM_EXE_NS;
+			}
+			sim.four_bit = !(byte & 0x10);
+			sim.two_line = (byte & 0x08) != 0;
+		} else if (byte & 0x10) {
+			if (byte & 0x08) {
+				sim.shift = (byte & 0x04) ? (sim.shift + length - 1) % length : (sim.shift + 1) % length;
+			} else {
+				sim.ac = sim_Step(sim.ac, byte & 0x04);
+			}
+		} else if (byte & 0x08) {
+			sim.control = byte & 0x07;
+		} else if (byte & 0x04) {
+			sim.entry = byte & 0x03;
+		} else if (byte & 0x02) {
+			sim.ac = 0;
+			sim.cgram_selected = 0;
+			sim.shift = 0;
+			exe = LCD_SIM_EXE_CLEAR_NS;
+		} else if (byte & 0x01) {
+			memset(sim.ddram, ' ', sizeof(sim.ddram));
+			sim.ac = 0;
+			sim.cgram_selected = 0;
+			sim.shift = 0;
+			sim.entry |= 0x02;
+			exe = LCD_SIM_EXE_CLEAR_NS;
+		}
+	}
+	sim.busy_until = sim_Now + exe;
+}
+
+/* Nibble latched by the falling edge of EN in write mode, not accepted while busy */
+static void sim_Write(uint8_t pins)
+{
+	uint8_t nibble = pins & SIM_DATA;
+	uint8_t rs = pins & SIM_RS;
+
+	if (sim_Now < sim.busy_until) {
+		lcd_sim_stats.violations++;
+		if (sim.busy_until - sim_Now > lcd_sim_stats.early_ns_max) {
+			lcd_sim_stats.early_ns_max = sim.busy_until - sim_Now;
+		}
+		if (sim_Verbose) {
+			fprintf(stderr, "  busy violation at %.3f ms: %s nibble 0x%X, %.1f us early\n", sim_Now * 1e-6,
+					rs ? "data" : "command", nibble >> 4, (sim.busy_until - sim_Now) * 1e-3);
+		}
+		return;
+	}
+	if (!sim.four_bit) {
+		// 8 bit interface: D3-D0 are not wired and read as 0
+		sim_Execute(nibble, rs);
+	} else if (!sim.nibble) {
+		sim.high = nibble;
+		sim.nibble = 1;
+	} else {
+		sim.nibble = 0;
+		sim_Execute(sim.high | nibble >> 4, rs);
+	}
+}
+
+/* Nibble driven by the controller while EN is high in read mode */
+static uint8_t sim_Output(void)
+{
+	uint8_t byte;
+
+	if (sim.pins & SIM_RS) {
+		byte = sim.cgram_selected ? sim.cgram[sim.ac & 0x3F] : sim.ddram[sim.ac & 0x7F];
+	} else {
+		byte = ((sim_Now < sim.busy_until) ? 0x80 : 0x00) | (sim.ac & 0x7F);
+	}
+	return (sim.four_bit && sim.nibble) ? byte << 4 : byte & 0xF0;
+}
+
+/* Falling edge of EN in read mode: ends the nibble read */
+static void sim_ReadEnd(uint8_t pins)
+{
+	if (!(pins & SIM_RS) && !(sim.four_bit && sim.nibble)) {
+		lcd_sim_stats.busy_reads++;
+	}
+	if (sim.four_bit && !sim.nibble) {
+		sim.nibble = 1;
+		return;
+	}
+	sim.nibble = 0;
+	if (pins & SIM_RS) {
+		sim.ac = sim_Step(sim.ac, sim.entry & 0x02);
+	}
+}
+
+/* Pins seen by the controller: a grounded RW keeps it in write mode */
+static uint8_t sim_Controller(uint8_t pins)
+{
+	return sim_RwGrounded ? pins & ~SIM_RW : pins;
+}
+
+/* New expander outputs: the controller reacts to the falling edges of EN */
+static void sim_Pins(uint8_t pins)
+{
+	uint8_t old = sim_Controller(sim.pins);
+
+	sim.pins = pins;
+	pins = sim_Controller(pins);
+	if ((old & SIM_EN) && !(pins & SIM_EN)) {
+		// the data set up while EN was high is latched
+		(old & SIM_RW) ? sim_ReadEnd(old) : sim_Write(old);
+	}
+}
+
+/* Start condition and address byte, acknowledged by the expander or not */
+static HAL_StatusTypeDef sim_Address(I2C_HandleTypeDef *hi2c, uint16_t addr)
+{
+	lcd_sim_stats.transactions++;
+	lcd_sim_stats.wire_bytes++;
+	sim_Now += LCD_SIM_BIT_NS + LCD_SIM_BYTE_NS;
+	if (addr != sim.addr) {
+		lcd_sim_stats.errors++;
+		hi2c->ErrorCode = HAL_I2C_ERROR_AF;
+		sim_Now += LCD_SIM_BIT_NS;
+		return HAL_ERROR;
+	}
+	hi2c->ErrorCode = HAL_I2C_ERROR_NONE;
+	return HAL_OK;
+}
+
+void lcd_sim_Reset(uint16_t addr)
+{
+	memset(&sim, 0, sizeof(sim));
+	sim.addr = addr;
+	sim.pins = 0xFF;
+	/* Power-on RAM content is undefined */
+	memset(sim.ddram, 0xA5, sizeof(sim.ddram));
+	memset(sim.cgram, 0x15, sizeof(sim.cgram));
+	sim.busy_until = sim_Now + LCD_SIM_POWER_ON_NS;
+	lcd_sim_ResetStats();
+}
+
+void lcd_sim_ResetStats(void)
+{
+	memset(&lcd_sim_stats, 0, sizeof(lcd_sim_stats));
+}
+
+void lcd_sim_Verbose(uint8_t verbose)
+{
+	sim_Verbose = verbose;
+}
+
+void lcd_sim_GroundRw(uint8_t grounded)
+{
+	sim_RwGrounded = grounded;
+}
+
+void lcd_sim_Row(uint8_t row, uint8_t n_chars, char* text)
+{
+	uint8_t length = sim_LineLength();
+	uint8_t base = (sim.two_line && (row & 1)) ? 0x40 : 0x00;
+	uint8_t offset = sim.two_line ? (row >> 1) * n_chars : row * n_chars;
+	uint8_t col;
+
+	for (col = 0; col < n_chars; col++) {
+		text[col] = sim.ddram[base + (offset + col + sim.shift) % length];
+	}
+}
+
+uint8_t lcd_sim_Cgram(uint8_t slot, uint8_t row)
+{
+	return sim.cgram[(slot * 8 + row) & 0x3F];
+}
+
+uint8_t lcd_sim_Ready(void)
+{
+	return sim.four_bit && sim.two_line && (sim.control & 0x04);
+}
+
+HAL_StatusTypeDef HAL_I2C_IsDeviceReady(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint32_t Trials, uint32_t Timeout)
+{
+	HAL_StatusTypeDef status;
+
+	(void)Trials;
+	(void)Timeout;
+	status = sim_Address(hi2c, DevAddress);
+	sim_Now += LCD_SIM_BIT_NS;
+	return status;
+}
+
+HAL_StatusTypeDef HAL_I2C_Master_Transmit(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint8_t *pData, uint16_t Size, uint32_t Timeout)
+{
+	(void)Timeout;
+	if (sim_Address(hi2c, DevAddress) != HAL_OK) {
+		return HAL_ERROR;
+	}
+	while (Size--) {
+		// the outputs change once the byte is acknowledged
+		sim_Now += LCD_SIM_BYTE_NS;
+		lcd_sim_stats.wire_bytes++;
+		sim_Pins(*pData++);
+	}
+	sim_Now += LCD_SIM_BIT_NS;
+	return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_I2C_Master_Receive(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint8_t *pData, uint16_t Size, uint32_t Timeout)
+{
+	uint8_t input;
+
+	(void)Timeout;
+	if (sim_Address(hi2c, DevAddress) != HAL_OK) {
+		return HAL_ERROR;
+	}
+	lcd_sim_stats.reads++;
+	while (Size--) {
+		// quasi-bidirectional pins: a pin reads low if the expander or the controller pulls it low
+		input = 0xFF;
+		if ((sim.pins & SIM_EN) && (sim_Controller(sim.pins) & SIM_RW)) {
+			input = sim_Output() | ~SIM_DATA;
+		}
+		if (sim_RwGrounded) {
+			input &= ~SIM_RW;
+		}
+		sim_Now += LCD_SIM_BYTE_NS;
+		lcd_sim_stats.wire_bytes++;
+		*pData++ = sim.pins & input;
+	}
+	sim_Now += LCD_SIM_BIT_NS;
+	return HAL_OK;
+}
+
+uint32_t HAL_I2C_GetError(I2C_HandleTypeDef *hi2c)
+{
+	return hi2c->ErrorCode;
+}
@@ -0,0 +1,96 @@
+#ifndef HD44780_SIM_H
+#define HD44780_SIM_H
+
+/*
+ *  Host simulator of an HD44780 behind a PCF8574 backpack. The time is
+ *  simulated: it advances with the bytes on the wire at 400 kHz, with the
+ *  waits of the kernel stub and a little with each read of the clock. Every
+ *  expander write is replayed on the pins, so the controller sees the EN
+ *  edges, runs the 8 bit reset sequence and the 4 bit instructions, and
+ *  flags the nibbles that arrive while it is still executing.
+ */
+
+#include "main.h"
+
+#define LCD_SIM_BIT_NS			2500		/* 400 kHz I2C */
+#define LCD_SIM_BYTE_NS			(9 * LCD_SIM_BIT_NS)	/* 8 bits and the acknowledge */
+#define LCD_SIM_CLOCK_READ_NS	50			/* Cost of a read of the cycle counter or the tick */
+
+#define LCD_SIM_POWER_ON_NS		40000000ULL	/* Power on before the first instruction */
+#define LCD_SIM_EXE_NS			37000		/* Most instructions */
+#define LCD_SIM_EXE_DATA_NS		41000		/* RAM writes, 37 us and the address update */
+#define LCD_SIM_EXE_CLEAR_NS	1520000		/* Clear display and return home */
+#define LCD_SIM_EXE_RESET1_NS	4100000		/* First function set of the reset sequence */
+#define LCD_SIM_EXE_RESET2_NS	100000		/* Second function set of the reset sequence */
+
+/**
+ * @brief  Bus and controller statistics, cleared by @ref lcd_sim_ResetStats()
+ */
+typedef struct {
+	uint32_t transactions;	/*!< I2C transactions, reads included */
+	uint32_t wire_bytes;	/*!< Bytes on the wire: address and payload */
+	uint32_t reads;			/*!< Read transactions */
+	uint32_t instructions;	/*!< Instructions executed */
+	uint32_t data_writes;	/*!< DDRAM and CGRAM bytes written */
+	uint32_t busy_reads;	/*!< Busy flag reads, the first nibble of a read with RS low */
+	uint32_t violations;	/*!< Nibbles written while the controller was busy */
+	uint64_t early_ns_max;	/*!< Worst violation, time left to the end of the execution */
+	uint32_t errors;		/*!< Transactions not acknowledged */
+} lcd_sim_stats_t;
+
+extern lcd_sim_stats_t lcd_sim_stats;
+
+/**
+ * @brief  Powers the simulated display on at the current time
+ * @param  addr: 8-bit I2C address of the expander, any other address is not acknowledged
+ * @retval None
+ */
+void lcd_sim_Reset(uint16_t addr);
+
+/**
+ * @brief  Clears the statistics
+ */
+void lcd_sim_ResetStats(void);
+
+/**
+ * @brief  Prints the violations on stderr as they happen
+ */
+void lcd_sim_Verbose(uint8_t verbose);
+
+/**
+ * @brief  Ties RW of the display to ground, as on the backpacks without RW wired
+ * @note   The controller stays in write mode: the reads of the expander return its own
+ *         outputs and their EN pulses are latched as nibbles. Kept across resets
+ */
+void lcd_sim_GroundRw(uint8_t grounded);
+
+/**
+ * @brief  Simulated time since the start of the program, in nanoseconds
+ */
+uint64_t lcd_sim_Nanoseconds(void);
+
+/**
+ * @brief  Moves the simulated time forward, earlier times are ignored
+ */
+void lcd_sim_AdvanceTo(uint64_t ns);
+
+/**
+ * @brief  Characters shown by a row of the panel, display shift included
+ * @param  row: row of the panel, rows 2 and 3 continue rows 0 and 1
+ * @param  n_chars: columns of the panel
+ * @param  text: n_chars character codes, not terminated
+ * @retval None
+ */
+void lcd_sim_Row(uint8_t row, uint8_t n_chars, char* text);
+
+/**
+ * @brief  Row of 5 pixels of a CGRAM glyph
+ */
+uint8_t lcd_sim_Cgram(uint8_t slot, uint8_t row);
+
+/**
+ * @brief  Controller configured: 4 bit interface, 2 lines and display on
+ */
+uint8_t lcd_sim_Ready(void);
+
+#endif
@@ -0,0 +1,325 @@
+/*
+ *  LCD benchmark: runs the lcd_i2c and lcd_i2c_RTOS drivers against the
+ *  simulated HD44780 and reports, per write, the bytes and transactions on
+ *  the bus and the simulated time until the update has left the queue. The
+ *  nibbles sent while the controller was busy are counted, and the emulated
+ *  DDRAM and CGRAM are checked against the shadow of the driver. The rwgnd
+ *  runs ask for the busy flag on a backpack with RW grounded, the driver has
+ *  to fall back to the timer.
+ *
+ *  Usage: lcd_bench [-v]    -v prints every busy violation
+ */
+#include <stdio.h>
+#include <string.h>
+#include "lcd_i2c.h"
+#include "lcd_i2c_RTOS.h"
+#include "lcd_i2c_RTOS_glyphs.h"
+#include "hd44780_sim.h"
+#include "rtos_sim.h"
+
+#define BENCH_ADDR			(0x27 << 1)
+#define BENCH_CHARS			16
+#define BENCH_LINES			2
+#define BENCH_DRAIN_NS		10000000000ULL	/* A queue not sent in 10 s of simulated time is stuck */
+
+typedef struct {
+	const char* name;
+	/* Queues the updates of a step, returns the number of writes */
+	uint8_t (*step)(lcd_i2c_RTOS_t* lcd, uint32_t i);
+	uint32_t steps;
+} bench_scenario_t;
+
+static I2C_HandleTypeDef bench_i2c;
+static lcd_i2c_RTOS_t bench_lcd;
+static lcd_i2c_t bench_blocking;
+static char bench_screen[BENCH_LINES][BENCH_CHARS];	/* Expected screen of the blocking driver */
+
+
+/**	--- Sending thread of the firmware --- **/
+
+
+/* lcd_i2c_RTOS_Service() for a single display, run until it would wait */
+static void bench_Sender(void)
+{
+	while (lcd_i2c_RTOS_Handle_Messages(&bench_lcd) != 0 &&
+			(int32_t)(bench_lcd.wake_tick - osKernelGetTickCount()) <= 0) {
+	}
+}
+
+/* Sends the whole queue, sleeping until the wake tick whenever the display is busy. 0 if it never empties */
+static uint8_t bench_Drain(void)
+{
+	uint64_t deadline = lcd_sim_Nanoseconds() + BENCH_DRAIN_NS;
+
+	while (lcd_i2c_RTOS_Pending(&bench_lcd) != 0) {
+		if (lcd_sim_Nanoseconds() > deadline) {
+			return 0;
+		}
+		bench_Sender();
+		if (lcd_i2c_RTOS_Pending(&bench_lcd) != 0) {
+			lcd_sim_AdvanceTo((uint64_t)bench_lcd.wake_tick * 1000000);
+		}
+	}
+	return 1;
+}
+
+/* Emulated display against the shadow and the resident glyphs of the driver */
+static uint8_t bench_Check(lcd_i2c_RTOS_t* lcd)
+{
+	char row[LCD_MAX_CHARS];
+	uint8_t line, slot, r;
+
+	for (line = 0; line < lcd->n_lines; line++) {
+		lcd_sim_Row(line, lcd->n_chars, row);
+		if (memcmp(row, lcd->ddram[line], lcd->n_chars) != 0) {
+			return 0;
+		}
+	}
+	for (slot = 0; slot < LCD_CGRAM_SLOTS; slot++) {
+		for (r = 0; (lcd->cgram.valid & (1 << slot)) && r < LCD_GLYPH_ROWS; r++) {
+			if (lcd_sim_Cgram(slot, r) != (lcd->cgram.glyph[slot][r] & 0x1F)) {
+				return 0;
+			}
+		}
+	}
+	return lcd_sim_Ready();
+}
+
+
+/**	--- Scenarios of the menu firmware --- **/
+
+
+/* Value refreshed in place, as the cursor position of main.c */
+static uint8_t step_Counter(lcd_i2c_RTOS_t* lcd, uint32_t i)
+{
+	char text[12];
+
+	snprintf(text, sizeof(text), "%5lu", (unsigned long)(i * 37));
+	lcd_i2c_RTOS_Write(lcd, 1, 4, text, CLEAR_OFF);
+	return 1;
+}
+
+static uint8_t step_FullLine(lcd_i2c_RTOS_t* lcd, uint32_t i)
+{
+	lcd_i2c_RTOS_Write(lcd, 0, 0, (i & 1) ? "Cursor position:" : "Menu 1  >  Run", CLEAR_ON);
+	return 1;
+}
+
+static uint8_t step_Cursor(lcd_i2c_RTOS_t* lcd, uint32_t i)
+{
+	lcd_i2c_RTOS_Write(lcd, 0, 0, (i & 1) ? " " : ">", CLEAR_OFF);
+	lcd_i2c_RTOS_Write(lcd, 1, 0, (i & 1) ? ">" : " ", CLEAR_OFF);
+	return 2;
+}
+
+/* Page change: a clear, 1.52 ms of execution, then both lines */
+static uint8_t step_Page(lcd_i2c_RTOS_t* lcd, uint32_t i)
+{
+	char text[LCD_MAX_CHARS + 1];
+
+	lcd_i2c_RTOS_Clear(lcd);
+	snprintf(text, sizeof(text), "Page %lu", (unsigned long)(i % 10));
+	lcd_i2c_RTOS_Write(lcd, 0, 0, text, CLEAR_OFF);
+	lcd_i2c_RTOS_Write(lcd, 1, 0, "> Back", CLEAR_OFF);
+	return 3;
+}
+
+/* Updates faster than the display, each one replacing the previous one still queued */
+static uint8_t step_Replace(lcd_i2c_RTOS_t* lcd, uint32_t i)
+{
+	char text[12];
+	uint8_t k;
+
+	for (k = 0; k < 10; k++) {
+		snprintf(text, sizeof(text), "%5lu", (unsigned long)(i * 10 + k));
+		lcd_i2c_RTOS_Write_Bulk(lcd, 1, 4, text, CLEAR_OFF, LCD_WRITE_REPLACE, 0);
+	}
+	return 10;
+}
+
+static uint8_t step_Bar(lcd_i2c_RTOS_t* lcd, uint32_t i)
+{
+	lcd_i2c_RTOS_Bar(lcd, 1, 0, BENCH_CHARS, i % 81, 80);
+	return 1;
+}
+
+static uint8_t step_BigDigits(lcd_i2c_RTOS_t* lcd, uint32_t i)
+{
+	char text[8];
+
+	snprintf(text, sizeof(text), "%4lu", (unsigned long)(i * 7 % 10000));
+	lcd_i2c_RTOS_Big_Digits(lcd, 0, 0, text);
+	return 1;
+}
+
+static const bench_scenario_t bench_scenarios[] = {
+	{"counter",    step_Counter,   100},
+	{"full_line",  step_FullLine,  100},
+	{"cursor",     step_Cursor,    100},
+	{"page",       step_Page,      50},
+	{"replace",    step_Replace,   50},
+	{"bar",        step_Bar,       100},
+	{"big_digits", step_BigDigits, 50},
+};
+
+static uint8_t bench_Init(uint8_t busy_mode, uint8_t rw_grounded)
+{
+	lcd_sim_GroundRw(rw_grounded);
+	lcd_sim_Reset(BENCH_ADDR);
+	memset(&bench_lcd, 0, sizeof(bench_lcd));
+	lcd_i2c_RTOS_Init(&bench_lcd, &bench_i2c, BENCH_ADDR, BENCH_CHARS, BENCH_LINES);
+	lcd_i2c_RTOS_Busy_Mode(&bench_lcd, busy_mode);
+	return bench_Drain();
+}
+
+/* With RW grounded the flag must be found unreadable once, and the timer used instead */
+static const char* bench_Result(uint8_t sent, uint8_t rw_grounded)
+{
+	if (!sent) {
+		return "STUCK";
+	}
+	if (!bench_Check(&bench_lcd)) {
+		return "DDRAM MISMATCH";
+	}
+	if (rw_grounded && (bench_lcd.busy_mode != LCD_BUSY_TIMER || bench_lcd.busy_flag_failures != 1)) {
+		return "NO FALLBACK";
+	}
+	return "ok";
+}
+
+static void bench_Scenario(const bench_scenario_t* s, uint8_t busy_mode, uint8_t rw_grounded)
+{
+	uint64_t t0;
+	uint32_t writes = 0;
+	uint32_t i;
+	uint8_t sent;
+
+	sent = bench_Init(busy_mode, rw_grounded);
+	lcd_i2c_RTOS_Reset_Latency(&bench_lcd);
+	bench_lcd.updates_replaced = 0;
+	lcd_sim_ResetStats();
+
+	t0 = lcd_sim_Nanoseconds();
+	for (i = 0; sent && i < s->steps; i++) {
+		writes += s->step(&bench_lcd, i);
+		sent = bench_Drain();
+	}
+	if (writes == 0) {
+		writes = 1;
+	}
+
+	printf("%-11s %-5s %6lu %8.1f %8.1f %6.2f %9.1f %9lu %6lu %5lu %s\n", s->name,
+			rw_grounded ? "rwgnd" : busy_mode == LCD_BUSY_FLAG ? "flag" : "timer", (unsigned long)writes,
+			(double)lcd_sim_stats.wire_bytes / writes, (double)lcd_sim_stats.transactions / writes,
+			(double)lcd_sim_stats.reads / writes, (lcd_sim_Nanoseconds() - t0) * 1e-3 / writes,
+			(unsigned long)bench_lcd.latency_max, (unsigned long)bench_lcd.updates_replaced,
+			(unsigned long)lcd_sim_stats.violations, bench_Result(sent, rw_grounded));
+}
+
+
+/**	--- Blocking driver --- **/
+
+
+static void bench_BlockingWrite(uint8_t line, uint8_t col, char* str)
+{
+	if (lcd_i2c_Write(&bench_blocking, line, col, str)) {
+		memcpy(&bench_screen[line][col], str, strnlen(str, BENCH_CHARS - col));
+	}
+}
+
+static void bench_Blocking(const char* name, uint8_t full_line)
+{
+	char row[BENCH_CHARS];
+	char text[12];
+	uint64_t t0;
+	uint32_t i;
+	uint8_t ok = 1;
+	uint8_t line;
+
+	lcd_sim_Reset(BENCH_ADDR);
+	lcd_i2c_Init(&bench_blocking, &bench_i2c, BENCH_ADDR, BENCH_CHARS, BENCH_LINES);
+	memset(bench_screen, ' ', sizeof(bench_screen));
+	lcd_sim_ResetStats();
+
+	t0 = lcd_sim_Nanoseconds();
+	for (i = 0; i < 100; i++) {
+		if (full_line) {
+			bench_BlockingWrite(0, 0, (i & 1) ? "Cursor position:" : "Menu 1  >  Run  ");
+		} else {
+			snprintf(text, sizeof(text), "%5lu", (unsigned long)(i * 37));
+			bench_BlockingWrite(1, 4, text);
+		}
+	}
+
+	for (line = 0; line < BENCH_LINES; line++) {
+		lcd_sim_Row(line, BENCH_CHARS, row);
+		ok &= (memcmp(row, bench_screen[line], BENCH_CHARS) == 0);
+	}
+	printf("%-11s %-5s %6u %8.1f %8.1f %6.2f %9.1f %9s %6s %5lu %s\n", name, "-", 100,
+			lcd_sim_stats.wire_bytes / 100.0, lcd_sim_stats.transactions / 100.0, lcd_sim_stats.reads / 100.0,
+			(lcd_sim_Nanoseconds() - t0) * 1e-3 / 100, "-", "-",
+			(unsigned long)lcd_sim_stats.violations, ok ? "ok" : "DDRAM MISMATCH");
+}
+
+
+/**	--- Initialization --- **/
+
+
+static void bench_InitReport(const char* name, uint64_t t0, uint8_t ok)
+{
+	printf("%-24s %9.2f %6lu %6lu %5lu %s\n", name, (lcd_sim_Nanoseconds() - t0) * 1e-6,
+			(unsigned long)lcd_sim_stats.wire_bytes, (unsigned long)lcd_sim_stats.transactions,
+			(unsigned long)lcd_sim_stats.violations, ok ? "ready" : "failed");
+}
+
+static void bench_InitAll(void)
+{
+	uint64_t t0;
+	uint8_t ok;
+
+	printf("Initialization from power on\n");
+	printf("%-24s %9s %6s %6s %5s %s\n", "driver", "ms", "bytes", "trans", "viol", "result");
+
+	lcd_sim_Reset(BENCH_ADDR);
+	t0 = lcd_sim_Nanoseconds();
+	ok = lcd_i2c_Init(&bench_blocking, &bench_i2c, BENCH_ADDR, BENCH_CHARS, BENCH_LINES);
+	bench_InitReport("lcd_i2c", t0, ok && lcd_sim_Ready());
+
+	// no panel at the address: the first command is not acknowledged
+	lcd_sim_Reset(BENCH_ADDR);
+	t0 = lcd_sim_Nanoseconds();
+	ok = lcd_i2c_Init(&bench_blocking, &bench_i2c, BENCH_ADDR + 2, BENCH_CHARS, BENCH_LINES);
+	bench_InitReport("lcd_i2c, no panel", t0, ok);
+
+	lcd_sim_Reset(BENCH_ADDR);
+	t0 = lcd_sim_Nanoseconds();
+	memset(&bench_lcd, 0, sizeof(bench_lcd));
+	ok = (lcd_i2c_RTOS_Init(&bench_lcd, &bench_i2c, BENCH_ADDR, BENCH_CHARS, BENCH_LINES) == LCD_OK);
+	bench_Drain();
+	bench_InitReport("lcd_i2c_RTOS", t0, ok && lcd_sim_Ready());
+}
+
+int main(int argc, char** argv)
+{
+	uint8_t i;
+
+	lcd_sim_Verbose(argc > 1 && strcmp(argv[1], "-v") == 0);
+	// a producer waiting for room lets the sender run
+	rtos_sim_Idle(bench_Sender);
+
+	bench_InitAll();
+
+	printf("\nPer write averages (%ux%u display, I2C at 400 kHz)\n", BENCH_CHARS, BENCH_LINES);
+	printf("%-11s %-5s %6s %8s %8s %6s %9s %9s %6s %5s %s\n", "scenario", "busy", "writes", "bytes", "transact",
+			"reads", "us", "lat max", "repl", "viol", "DDRAM");
+	for (i = 0; i < sizeof(bench_scenarios) / sizeof(bench_scenarios[0]); i++) {
+		bench_Scenario(&bench_scenarios[i], LCD_BUSY_TIMER, 0);
+		bench_Scenario(&bench_scenarios[i], LCD_BUSY_FLAG, 0);
+	}
+	// backpack without RW wired, the flag asked for all the same
+	bench_Scenario(&bench_scenarios[0], LCD_BUSY_FLAG, 1);
+	bench_Scenario(&bench_scenarios[3], LCD_BUSY_FLAG, 1);
+	bench_Blocking("blk_counter", 0);
+	bench_Blocking("blk_line", 1);
+	return 0;
+}
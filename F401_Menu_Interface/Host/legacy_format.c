@@ -0,0 +1,96 @@
+/*
+ *  Number formatters of the driver before the integer rewrite, kept as the
+ *  reference of the formatting benchmark. They return static buffers.
+ */
+#include <stdio.h>
+#include <math.h>
+#include <stdint.h>
+
+char* legacy_int_str(int integer, char* unit);
+char* legacy_double_str(double number, uint8_t decimals, char* unit);
+
+static uint8_t legacy_digits(int integer){
+	uint8_t digits;
+	if (integer==0){
+		digits = 1;
+	}
+	else {
+		digits = floor(log10(integer))+1;
+	}
+	return digits;
+}
+
+char* legacy_int_str(int integer,  char* unit){
+	char negative = ' ';
+	if (integer < 0) {
+		integer = -integer;
+		negative = '-';
+	}
+
+	int size = legacy_digits(integer);
+	if (size > 7){
+			return "OVERLOAD";
+	}
+	char data_char[12];	// the original had no room for the terminator
+	snprintf(data_char, sizeof(data_char), "%d", integer);
+
+	static char legacy_int_str[11];
+	for(int i=1; i<11; i++){
+		if (i<size+1){
+			legacy_int_str[i] = data_char[i-1];
+		} else if (i < 9){
+			legacy_int_str[i] = ' ';
+		} else {
+			legacy_int_str[i] = unit[i-9];
+		}
+	}
+	legacy_int_str[0] = negative;
+	legacy_int_str[8] = ' ';
+	return legacy_int_str;
+}
+
+char* legacy_double_str(double number, uint8_t decimals, char* unit){
+
+	uint8_t negative = ' ';
+	if (number < 0) {
+		number = -number;
+		negative = '-';
+	}
+
+	number = round(number*pow(10, decimals));
+	uint8_t size;
+	if (number == 0){
+		size = decimals+1;
+	} else {
+		size = legacy_digits(number);
+	}
+	if (size > 6) {
+		return "OVERLOAD";
+	}
+
+	char data_char[12];	// the original had no room for the terminator
+	if (number == 0){
+		for(uint8_t i=0;i<size;i++){
+			data_char[i]='0';
+		}
+	} else {
+		snprintf(data_char, sizeof(data_char), "%d", (int)number);
+	}
+
+	static char legacy_double_str[11];
+	for(int8_t i=1; i<11; i++){
+		if (i < (size-decimals+1)){
+			legacy_double_str[i] = data_char[i-1];
+		} else if (i < size+2){
+			legacy_double_str[i] = data_char[i-2];
+		} else if (i < 11-2){
+			legacy_double_str[i] = ' ';
+		} else {
+			legacy_double_str[i] = unit[i-9];
+		}
+	}
+	legacy_double_str[0] = negative;
+	legacy_double_str[size-decimals+1] = '.';
+	legacy_double_str[8] = ' ';
+	return legacy_double_str;
+}
@@ -0,0 +1,323 @@
+/*
+ *  OLED benchmark: runs the drawing scenarios of the menu firmware on the
+ *  simulated SSD1306 and reports, per frame, the bytes and transactions on
+ *  the bus and the host CPU time of the draw and update calls. A PBM
+ *  snapshot of the virtual GRAM is written at the end of every scenario.
+ *
+ *  Usage: oled_bench [output directory]
+ */
+#include <stdio.h>
+#include <string.h>
+#include "ssd1306_basic.h"
+#include "ssd1306_widgets.h"
+#include "ssd1306_sim.h"
+
+#define BENCH_ADDR			(0x3C << 1)
+#define BENCH_GRAM			128				/* SSD1306 columns */
+#define BENCH_MENU_ROWS		5
+
+char* legacy_int_str(int integer, char* unit);
+char* legacy_double_str(double number, uint8_t decimals, char* unit);
+
+typedef struct {
+	const char* name;
+	void (*setup)(ssd1306_t* ssd1306);
+	void (*draw)(ssd1306_t* ssd1306, uint32_t frame);
+	uint32_t frames;
+	uint8_t async;				/* Flush with SSD1306_UpdateScreenAsync() through "DMA" */
+} bench_scenario_t;
+
+static I2C_HandleTypeDef bench_i2c;
+static uint8_t bench_dma;		/* Any non NULL hdmatx selects the DMA path */
+static ssd1306_t bench_oled;
+static ssd1306_widget_t menu_cursor[BENCH_MENU_ROWS];
+static ssd1306_widget_t menu_rows[BENCH_MENU_ROWS];
+static ssd1306_widget_t value_slots[5];
+static const char* menu_labels[BENCH_MENU_ROWS] = {" Menu 1", " Menu 2", " Menu 3", " Menu 4", " Menu 5"};
+static volatile uint32_t bench_sink;
+static uint8_t bench_skip;		/* Set by a setup that cannot run with this build */
+
+void HAL_I2C_MasterTxCpltCallback(I2C_HandleTypeDef *hi2c)
+{
+	SSD1306_TxCpltCallback(&bench_oled, hi2c);
+}
+
+void HAL_I2C_MemTxCpltCallback(I2C_HandleTypeDef *hi2c)
+{
+	SSD1306_TxCpltCallback(&bench_oled, hi2c);
+}
+
+void HAL_I2C_ErrorCallback(I2C_HandleTypeDef *hi2c)
+{
+	SSD1306_ErrorCallback(&bench_oled, hi2c);
+}
+
+
+/**	--- Scenarios of the menu firmware --- **/
+
+
+/* Same layout as main.c of the menu firmware */
+static void menu_Declare(ssd1306_t* ssd1306)
+{
+	uint8_t row;
+
+	for (row = 0; row < BENCH_MENU_ROWS; row++) {
+		FontDef_t* font = (row < 3) ? &Font_11x18 : &Font_7x10;
+		uint16_t x = (row == 4) ? SSD1306_WIDTH/2 : 2;
+		uint16_t y = (row < 3) ? row*Font_11x18.FontHeight : 3*Font_11x18.FontHeight-1;
+
+		SSD1306_Widget(&menu_cursor[row], x, y, font, 1);
+		SSD1306_Widget(&menu_rows[row], x + font->FontWidth, y, font, 7);
+		SSD1306_WidgetSetText(ssd1306, &menu_cursor[row], " ");
+		SSD1306_WidgetSetText(ssd1306, &menu_rows[row], menu_labels[row]);
+	}
+}
+
+static void menu_Cursor(ssd1306_t* ssd1306, int16_t position)
+{
+	uint8_t row;
+
+	for (row = 0; row < BENCH_MENU_ROWS; row++) {
+		SSD1306_WidgetSetText(ssd1306, &menu_cursor[row], (row == position) ? ">" : " ");
+	}
+}
+
+static void draw_MenuFull(ssd1306_t* ssd1306, uint32_t frame)
+{
+	(void)frame;
+	SSD1306_Fill(ssd1306, SSD1306_COLOR_BLACK);
+	menu_Declare(ssd1306);
+}
+
+static void setup_Menu(ssd1306_t* ssd1306)
+{
+	menu_Declare(ssd1306);
+	menu_Cursor(ssd1306, 0);
+	SSD1306_UpdateScreen(ssd1306);
+}
+
+static void draw_MenuIdle(ssd1306_t* ssd1306, uint32_t frame)
+{
+	(void)frame;
+	menu_Cursor(ssd1306, 0);
+}
+
+static void draw_CursorWidgets(ssd1306_t* ssd1306, uint32_t frame)
+{
+	menu_Cursor(ssd1306, frame % BENCH_MENU_ROWS);
+}
+
+/* Per-frame cursor redraw of the firmware before the widgets */
+static void draw_CursorLegacy(ssd1306_t* ssd1306, uint32_t frame)
+{
+	SSD1306_SetCursor(ssd1306, frame % BENCH_MENU_ROWS);
+}
+
+static void draw_SlotsPutint(ssd1306_t* ssd1306, uint32_t frame)
+{
+	uint8_t slot;
+
+	for (slot = 1; slot <= 5; slot++) {
+		SSD1306_Putint(ssd1306, (frame / 10) * 37 + slot, "mV", slot);
+	}
+}
+
+static void setup_Slots(ssd1306_t* ssd1306)
+{
+	uint8_t slot;
+
+	(void)ssd1306;
+	for (slot = 1; slot <= 5; slot++) {
+		SSD1306_WidgetSlot(&value_slots[slot - 1], slot);
+	}
+}
+
+/* Values change every 10 frames, as a 10 Hz display of a 1 Hz measurement */
+static void draw_SlotsWidgets(ssd1306_t* ssd1306, uint32_t frame)
+{
+	uint8_t slot;
+
+	for (slot = 1; slot <= 5; slot++) {
+		SSD1306_WidgetSetInt(ssd1306, &value_slots[slot - 1], (frame / 10) * 37 + slot, "mV");
+	}
+}
+
+static void draw_Full(ssd1306_t* ssd1306, uint32_t frame)
+{
+	SSD1306_Fill(ssd1306, (frame & 1) ? SSD1306_COLOR_WHITE : SSD1306_COLOR_BLACK);
+}
+
+/* Horizontal mode needs the buffer as wide as the GRAM, build/oled_bench_128 runs it */
+static void setup_Horizontal(ssd1306_t* ssd1306)
+{
+	if (!SSD1306_SetAddressingMode(ssd1306, SSD1306_ADDRESSING_HORIZONTAL)) {
+		bench_skip = 1;
+	}
+}
+
+static const bench_scenario_t bench_scenarios[] = {
+	{"menu_full",       NULL,             draw_MenuFull,      50,  0},
+	{"menu_idle",       setup_Menu,       draw_MenuIdle,      100, 0},
+	{"cursor_widgets",  setup_Menu,       draw_CursorWidgets, 100, 0},
+	{"cursor_legacy",   setup_Menu,       draw_CursorLegacy,  100, 0},
+	{"slots_putint",    NULL,             draw_SlotsPutint,   100, 0},
+	{"slots_widgets",   setup_Slots,      draw_SlotsWidgets,  100, 0},
+	{"full_page",       NULL,             draw_Full,          50,  0},
+	{"full_horizontal", setup_Horizontal, draw_Full,          50,  0},
+	{"full_async",      NULL,             draw_Full,          50,  1},
+	{"cursor_async",    setup_Menu,       draw_CursorWidgets, 100, 1},
+};
+
+static void bench_Init(uint8_t dma)
+{
+	bench_i2c.hdmatx = dma ? &bench_dma : NULL;
+	sim_Reset(BENCH_ADDR, BENCH_GRAM);
+	memset(&bench_oled, 0, sizeof(bench_oled));
+	SSD1306_Init(&bench_oled, &bench_i2c, BENCH_ADDR);
+}
+
+static void bench_Flush(ssd1306_t* ssd1306, uint8_t async)
+{
+	if (!async) {
+		SSD1306_UpdateScreen(ssd1306);
+		return;
+	}
+	if (SSD1306_UpdateScreenAsync(ssd1306)) {
+		while (sim_Complete()) {
+		}
+	}
+}
+
+static void bench_Scenario(const bench_scenario_t* s, const char* dir)
+{
+	uint64_t draw_ns = 0;
+	uint64_t flush_ns = 0;
+	uint64_t t0;
+	uint32_t frame;
+	uint32_t diff;
+	char path[256];
+
+	bench_Init(s->async);
+	bench_skip = 0;
+	if (s->setup != NULL) {
+		s->setup(&bench_oled);
+	}
+	if (bench_skip) {
+		printf("%-16s skipped, not supported with SSD1306_WIDTH %d\n", s->name, SSD1306_WIDTH);
+		return;
+	}
+	sim_ResetStats();
+
+	for (frame = 0; frame < s->frames; frame++) {
+		t0 = sim_Nanoseconds();
+		s->draw(&bench_oled, frame);
+		draw_ns += sim_Nanoseconds() - t0;
+
+		t0 = sim_Nanoseconds();
+		bench_Flush(&bench_oled, s->async);
+		flush_ns += sim_Nanoseconds() - t0;
+	}
+
+	diff = sim_Compare(bench_oled.SSD1306_Buffer, SSD1306_WIDTH, bench_oled.ColumnOffset);
+	printf("%-16s %6u %9.1f %9.1f %9.0f %9.0f %6u %s\n", s->name, s->frames,
+			(double)sim_stats.wire_bytes / s->frames, (double)sim_stats.transactions / s->frames,
+			(double)draw_ns / s->frames, (double)flush_ns / s->frames,
+			sim_stats.wrapped, diff ? "GRAM MISMATCH" : "ok");
+
+	snprintf(path, sizeof(path), "%s/%s.pbm", dir, s->name);
+	sim_DumpPBM(path, bench_oled.ColumnOffset, BENCH_GRAM);
+}
+
+
+/**	--- Micro benchmarks --- **/
+
+
+static double bench_PutcRate(FontDef_t* font)
+{
+	uint64_t t0 = sim_Nanoseconds();
+	uint32_t n = 0;
+	uint32_t r;
+	uint8_t c;
+
+	for (r = 0; r < 20000; r++) {
+		SSD1306_GotoXY(&bench_oled, 0, r % 8);
+		for (c = 0; c < 5; c++) {
+			SSD1306_Putc(&bench_oled, '0' + c, font, SSD1306_COLOR_WHITE);
+			n++;
+		}
+	}
+	return n / ((sim_Nanoseconds() - t0) * 1e-9);
+}
+
+static void bench_Putc(void)
+{
+	FontDef_t* fonts[] = {&Font_7x10, &Font_11x18, &Font_16x26};
+	FontDef_t pixel;
+	uint8_t i;
+
+	bench_Init(0);
+	printf("\nSSD1306_Putc, characters per second\n");
+	printf("%-8s %12s %12s\n", "font", "per-pixel", "columns");
+	for (i = 0; i < sizeof(fonts) / sizeof(fonts[0]); i++) {
+		/* Without the column table Putc falls back to the per-pixel path */
+		pixel = *fonts[i];
+		pixel.columns = NULL;
+		printf("%2ux%-5u %12.0f %12.0f\n", fonts[i]->FontWidth, fonts[i]->FontHeight,
+				bench_PutcRate(&pixel), bench_PutcRate(fonts[i]));
+	}
+}
+
+static void bench_Format(void)
+{
+	const uint32_t n = 200000;
+	char str[SSD1306_NUMBER_LENGTH];
+	uint64_t t[5];
+	uint32_t i;
+
+	t[0] = sim_Nanoseconds();
+	for (i = 0; i < n; i++) {
+		bench_sink += legacy_int_str(i * 37 % 999999, "mV")[1];
+	}
+	t[1] = sim_Nanoseconds();
+	for (i = 0; i < n; i++) {
+		bench_sink += int_str(str, i * 37 % 999999, "mV")[1];
+	}
+	t[2] = sim_Nanoseconds();
+	for (i = 0; i < n; i++) {
+		bench_sink += legacy_double_str((i % 9999) * 0.37, 2, " V")[1];
+	}
+	t[3] = sim_Nanoseconds();
+	for (i = 0; i < n; i++) {
+		bench_sink += double_str(str, (i % 9999) * 0.37, 2, " V")[1];
+	}
+	t[4] = sim_Nanoseconds();
+
+	printf("\nNumber formatting, ns per call\n");
+	printf("%-12s %10s %10s\n", "", "legacy", "current");
+	printf("%-12s %10.1f %10.1f\n", "int_str", (double)(t[1] - t[0]) / n, (double)(t[2] - t[1]) / n);
+	printf("%-12s %10.1f %10.1f\n", "double_str", (double)(t[3] - t[2]) / n, (double)(t[4] - t[3]) / n);
+}
+
+int main(int argc, char** argv)
+{
+	const char* dir = (argc > 1) ? argv[1] : ".";
+	char path[256];
+	uint8_t i;
+
+	bench_Init(0);
+	printf("Init: %u transactions, %u bytes, probe/commands/clear %u/%u/%u us\n",
+			sim_stats.transactions, sim_stats.wire_bytes,
+			bench_oled.InitTime[SSD1306_INIT_PROBE], bench_oled.InitTime[SSD1306_INIT_COMMANDS], bench_oled.InitTime[SSD1306_INIT_CLEAR]);
+	snprintf(path, sizeof(path), "%s/init.pbm", dir);
+	sim_DumpPBM(path, bench_oled.ColumnOffset, BENCH_GRAM);
+
+	printf("\nPer frame averages, SSD1306_WIDTH %d (full frame: %d bytes of GRAM)\n", SSD1306_WIDTH, SSD1306_FRAME_BYTES);
+	printf("%-16s %6s %9s %9s %9s %9s %6s %s\n", "scenario", "frames", "bytes", "transact", "draw ns", "flush ns", "wraps", "GRAM");
+	for (i = 0; i < sizeof(bench_scenarios) / sizeof(bench_scenarios[0]); i++) {
+		bench_Scenario(&bench_scenarios[i], dir);
+	}
+
+	bench_Putc();
+	bench_Format();
+	return 0;
+}
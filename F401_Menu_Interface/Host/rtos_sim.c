@@ -0,0 +1,106 @@
+#include "rtos_sim.h"
+#include "hd44780_sim.h"
+
+static uint8_t rtos_Thread;			/* Its address is the id of the only thread */
+static uint32_t rtos_Flags;
+static void (*rtos_Idle)(void);
+
+void rtos_sim_Idle(void (*idle)(void))
+{
+	rtos_Idle = idle;
+}
+
+/* Lets the other threads run, then the time pass until the next tick */
+static void rtos_Yield(void)
+{
+	uint64_t next = (lcd_sim_Nanoseconds() / 1000000 + 1) * 1000000;
+
+	if (rtos_Idle != NULL) {
+		rtos_Idle();
+	}
+	lcd_sim_AdvanceTo(next);
+}
+
+uint32_t osKernelGetTickCount(void)
+{
+	return HAL_GetTick();
+}
+
+uint32_t osKernelGetTickFreq(void)
+{
+	return 1000;
+}
+
+osKernelState_t osKernelGetState(void)
+{
+	return osKernelRunning;
+}
+
+int32_t osKernelLock(void)
+{
+	return 0;
+}
+
+int32_t osKernelRestoreLock(int32_t lock)
+{
+	return lock;
+}
+
+osThreadId_t osThreadGetId(void)
+{
+	return &rtos_Thread;
+}
+
+uint32_t osThreadFlagsSet(osThreadId_t thread_id, uint32_t flags)
+{
+	if (thread_id != &rtos_Thread) {
+		return osFlagsErrorResource;
+	}
+	rtos_Flags |= flags;
+	return rtos_Flags;
+}
+
+uint32_t osThreadFlagsClear(uint32_t flags)
+{
+	uint32_t previous = rtos_Flags;
+
+	rtos_Flags &= ~flags;
+	return previous;
+}
+
+uint32_t osThreadFlagsWait(uint32_t flags, uint32_t options, uint32_t timeout)
+{
+	uint32_t start = osKernelGetTickCount();
+	uint32_t set;
+
+	for (;;) {
+		set = rtos_Flags;
+		if ((options & osFlagsWaitAll) ? (set & flags) == flags : (set & flags) != 0) {
+			if (!(options & osFlagsNoClear)) {
+				rtos_Flags &= ~flags;
+			}
+			return set;
+		}
+		if (timeout == 0 || (timeout == osWaitForever && rtos_Idle == NULL)) {
+			// nothing else could ever set the flags
+			return osFlagsErrorResource;
+		}
+		if (timeout != osWaitForever && osKernelGetTickCount() - start >= timeout) {
+			return osFlagsErrorTimeout;
+		}
+		rtos_Yield();
+	}
+}
+
+osStatus_t osDelayUntil(uint32_t ticks)
+{
+	while ((int32_t)(ticks - osKernelGetTickCount()) > 0) {
+		rtos_Yield();
+	}
+	return osOK;
+}
+
+osStatus_t osDelay(uint32_t ticks)
+{
+	return osDelayUntil(osKernelGetTickCount() + ticks);
+}
@@ -0,0 +1,18 @@
+#ifndef RTOS_SIM_H
+#define RTOS_SIM_H
+
+/*
+ *  Single thread stand-in for the CMSIS-RTOS2 kernel. The waits of the only
+ *  thread run the idle hook, which stands for the other threads of the
+ *  firmware, then move the simulated time to the next tick.
+ */
+
+#include "cmsis_os.h"
+
+/**
+ * @brief  Sets the function run whenever the thread waits, NULL for none
+ * @note   The hook runs the other threads until they would wait themselves
+ */
+void rtos_sim_Idle(void (*idle)(void));
+
+#endif
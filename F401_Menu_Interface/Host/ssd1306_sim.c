@@ -0,0 +1,371 @@
+#include "ssd1306_sim.h"
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+sim_stats_t sim_stats;
+uint32_t SystemCoreClock = 84000000;
+CoreDebug_Type sim_CoreDebug;
+
+static DWT_Type sim_Dwt;
+static uint64_t sim_Epoch;
+static uint64_t sim_DelayOffset;	/* HAL_Delay() advances the time instead of sleeping */
+
+/* State of the simulated controller */
+static struct {
+	uint16_t addr;
+	uint16_t columns;
+	uint8_t gram[SIM_GRAM_PAGES][SIM_GRAM_COLUMNS];
+	uint8_t mode;					/* 0x20 argument: 0 horizontal, 1 vertical, 2 page */
+	uint16_t column;
+	uint16_t col_start;
+	uint16_t col_end;
+	uint8_t page;
+	uint8_t page_start;
+	uint8_t page_end;
+	uint8_t cmd[8];					/* Command being received with its arguments */
+	uint8_t cmd_len;
+	uint8_t cmd_args;
+	uint8_t display_on;
+	uint8_t scrolling;
+	uint32_t fail_after;
+	I2C_HandleTypeDef* pending;		/* IT/DMA transfer waiting for sim_Complete() */
+	uint8_t pending_mem;
+} sim;
+
+uint64_t sim_Nanoseconds(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec + sim_DelayOffset;
+}
+
+DWT_Type* sim_DWT(void)
+{
+	sim_Dwt.CYCCNT = (uint32_t)((sim_Nanoseconds() - sim_Epoch) * (SystemCoreClock / 1000000) / 1000);
+	return &sim_Dwt;
+}
+
+uint32_t HAL_GetTick(void)
+{
+	return (uint32_t)((sim_Nanoseconds() - sim_Epoch) / 1000000);
+}
+
+void HAL_Delay(uint32_t Delay)
+{
+	sim_DelayOffset += (uint64_t)Delay * 1000000;
+}
+
+/* Number of argument bytes following a command */
+static uint8_t sim_Args(uint8_t cmd)
+{
+	switch (cmd) {
+	case 0x20: case 0x81: case 0x8D: case 0xA8: case 0xAD: case 0xD3:
+	case 0xD5: case 0xD6: case 0xD9: case 0xDA: case 0xDB:
+		return 1;
+	case 0x21: case 0x22: case 0xA3:
+		return 2;
+	case 0x29: case 0x2A:
+		return 5;
+	case 0x26: case 0x27:
+		return 6;
+	default:
+		return 0;
+	}
+}
+
+static void sim_Execute(void)
+{
+	uint8_t cmd = sim.cmd[0];
+
+	if (cmd <= 0x0F) {
+		sim.column = (sim.column & 0xF0) | cmd;
+	} else if (cmd <= 0x1F) {
+		sim.column = (sim.column & 0x0F) | ((cmd & 0x0F) << 4);
+	} else if (cmd >= 0xB0 && cmd <= 0xB7) {
+		sim.page = cmd & 0x07;
+	} else {
+		switch (cmd) {
+		case 0x20:
+			sim.mode = sim.cmd[1] & 0x03;
+			break;
+		case 0x21:
+			sim.col_start = sim.cmd[1] & 0x7F;
+			sim.col_end = sim.cmd[2] & 0x7F;
+			sim.column = sim.col_start;
+			break;
+		case 0x22:
+			sim.page_start = sim.cmd[1] & 0x07;
+			sim.page_end = sim.cmd[2] & 0x07;
+			sim.page = sim.page_start;
+			break;
+		case 0x2E:
+			sim.scrolling = 0;
+			break;
+		case 0x2F:
+			sim.scrolling = 1;
+			break;
+		case 0xAE:
+			sim.display_on = 0;
+			break;
+		case 0xAF:
+			sim.display_on = 1;
+			break;
+		}
+	}
+	sim.cmd_len = 0;
+}
+
+static void sim_Command(uint8_t b)
+{
+	sim_stats.command_bytes++;
+	if (sim.cmd_len == 0) {
+		sim.cmd_args = sim_Args(b);
+	}
+	sim.cmd[sim.cmd_len++] = b;
+	if (sim.cmd_len > sim.cmd_args) {
+		sim_Execute();
+	}
+}
+
+static void sim_Data(uint8_t b)
+{
+	sim_stats.data_bytes++;
+	if (sim.column < sim.columns && sim.page < SIM_GRAM_PAGES) {
+		sim.gram[sim.page][sim.column] = b;
+	}
+
+	switch (sim.mode) {
+	case 0:
+		if (++sim.column > sim.col_end) {
+			sim.column = sim.col_start;
+			if (++sim.page > sim.page_end) {
+				sim.page = sim.page_start;
+				sim_stats.wrapped++;
+			}
+		}
+		break;
+	case 1:
+		if (++sim.page > sim.page_end) {
+			sim.page = sim.page_start;
+			if (++sim.column > sim.col_end) {
+				sim.column = sim.col_start;
+				sim_stats.wrapped++;
+			}
+		}
+		break;
+	default:
+		/* Page mode wraps in the same page */
+		if (++sim.column >= sim.columns) {
+			sim.column = 0;
+			sim_stats.wrapped++;
+		}
+		break;
+	}
+}
+
+/* Decodes a transaction: control bytes followed by commands or GRAM data */
+static void sim_Stream(const uint8_t* bytes, uint16_t size)
+{
+	uint16_t i = 0;
+	uint8_t control;
+
+	while (i < size) {
+		control = bytes[i++];
+		if (control & 0x80) {
+			/* Continuation bit: a single byte, then another control byte */
+			if (i < size) {
+				(control & 0x40) ? sim_Data(bytes[i]) : sim_Command(bytes[i]);
+				i++;
+			}
+			continue;
+		}
+		while (i < size) {
+			(control & 0x40) ? sim_Data(bytes[i]) : sim_Command(bytes[i]);
+			i++;
+		}
+	}
+}
+
+/* Accounts and decodes a write, mem is the control byte or 0xFFFF */
+static HAL_StatusTypeDef sim_Write(uint16_t addr, uint16_t mem, uint8_t* data, uint16_t size)
+{
+	sim_stats.transactions++;
+	if (sim.fail_after != 0 && sim_stats.transactions >= sim.fail_after) {
+		sim_stats.errors++;
+		return HAL_ERROR;
+	}
+	if (addr != sim.addr) {
+		sim_stats.wire_bytes++;
+		sim_stats.errors++;
+		return HAL_ERROR;
+	}
+	sim_stats.wire_bytes += 1 + size;
+	if (mem == 0xFFFF) {
+		sim_Stream(data, size);
+		return HAL_OK;
+	}
+
+	sim_stats.wire_bytes++;
+	if (mem & 0x80) {
+		/* A single byte after the control byte, the rest carries its own control bytes */
+		if (size > 0) {
+			(mem & 0x40) ? sim_Data(data[0]) : sim_Command(data[0]);
+			sim_Stream(&data[1], size - 1);
+		}
+	} else {
+		while (size--) {
+			(mem & 0x40) ? sim_Data(*data) : sim_Command(*data);
+			data++;
+		}
+	}
+	return HAL_OK;
+}
+
+static HAL_StatusTypeDef sim_Start(I2C_HandleTypeDef *hi2c, uint16_t addr, uint16_t mem, uint8_t* data, uint16_t size)
+{
+	HAL_StatusTypeDef status;
+
+	if (sim.pending != NULL) {
+		sim_stats.errors++;
+		return HAL_BUSY;
+	}
+	status = sim_Write(addr, mem, data, size);
+	if (status == HAL_OK) {
+		sim_stats.async++;
+		sim.pending = hi2c;
+		sim.pending_mem = (mem != 0xFFFF);
+	}
+	return status;
+}
+
+void sim_Reset(uint16_t addr, uint16_t columns)
+{
+	memset(&sim, 0, sizeof(sim));
+	sim.addr = addr;
+	sim.columns = (columns < SIM_GRAM_COLUMNS) ? columns : SIM_GRAM_COLUMNS;
+	sim.mode = 2;
+	sim.col_end = 127;
+	sim.page_end = SIM_GRAM_PAGES - 1;
+	/* Power-on RAM content is undefined */
+	memset(sim.gram, 0xA5, sizeof(sim.gram));
+	if (sim_Epoch == 0) {
+		sim_Epoch = sim_Nanoseconds();
+	}
+	sim_ResetStats();
+}
+
+void sim_ResetStats(void)
+{
+	memset(&sim_stats, 0, sizeof(sim_stats));
+}
+
+void sim_FailAfter(uint32_t transactions)
+{
+	sim.fail_after = transactions;
+}
+
+uint8_t sim_Complete(void)
+{
+	I2C_HandleTypeDef* hi2c = sim.pending;
+
+	if (hi2c == NULL) {
+		return 0;
+	}
+	sim.pending = NULL;
+	if (sim.pending_mem) {
+		HAL_I2C_MemTxCpltCallback(hi2c);
+	} else {
+		HAL_I2C_MasterTxCpltCallback(hi2c);
+	}
+	return 1;
+}
+
+uint8_t sim_Gram(uint8_t page, uint16_t column)
+{
+	return sim.gram[page % SIM_GRAM_PAGES][column % SIM_GRAM_COLUMNS];
+}
+
+uint32_t sim_Compare(const uint8_t* buffer, uint16_t width, uint16_t offset)
+{
+	uint32_t diff = 0;
+	uint16_t x;
+	uint8_t page;
+
+	for (page = 0; page < SIM_GRAM_PAGES; page++) {
+		for (x = 0; x < width && x + offset < sim.columns; x++) {
+			if (buffer[page * width + x] != sim.gram[page][x + offset]) {
+				diff++;
+			}
+		}
+	}
+	return diff;
+}
+
+uint8_t sim_DumpPBM(const char* path, uint16_t offset, uint16_t width)
+{
+	FILE* f = fopen(path, "w");
+	uint16_t x;
+	uint8_t y;
+
+	if (f == NULL) {
+		return 0;
+	}
+	fprintf(f, "P1\n# %s\n%u %u\n", sim.display_on ? "display on" : "display off", width, SIM_GRAM_PAGES * 8);
+	for (y = 0; y < SIM_GRAM_PAGES * 8; y++) {
+		for (x = 0; x < width; x++) {
+			fputc((sim_Gram(y / 8, x + offset) >> (y % 8)) & 1 ? '1' : '0', f);
+			fputc(x + 1 < width ? ' ' : '\n', f);
+		}
+	}
+	fclose(f);
+	return 1;
+}
+
+HAL_StatusTypeDef HAL_I2C_IsDeviceReady(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint32_t Trials, uint32_t Timeout)
+{
+	(void)hi2c;
+	(void)Trials;
+	(void)Timeout;
+	sim_stats.transactions++;
+	sim_stats.wire_bytes++;
+	return (DevAddress == sim.addr) ? HAL_OK : HAL_ERROR;
+}
+
+HAL_StatusTypeDef HAL_I2C_Master_Transmit(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint8_t *pData, uint16_t Size, uint32_t Timeout)
+{
+	(void)hi2c;
+	(void)Timeout;
+	return sim_Write(DevAddress, 0xFFFF, pData, Size);
+}
+
+HAL_StatusTypeDef HAL_I2C_Master_Transmit_IT(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint8_t *pData, uint16_t Size)
+{
+	return sim_Start(hi2c, DevAddress, 0xFFFF, pData, Size);
+}
+
+HAL_StatusTypeDef HAL_I2C_Master_Transmit_DMA(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint8_t *pData, uint16_t Size)
+{
+	return sim_Start(hi2c, DevAddress, 0xFFFF, pData, Size);
+}
+
+HAL_StatusTypeDef HAL_I2C_Mem_Write(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint16_t MemAddress, uint16_t MemAddSize, uint8_t *pData, uint16_t Size, uint32_t Timeout)
+{
+	(void)hi2c;
+	(void)MemAddSize;
+	(void)Timeout;
+	return sim_Write(DevAddress, MemAddress & 0xFF, pData, Size);
+}
+
+HAL_StatusTypeDef HAL_I2C_Mem_Write_IT(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint16_t MemAddress, uint16_t MemAddSize, uint8_t *pData, uint16_t Size)
+{
+	(void)MemAddSize;
+	return sim_Start(hi2c, DevAddress, MemAddress & 0xFF, pData, Size);
+}
+
+HAL_StatusTypeDef HAL_I2C_Mem_Write_DMA(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint16_t MemAddress, uint16_t MemAddSize, uint8_t *pData, uint16_t Size)
+{
+	(void)MemAddSize;
+	return sim_Start(hi2c, DevAddress, MemAddress & 0xFF, pData, Size);
+}
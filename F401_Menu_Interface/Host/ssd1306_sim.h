@@ -0,0 +1,81 @@
+#ifndef SSD1306_SIM_H
+#define SSD1306_SIM_H
+
+/*
+ *  Host simulator of an SSD1306/SH1106 on I2C. Every HAL write is recorded,
+ *  counted as it would go on the wire and decoded into a virtual GRAM.
+ */
+
+#include "main.h"
+
+#define SIM_GRAM_COLUMNS	132		/* SH1106 RAM, the SSD1306 uses the first 128 */
+#define SIM_GRAM_PAGES		8
+
+/**
+ * @brief  Bus statistics, cleared by @ref sim_ResetStats()
+ */
+typedef struct {
+	uint32_t transactions;	/*!< I2C transactions (start to stop) */
+	uint32_t wire_bytes;	/*!< Bytes on the wire: address, control bytes and payload */
+	uint32_t command_bytes;	/*!< Command bytes decoded */
+	uint32_t data_bytes;	/*!< GRAM bytes written */
+	uint32_t wrapped;		/*!< Data bytes that made the column pointer wrap */
+	uint32_t async;			/*!< Transactions started with IT or DMA */
+	uint32_t errors;		/*!< Writes rejected (wrong address, bus busy, failure injected) */
+} sim_stats_t;
+
+extern sim_stats_t sim_stats;
+
+/**
+ * @brief  Powers the simulated controller on
+ * @param  addr: 8-bit I2C address the controller answers to
+ * @param  columns: GRAM columns, 128 for the SSD1306 and 132 for the SH1106
+ * @retval None
+ */
+void sim_Reset(uint16_t addr, uint16_t columns);
+
+/**
+ * @brief  Clears the statistics
+ */
+void sim_ResetStats(void);
+
+/**
+ * @brief  Makes the next writes fail from the given one on, 0 to disable
+ */
+void sim_FailAfter(uint32_t transactions);
+
+/**
+ * @brief  Completes the pending IT/DMA transfer, calling the HAL callbacks
+ * @retval 1 if a transfer was completed, 0 if none was pending
+ */
+uint8_t sim_Complete(void);
+
+/**
+ * @brief  Byte of the virtual GRAM
+ */
+uint8_t sim_Gram(uint8_t page, uint16_t column);
+
+/**
+ * @brief  Counts the GRAM bytes that differ from a driver buffer
+ * @param  buffer: page-major buffer, width bytes per page
+ * @param  width: bytes per page of the buffer
+ * @param  offset: GRAM column of the first buffer column
+ * @retval Bytes that differ over the visible columns
+ */
+uint32_t sim_Compare(const uint8_t* buffer, uint16_t width, uint16_t offset);
+
+/**
+ * @brief  Writes the visible GRAM as a PBM image
+ * @param  path: file to be written
+ * @param  offset: GRAM column shown at the left
+ * @param  width: columns shown
+ * @retval 1 on success, 0 otherwise
+ */
+uint8_t sim_DumpPBM(const char* path, uint16_t offset, uint16_t width);
+
+/**
+ * @brief  Host time in nanoseconds
+ */
+uint64_t sim_Nanoseconds(void);
+
+#endif
@@ -0,0 +1,49 @@
+/*
+ *  Host stand-in for the CMSIS-RTOS2 API: a single thread whose waits advance
+ *  the simulated time (rtos_sim.c). The kernel tick is 1 kHz, as in the firmware.
+ */
+#ifndef CMSIS_OS_H_
+#define CMSIS_OS_H_
+
+#include <stdint.h>
+#include <stddef.h>
+
+typedef void* osThreadId_t;
+
+typedef enum {
+	osOK             =  0,
+	osError          = -1,
+	osErrorTimeout   = -2,
+	osErrorResource  = -3,
+	osErrorParameter = -4
+} osStatus_t;
+
+typedef enum {
+	osKernelInactive = 0,
+	osKernelReady    = 1,
+	osKernelRunning  = 2,
+	osKernelLocked   = 3
+} osKernelState_t;
+
+#define osWaitForever			0xFFFFFFFFU
+#define osFlagsWaitAny			0x00000000U
+#define osFlagsWaitAll			0x00000001U
+#define osFlagsNoClear			0x00000002U
+#define osFlagsError			0x80000000U
+#define osFlagsErrorTimeout		0xFFFFFFFEU
+#define osFlagsErrorResource	0xFFFFFFFDU
+
+uint32_t osKernelGetTickCount(void);
+uint32_t osKernelGetTickFreq(void);
+osKernelState_t osKernelGetState(void);
+int32_t osKernelLock(void);
+int32_t osKernelRestoreLock(int32_t lock);
+
+osThreadId_t osThreadGetId(void);
+uint32_t osThreadFlagsSet(osThreadId_t thread_id, uint32_t flags);
+uint32_t osThreadFlagsClear(uint32_t flags);
+uint32_t osThreadFlagsWait(uint32_t flags, uint32_t options, uint32_t timeout);
+osStatus_t osDelay(uint32_t ticks);
+osStatus_t osDelayUntil(uint32_t ticks);
+
+#endif /* CMSIS_OS_H_ */